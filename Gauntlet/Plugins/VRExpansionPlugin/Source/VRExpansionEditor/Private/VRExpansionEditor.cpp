@@ -0,0 +1,13 @@
+// Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
+
+#include "VRExpansionEditor.h"
+
+void FVRExpansionEditorModule::StartupModule()
+{
+}
+
+void FVRExpansionEditorModule::ShutdownModule()
+{
+}
+
+IMPLEMENT_MODULE(FVRExpansionEditorModule, VRExpansionEditor)
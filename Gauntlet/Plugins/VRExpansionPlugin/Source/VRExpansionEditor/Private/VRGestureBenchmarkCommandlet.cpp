@@ -0,0 +1,459 @@
+#include "VRGestureBenchmarkCommandlet.h"
+#include "VRGestureComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVRGestureBenchmark, Log, All);
+
+namespace VRGestureBenchmark
+{
+	// Accepts both package paths and full object paths
+	UGesturesDatabase * LoadDatabase(const FString & Path)
+	{
+		FString ObjectPath = Path;
+		if (!ObjectPath.Contains(TEXT(".")))
+		{
+			ObjectPath += TEXT(".") + FPackageName::GetShortName(Path);
+		}
+
+		return LoadObject<UGesturesDatabase>(nullptr, *ObjectPath);
+	}
+
+	// Costs further apart than this (relative) count as a mismatch in the comparisons
+	const float CostTolerance = 1.0e-3f;
+}
+
+UVRGestureBenchmarkCommandlet::UVRGestureBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+
+	LastDetectedIndex = INDEX_NONE;
+	bCompareStreaming = false;
+	bCompareVectorized = false;
+}
+
+void UVRGestureBenchmarkCommandlet::OnGestureDetected(uint8 GestureType, FString DetectedGestureName, int DetectedGestureIndex, UGesturesDatabase * GestureDataBase)
+{
+	LastDetectedIndex = DetectedGestureIndex;
+}
+
+void UVRGestureBenchmarkCommandlet::CompareStreamingCosts(UVRGestureComponent * GestureComponent, FCostComparison & InOutComparison)
+{
+	UGesturesDatabase * GesturesDB = GestureComponent->GesturesDB;
+
+	if (GestureComponent->StreamingStatesDB != GesturesDB || GestureComponent->StreamingStatesGestureCount != GesturesDB->Gestures.Num())
+		return;
+
+	GesturesDB->UpdateGestureCache();
+
+	// The streaming states are fed the raw samples, so they are compared against the raw window
+	const FVRGestureView Input = GestureComponent->SampleWindow.GetView();
+	const float Scaler = GestureComponent->GetDatabaseScaler(Input.GestureSize);
+
+	for (const FVRGestureStreamingState & State : GestureComponent->StreamingStates)
+	{
+		const TArrayView<const FVector> GestureSamples = GesturesDB->GetGestureSamples(State.GestureIndex, State.bMirrorGesture);
+
+		if (GestureSamples.Num() < 1 || State.LastMatchCost >= MAX_FLT)
+			continue;
+
+		const float ReferenceCost = GestureComponent->dtw(Input, GestureSamples, GesturesDB->Gestures[State.GestureIndex].GestureSettings.bEnableScaling ? Scaler : 1.f);
+
+		if (ReferenceCost >= MAX_FLT)
+			continue;
+
+		InOutComparison.Add(ReferenceCost / GestureSamples.Num(), State.LastMatchCost / GestureSamples.Num(), VRGestureBenchmark::CostTolerance);
+	}
+}
+
+void UVRGestureBenchmarkCommandlet::CompareVectorized(UVRGestureComponent * GestureComponent, FCorpusRun & InOutRun)
+{
+	UGesturesDatabase * GesturesDB = GestureComponent->GesturesDB;
+
+	GesturesDB->UpdateGestureCache();
+
+	// Same input that RunGestureDetection is about to score
+	FVRGestureView Input = GestureComponent->SampleWindow.GetView();
+
+	if (GesturesDB->ShouldProcessSamples())
+	{
+		GestureComponent->GetDetectionSamples(GestureComponent->ProcessedGestureLog);
+		Input = FVRGestureView(GestureComponent->ProcessedGestureLog);
+	}
+
+	const float Scaler = GestureComponent->GetDatabaseScaler(Input.GestureSize);
+	const float * PackedData = GesturesDB->GetSIMDSampleData();
+
+	float LaneScalers[VRGESTURE_SIMD_LANES];
+	float LaneYSigns[VRGESTURE_SIMD_LANES];
+	float LaneCosts[VRGESTURE_SIMD_LANES];
+	TArray<FVector> MirroredSamples;
+
+	for (const FVRGestureSIMDBatch & Batch : GesturesDB->GetSIMDBatches())
+	{
+		for (int32 MirrorIndex = 0; MirrorIndex < 2; ++MirrorIndex)
+		{
+			for (int32 Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+			{
+				const int32 GestureIndex = Batch.GestureIndices[Lane];
+				LaneScalers[Lane] = GestureIndex != INDEX_NONE && GesturesDB->Gestures[GestureIndex].GestureSettings.bEnableScaling ? Scaler : 1.f;
+				LaneYSigns[Lane] = MirrorIndex > 0 ? -1.f : 1.f;
+			}
+
+			GestureComponent->dtwBatch(Input, Batch, PackedData, LaneScalers, LaneYSigns, LaneCosts);
+
+			for (int32 Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+			{
+				const int32 GestureIndex = Batch.GestureIndices[Lane];
+
+				if (GestureIndex == INDEX_NONE)
+					continue;
+
+				TArrayView<const FVector> GestureSamples = GesturesDB->GetGestureSamples(GestureIndex, false);
+
+				if (GestureSamples.Num() < 1)
+					continue;
+
+				// The database only keeps mirrored copies of gestures that mirror, the kernel can mirror any of them
+				if (MirrorIndex > 0)
+				{
+					MirroredSamples.Reset();
+
+					for (const FVector & Sample : GestureSamples)
+					{
+						MirroredSamples.Emplace(Sample.X, -Sample.Y, Sample.Z);
+					}
+
+					GestureSamples = MirroredSamples;
+				}
+
+				const float ReferenceCost = GestureComponent->dtw(Input, GestureSamples, LaneScalers[Lane]);
+				InOutRun.VectorizedCosts.Add(ReferenceCost / GestureSamples.Num(), LaneCosts[Lane] / GestureSamples.Num(), VRGestureBenchmark::CostTolerance);
+			}
+		}
+	}
+
+	// The scalar search scores quantized gestures with dtwQuantized(), the vectorized one never does
+	if (!GesturesDB->bUseQuantizedSamples)
+	{
+		float ReferenceDistance = MAX_FLT;
+		float VectorizedDistance = MAX_FLT;
+		const int ReferenceIndex = GestureComponent->FindBestGesture(GestureComponent->GesturesDB, Input, ReferenceDistance);
+		const int VectorizedIndex = GestureComponent->FindBestGestureVectorized(GestureComponent->GesturesDB, Input, VectorizedDistance);
+
+		if (ReferenceIndex != VectorizedIndex)
+		{
+			InOutRun.VectorizedBestMatchMismatches++;
+			UE_LOG(LogVRGestureBenchmark, Warning, TEXT("Vectorized search matched %d (%f), scalar search matched %d (%f)"), VectorizedIndex, VectorizedDistance, ReferenceIndex, ReferenceDistance);
+		}
+	}
+}
+
+int32 UVRGestureBenchmarkCommandlet::RunRecording(UVRGestureComponent * GestureComponent, const TArray<FVector> & Samples, int32 & OutDetectionSample, FCorpusRun & InOutRun)
+{
+	GestureComponent->ResetRecordingState(true);
+	LastDetectedIndex = INDEX_NONE;
+	OutDetectionSample = INDEX_NONE;
+
+	// Recordings are stored newest first
+	for (int32 i = Samples.Num() - 1; i >= 0; --i)
+	{
+		// Streaming and progress detection run their DTW when the sample is added, so the add is timed along with the detection
+		uint64 StartCycles = FPlatformTime::Cycles64();
+		GestureComponent->AddGestureSample(Samples[i]);
+
+		const bool bRunDetection = GestureComponent->bGestureChanged;
+		if (!bRunDetection)
+		{
+			InOutRun.RecognitionCycles += FPlatformTime::Cycles64() - StartCycles;
+			continue;
+		}
+
+		// Comparisons run before the detection since a detection clears the recording, they are left out of the timing
+		if ((bCompareStreaming && InOutRun.Mode.bStreaming) || (bCompareVectorized && !InOutRun.Mode.bStreaming))
+		{
+			const uint64 CompareStartCycles = FPlatformTime::Cycles64();
+
+			if (InOutRun.Mode.bStreaming)
+				CompareStreamingCosts(GestureComponent, InOutRun.StreamingCosts);
+			else
+				CompareVectorized(GestureComponent, InOutRun);
+
+			StartCycles += FPlatformTime::Cycles64() - CompareStartCycles;
+		}
+
+		GestureComponent->RunGestureDetection();
+
+		InOutRun.RecognitionCycles += FPlatformTime::Cycles64() - StartCycles;
+		InOutRun.RecognitionCount++;
+
+		if (LastDetectedIndex != INDEX_NONE)
+		{
+			OutDetectionSample = Samples.Num() - i;
+			break;
+		}
+	}
+
+	return LastDetectedIndex;
+}
+
+void UVRGestureBenchmarkCommandlet::RunCorpus(UVRGestureComponent * GestureComponent, const UGesturesDatabase * Corpus, const TArray<int32> & ExpectedIndices, int32 Iterations, FCorpusRun & OutRun)
+{
+	OutRun.Results.Reset();
+	OutRun.Results.AddDefaulted(GestureComponent->GesturesDB->Gestures.Num());
+	OutRun.DetectedIndices.Reset();
+	OutRun.DetectionSamples.Reset();
+
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		for (int32 RecordingIndex = 0; RecordingIndex < Corpus->Gestures.Num(); ++RecordingIndex)
+		{
+			int32 DetectionSample = INDEX_NONE;
+			const int32 DetectedIndex = RunRecording(GestureComponent, Corpus->Gestures[RecordingIndex].Samples, DetectionSample, OutRun);
+
+			// Extra iterations are only there for stable timings, results are the same every time
+			if (Iteration > 0)
+				continue;
+
+			OutRun.DetectedIndices.Add(DetectedIndex);
+			OutRun.DetectionSamples.Add(DetectionSample);
+
+			const int32 ExpectedIndex = ExpectedIndices[RecordingIndex];
+
+			if (ExpectedIndex == INDEX_NONE)
+			{
+				OutRun.NegativeRecordings++;
+			}
+			else
+			{
+				OutRun.Results[ExpectedIndex].Recordings++;
+			}
+
+			if (DetectedIndex != INDEX_NONE && DetectedIndex == ExpectedIndex)
+			{
+				OutRun.Results[ExpectedIndex].TruePositives++;
+				OutRun.Results[ExpectedIndex].LatencySamples += DetectionSample;
+			}
+			else
+			{
+				if (DetectedIndex != INDEX_NONE)
+				{
+					OutRun.Results[DetectedIndex].FalsePositives++;
+
+					if (ExpectedIndex == INDEX_NONE)
+						OutRun.NegativeFalsePositives++;
+				}
+
+				if (ExpectedIndex != INDEX_NONE)
+					OutRun.Results[ExpectedIndex].FalseNegatives++;
+			}
+		}
+	}
+}
+
+int32 UVRGestureBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString DatabasePath;
+	FString CorpusPath;
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Gestures") / TEXT("GestureBenchmark.csv");
+	int32 Iterations = 1;
+	int32 BufferSize = 60;
+
+	if (!FParse::Value(*Params, TEXT("Database="), DatabasePath) || !FParse::Value(*Params, TEXT("Corpus="), CorpusPath))
+	{
+		UE_LOG(LogVRGestureBenchmark, Error, TEXT("Usage: -run=VRGestureBenchmark -Database=<Path> -Corpus=<Path> [-Output=<File>] [-Iterations=N] [-BufferSize=N] [-Streaming | -CompareStreaming] [-Vectorized] [-CompareVectorized] [-LowerBound] [-Progress] [-Quantized | -CompareQuantized]"));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("BufferSize="), BufferSize);
+	Iterations = FMath::Max(Iterations, 1);
+
+	UGesturesDatabase * Database = VRGestureBenchmark::LoadDatabase(DatabasePath);
+	UGesturesDatabase * Corpus = VRGestureBenchmark::LoadDatabase(CorpusPath);
+
+	if (!Database || !Corpus)
+	{
+		UE_LOG(LogVRGestureBenchmark, Error, TEXT("Failed to load the gesture database (%s) or corpus (%s)"), *DatabasePath, *CorpusPath);
+		return 1;
+	}
+
+	UVRGestureComponent * GestureComponent = NewObject<UVRGestureComponent>(GetTransientPackage());
+	GestureComponent->GesturesDB = Database;
+	GestureComponent->RecordingBufferSize = BufferSize;
+	GestureComponent->bDrawRecordingGesture = false;
+	GestureComponent->bUseAsyncDetection = false;
+	GestureComponent->bUseVectorizedDTW = FParse::Param(*Params, TEXT("Vectorized"));
+	GestureComponent->bUseLowerBoundPruning = FParse::Param(*Params, TEXT("LowerBound"));
+	GestureComponent->bTrackGestureProgress = FParse::Param(*Params, TEXT("Progress"));
+	GestureComponent->OnGestureDetected_Bind.AddDynamic(this, &UVRGestureBenchmarkCommandlet::OnGestureDetected);
+
+	// Map each corpus recording onto the gesture it should detect as
+	TArray<int32> ExpectedIndices;
+	ExpectedIndices.Reserve(Corpus->Gestures.Num());
+
+	for (const FVRGesture & Recording : Corpus->Gestures)
+	{
+		int32 ExpectedIndex = INDEX_NONE;
+
+		if (!Recording.Name.IsEmpty())
+		{
+			ExpectedIndex = Database->Gestures.IndexOfByPredicate([&Recording](const FVRGesture & Gesture) { return Gesture.Name == Recording.Name; });
+
+			if (ExpectedIndex == INDEX_NONE)
+			{
+				UE_LOG(LogVRGestureBenchmark, Warning, TEXT("Corpus recording %s has no gesture in the database, treating it as a negative"), *Recording.Name);
+			}
+		}
+
+		ExpectedIndices.Add(ExpectedIndex);
+	}
+
+	// Either one run with the requested options, or every combination of the compared ones
+	const bool bCompareQuantized = FParse::Param(*Params, TEXT("CompareQuantized"));
+	bCompareStreaming = FParse::Param(*Params, TEXT("CompareStreaming"));
+	bCompareVectorized = FParse::Param(*Params, TEXT("CompareVectorized"));
+
+	TArray<FRunMode, TInlineAllocator<4>> Modes;
+
+	for (int32 QuantizedIndex = 0; QuantizedIndex < (bCompareQuantized ? 2 : 1); ++QuantizedIndex)
+	{
+		const bool bQuantized = bCompareQuantized ? QuantizedIndex > 0 : FParse::Param(*Params, TEXT("Quantized"));
+
+		if (bCompareStreaming)
+		{
+			Modes.Emplace(bQuantized, false);
+			Modes.Emplace(bQuantized, true);
+		}
+		else
+		{
+			Modes.Emplace(bQuantized, FParse::Param(*Params, TEXT("Streaming")));
+		}
+	}
+
+	TArray<FCorpusRun> Runs;
+	Runs.AddDefaulted(Modes.Num());
+
+	for (int32 RunIndex = 0; RunIndex < Modes.Num(); ++RunIndex)
+	{
+		Runs[RunIndex].Mode = Modes[RunIndex];
+
+		Database->bUseQuantizedSamples = Modes[RunIndex].bQuantized;
+		Database->MarkGesturesDirty();
+		GestureComponent->bUseStreamingDetection = Modes[RunIndex].bStreaming;
+
+		RunCorpus(GestureComponent, Corpus, ExpectedIndices, Iterations, Runs[RunIndex]);
+	}
+
+	FString Output = TEXT("Gesture,Quantized,Streaming,Recordings,TruePositives,FalsePositives,FalseNegatives,Precision,Recall,MeanLatencySamples\n");
+	FString Summary = TEXT("Quantized,Streaming,NegativeRecordings,NegativeFalsePositives,TotalPrecision,TotalRecall,Recognitions,NsPerRecognition,Vectorized,LowerBound,Progress,ResampleSpacing,SimplifyTolerance,AlignToPrincipalAxis,")
+		TEXT("DetectionsDifferingFromFirstRun,StreamingCostComparisons,StreamingCostMismatches,MeanStreamingCostDifference,MaxStreamingCostDifference,")
+		TEXT("VectorizedCostComparisons,VectorizedCostMismatches,MaxVectorizedCostDifference,VectorizedBestMatchMismatches\n");
+
+	bool bVectorizedMismatch = false;
+
+	for (const FCorpusRun & Run : Runs)
+	{
+		// Same recording detecting a different gesture, or the same gesture on a different sample
+		int32 DifferingDetections = 0;
+
+		for (int32 i = 0; i < Run.DetectedIndices.Num(); ++i)
+		{
+			if (Run.DetectedIndices[i] != Runs[0].DetectedIndices[i] || Run.DetectionSamples[i] != Runs[0].DetectionSamples[i])
+				DifferingDetections++;
+		}
+
+		FGestureResult Totals;
+
+		for (int32 i = 0; i < Run.Results.Num(); ++i)
+		{
+			const FGestureResult & Result = Run.Results[i];
+			const int32 Detected = Result.TruePositives + Result.FalsePositives;
+			const int32 Expected = Result.TruePositives + Result.FalseNegatives;
+
+			Output += FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%d,%.4f,%.4f,%.2f\n"),
+				*Database->Gestures[i].Name.Replace(TEXT(","), TEXT(" ")),
+				Run.Mode.bQuantized ? 1 : 0,
+				Run.Mode.bStreaming ? 1 : 0,
+				Result.Recordings,
+				Result.TruePositives,
+				Result.FalsePositives,
+				Result.FalseNegatives,
+				Detected > 0 ? (float)Result.TruePositives / Detected : 0.f,
+				Expected > 0 ? (float)Result.TruePositives / Expected : 0.f,
+				Result.TruePositives > 0 ? (double)Result.LatencySamples / Result.TruePositives : 0.0);
+
+			Totals.Recordings += Result.Recordings;
+			Totals.TruePositives += Result.TruePositives;
+			Totals.FalsePositives += Result.FalsePositives;
+			Totals.FalseNegatives += Result.FalseNegatives;
+			Totals.LatencySamples += Result.LatencySamples;
+		}
+
+		const double NsPerRecognition = Run.RecognitionCount > 0 ? (double)Run.RecognitionCycles * FPlatformTime::GetSecondsPerCycle64() * 1.0e9 / Run.RecognitionCount : 0.0;
+
+		Summary += FString::Printf(TEXT("%d,%d,%d,%d,%.4f,%.4f,%lld,%.1f,%d,%d,%d,%.3f,%.3f,%d,%d,%lld,%lld,%.6f,%.6f,%lld,%lld,%.6f,%lld\n"),
+			Run.Mode.bQuantized ? 1 : 0,
+			Run.Mode.bStreaming ? 1 : 0,
+			Run.NegativeRecordings,
+			Run.NegativeFalsePositives,
+			(Totals.TruePositives + Totals.FalsePositives) > 0 ? (float)Totals.TruePositives / (Totals.TruePositives + Totals.FalsePositives) : 0.f,
+			(Totals.TruePositives + Totals.FalseNegatives) > 0 ? (float)Totals.TruePositives / (Totals.TruePositives + Totals.FalseNegatives) : 0.f,
+			Run.RecognitionCount / Iterations,
+			NsPerRecognition,
+			GestureComponent->bUseVectorizedDTW ? 1 : 0,
+			GestureComponent->bUseLowerBoundPruning ? 1 : 0,
+			GestureComponent->bTrackGestureProgress ? 1 : 0,
+			Database->ResampleSpacing,
+			Database->SimplifyTolerance,
+			Database->bAlignToPrincipalAxis ? 1 : 0,
+			DifferingDetections,
+			Run.StreamingCosts.Comparisons,
+			Run.StreamingCosts.Mismatches,
+			Run.StreamingCosts.Comparisons > 0 ? Run.StreamingCosts.DifferenceSum / Run.StreamingCosts.Comparisons : 0.0,
+			Run.StreamingCosts.MaxDifference,
+			Run.VectorizedCosts.Comparisons,
+			Run.VectorizedCosts.Mismatches,
+			Run.VectorizedCosts.MaxDifference,
+			Run.VectorizedBestMatchMismatches);
+
+		UE_LOG(LogVRGestureBenchmark, Display, TEXT("Ran %d recordings x %d iterations with %s samples and %s detection, %.1f ns per recognition"), Corpus->Gestures.Num(), Iterations,
+			Run.Mode.bQuantized ? TEXT("quantized") : TEXT("float"), Run.Mode.bStreaming ? TEXT("streaming") : TEXT("full table"), NsPerRecognition);
+
+		if (Run.StreamingCosts.Comparisons > 0)
+		{
+			UE_LOG(LogVRGestureBenchmark, Display, TEXT("Streaming costs differ from dtw() by more than %.1f%% in %lld of %lld comparisons, %d recordings detected differently than the first run"),
+				VRGestureBenchmark::CostTolerance * 100.f, Run.StreamingCosts.Mismatches, Run.StreamingCosts.Comparisons, DifferingDetections);
+		}
+
+		if (Run.VectorizedCosts.Mismatches > 0 || Run.VectorizedBestMatchMismatches > 0)
+		{
+			UE_LOG(LogVRGestureBenchmark, Error, TEXT("Vectorized DTW differs from dtw() in %lld of %lld costs (max difference %f) and picked a different gesture %lld times"),
+				Run.VectorizedCosts.Mismatches, Run.VectorizedCosts.Comparisons, Run.VectorizedCosts.MaxDifference, Run.VectorizedBestMatchMismatches);
+			bVectorizedMismatch = true;
+		}
+		else if (Run.VectorizedCosts.Comparisons > 0)
+		{
+			UE_LOG(LogVRGestureBenchmark, Display, TEXT("Vectorized DTW matches dtw() on all %lld costs"), Run.VectorizedCosts.Comparisons);
+		}
+	}
+
+	// Separate files so that each one is a single table
+	const FString SummaryPath = FPaths::Combine(FPaths::GetPath(OutputPath), FPaths::GetBaseFilename(OutputPath) + TEXT("_Summary.csv"));
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputPath) || !FFileHelper::SaveStringToFile(Summary, *SummaryPath))
+	{
+		UE_LOG(LogVRGestureBenchmark, Error, TEXT("Failed to write results to %s and %s"), *OutputPath, *SummaryPath);
+		return 1;
+	}
+
+	UE_LOG(LogVRGestureBenchmark, Display, TEXT("Results written to %s and %s"), *OutputPath, *SummaryPath);
+	return bVectorizedMismatch ? 1 : 0;
+}
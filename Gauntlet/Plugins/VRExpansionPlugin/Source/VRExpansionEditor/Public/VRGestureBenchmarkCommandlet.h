@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "VRGestureBenchmarkCommandlet.generated.h"
+
+class UGesturesDatabase;
+class UVRGestureComponent;
+
+/**
+*	Runs recorded gestures through UVRGestureComponent detection without a headset and writes the results out as CSV.
+*	Per gesture results go to the output file and the per run totals and timings to <Output>_Summary.csv next to it.
+*
+*	The corpus is a gestures database of raw recordings (as returned by EndRecording), each named after the database gesture
+*	that it should detect as, or left unnamed for recordings that should not detect as anything. Samples are fed oldest first,
+*	one per capture frame, with the same duplicate rejection and buffer size as live recording.
+*
+*	Usage: -run=VRGestureBenchmark -Database=/Game/Gestures/DB -Corpus=/Game/Gestures/Corpus [-Output=Path.csv] [-Iterations=N]
+*	       [-BufferSize=N] [-Streaming | -CompareStreaming] [-Vectorized] [-CompareVectorized] [-LowerBound] [-Progress] [-Quantized | -CompareQuantized]
+*
+*	-CompareQuantized runs the corpus with the float samples and then with the quantized samples and writes both results.
+*	-CompareStreaming runs the corpus with full table detection and then with streaming detection and writes both results. During the
+*	streaming run every streaming cost is also checked against dtw() on the same sample window, the summary has the differences and
+*	the number of recordings that detected differently than the first run. The two are expected to differ a little, see FVRGestureStreamingState.
+*	Both compare options can be combined, every combination is ran.
+*	-CompareVectorized checks the vectorized kernel against the scalar dtw() on every detection of the full table runs, for every database
+*	gesture both normal and mirrored, and the best match of the vectorized search against the scalar one (float runs only, the vectorized
+*	search doesn't use quantized samples). The commandlet fails if any of them differ, so it can gate changes to the kernel.
+*	Detection runs synchronously so that the timing covers the recognition itself. Each timing covers adding the sample as well,
+*	streaming and progress detection update their DTW states there. The comparisons are not timed.
+*/
+UCLASS()
+class VREXPANSIONEDITOR_API UVRGestureBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UVRGestureBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer);
+
+	virtual int32 Main(const FString& Params) override;
+
+	// Bound to the benchmarked component to catch detections
+	UFUNCTION()
+	void OnGestureDetected(uint8 GestureType, FString DetectedGestureName, int DetectedGestureIndex, UGesturesDatabase * GestureDataBase);
+
+private:
+
+	// Per database gesture results
+	struct FGestureResult
+	{
+		int32 Recordings;
+		int32 TruePositives;
+		int32 FalsePositives;
+		int32 FalseNegatives;
+		int64 LatencySamples;
+
+		FGestureResult() :
+			Recordings(0),
+			TruePositives(0),
+			FalsePositives(0),
+			FalseNegatives(0),
+			LatencySamples(0)
+		{}
+	};
+
+	// Options that change between the runs of a comparison
+	struct FRunMode
+	{
+		bool bQuantized;
+		bool bStreaming;
+
+		FRunMode(bool bInQuantized, bool bInStreaming) :
+			bQuantized(bInQuantized),
+			bStreaming(bInStreaming)
+		{}
+	};
+
+	// Differences between per gesture costs (normalized by the gesture length) of a detection mode and the reference dtw()
+	struct FCostComparison
+	{
+		int64 Comparisons;
+		int64 Mismatches;
+		double DifferenceSum;
+		float MaxDifference;
+
+		FCostComparison() :
+			Comparisons(0),
+			Mismatches(0),
+			DifferenceSum(0.0),
+			MaxDifference(0.f)
+		{}
+
+		// Adds a compared pair, costs more than RelativeTolerance apart count as a mismatch
+		void Add(float ReferenceCost, float Cost, float RelativeTolerance)
+		{
+			const float Difference = FMath::Abs(Cost - ReferenceCost);
+
+			Comparisons++;
+			DifferenceSum += Difference;
+			MaxDifference = FMath::Max(MaxDifference, Difference);
+
+			if (Difference > RelativeTolerance * FMath::Max(FMath::Abs(ReferenceCost), KINDA_SMALL_NUMBER))
+				Mismatches++;
+		}
+	};
+
+	// Results of running the whole corpus once with one set of options
+	struct FCorpusRun
+	{
+		TArray<FGestureResult> Results;
+		int32 NegativeRecordings;
+		int32 NegativeFalsePositives;
+		uint64 RecognitionCycles;
+		int64 RecognitionCount;
+		FRunMode Mode;
+
+		// Detected gesture and detection sample of every corpus recording, from the first iteration
+		TArray<int32> DetectedIndices;
+		TArray<int32> DetectionSamples;
+
+		// Streaming costs against dtw(), only filled in for streaming runs of -CompareStreaming
+		FCostComparison StreamingCosts;
+
+		// dtwBatch() costs against dtw() and the number of times the two searches picked a different gesture, filled in by -CompareVectorized
+		FCostComparison VectorizedCosts;
+		int64 VectorizedBestMatchMismatches;
+
+		FCorpusRun() :
+			NegativeRecordings(0),
+			NegativeFalsePositives(0),
+			RecognitionCycles(0),
+			RecognitionCount(0),
+			Mode(false, false),
+			VectorizedBestMatchMismatches(0)
+		{}
+	};
+
+	// Feeds every corpus recording through the component Iterations times, ExpectedIndices maps each recording onto its database gesture
+	void RunCorpus(UVRGestureComponent * GestureComponent, const UGesturesDatabase * Corpus, const TArray<int32> & ExpectedIndices, int32 Iterations, FCorpusRun & OutRun);
+
+	// Feeds one recording through the component, returns the detected gesture index (INDEX_NONE if none) and the sample it was detected on
+	int32 RunRecording(UVRGestureComponent * GestureComponent, const TArray<FVector> & Samples, int32 & OutDetectionSample, FCorpusRun & InOutRun);
+
+	// Checks the cost of every streaming state against dtw() on the current sample window
+	static void CompareStreamingCosts(UVRGestureComponent * GestureComponent, FCostComparison & InOutComparison);
+
+	// Checks the vectorized kernel and search against the scalar ones on the input that detection is about to score
+	static void CompareVectorized(UVRGestureComponent * GestureComponent, FCorpusRun & InOutRun);
+
+	// If true the streaming runs check their costs against dtw()
+	bool bCompareStreaming;
+
+	// If true the full table runs check the vectorized kernel against dtw()
+	bool bCompareVectorized;
+
+	// Detection reported during the current sample
+	int32 LastDetectedIndex;
+};
@@ -0,0 +1,26 @@
+// Some copyright should be here...
+using UnrealBuildTool;
+
+public class VRExpansionEditor : ModuleRules
+{
+    public VRExpansionEditor(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        // Editor only tooling for the runtime module (commandlets), not packaged with games
+        PublicDependencyModuleNames.AddRange(
+        new string[]
+        {
+                    "Core",
+                    "CoreUObject",
+                    "Engine",
+                    "VRExpansionPlugin"
+        });
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "UnrealEd"
+            });
+    }
+}
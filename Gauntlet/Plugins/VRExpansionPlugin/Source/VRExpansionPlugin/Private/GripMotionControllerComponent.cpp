@@ -10,6 +10,7 @@
 #include "GameFramework/WorldSettings.h"
 #include "IXRSystemAssets.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/ShapeComponent.h"
 #include "MotionDelayBuffer.h"
 #include "UObject/VRObjectVersion.h"
 #include "UObject/UObjectGlobals.h" // for FindObject<>
@@ -38,6 +39,10 @@ DEFINE_LOG_CATEGORY(LogVRMotionController);
 //For UE4 Profiler ~ Stat
 DECLARE_CYCLE_STAT(TEXT("TickGrip ~ TickingGrip"), STAT_TickGrip, STATGROUP_TickGrip);
 DECLARE_CYCLE_STAT(TEXT("GetGripWorldTransform ~ GettingTransform"), STAT_GetGripTransform, STATGROUP_TickGrip);
+DECLARE_CYCLE_STAT(TEXT("LateUpdateSetup ~ GatheringPrimitives"), STAT_LateUpdateSetup, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LateUpdateSetup ~ HierarchyRebuilds"), STAT_LateUpdateHierarchyRebuilds, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GripSweeps ~ AsyncQueued"), STAT_GripSweepsAsyncQueued, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GripSweeps ~ OverBudget"), STAT_GripSweepsOverBudget, STATGROUP_TickGrip);
 
 // MAGIC NUMBERS
 // Constraint multipliers for angular, to avoid having to have two sets of stiffness/damping variables
@@ -64,6 +69,14 @@ namespace GripMotionControllerCvars
 		TEXT("When on, will draw debug speheres for physics grips COM.\n")
 		TEXT("0: Disable, 1: Enable"),
 		ECVF_Default);
+
+	static int32 CacheLateUpdatePrimitives = 1;
+	FAutoConsoleVariableRef CVarCacheLateUpdatePrimitives(
+		TEXT("vr.CacheLateUpdatePrimitives"),
+		CacheLateUpdatePrimitives,
+		TEXT("When on, late updated component hierarchies are only walked again when their attachments change, turn off to compare the LateUpdateSetup stat against a full walk every frame.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
 }
 
   //=============================================================================
@@ -82,6 +95,10 @@ UGripMotionControllerComponent::UGripMotionControllerComponent(const FObjectInit
 	bHasAuthority = false;
 	bUseWithoutTracking = false;
 	bAlwaysSendTickGrip = false;
+	bUseAsyncGripSweeps = false;
+	MaxAsyncGripSweepsPerFrame = 8;
+	AsyncGripSweepsThisFrame = 0;
+	bGripIndexDirty = true;
 	bAutoActivate = true;
 
 	this->SetIsReplicated(true);
@@ -93,6 +110,10 @@ UGripMotionControllerComponent::UGripMotionControllerComponent(const FObjectInit
 	bReplicateWithoutTracking = false;
 	bLerpingPosition = false;
 	bSmoothReplicatedMotion = false;
+	ReplicatedMotionSmoothing = EVRReplicatedMotionSmoothing::Lerp;
+	MaxExtrapolationTime = 0.1f;
+	ExtrapolationSnapDistance = 50.0f;
+	ExtrapolationSnapAngle = 60.0f;
 	bReppedOnce = false;
 	bOffsetByHMD = false;
 	bIsPostTeleport = false;
@@ -114,6 +135,15 @@ UGripMotionControllerComponent::~UGripMotionControllerComponent()
 	// Epic had it listed as a crash in the private bug tracker I guess.
 }
 
+void UGripMotionControllerComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// After the property init, which copies the grip arrays over from the archetype
+	GrippedObjects.OwningController = this;
+	LocallyGrippedObjects.OwningController = this;
+}
+
 void UGripMotionControllerComponent::NewControllerProfileLoaded()
 {
 	GetCurrentProfileTransform(false);
@@ -186,25 +216,29 @@ void UGripMotionControllerComponent::OnUnregister()
 		}
 	}
 
-	for (int i = 0; i < GrippedObjects.Num(); i++)
+	for (int i = 0; i < GrippedObjects.Items.Num(); i++)
 	{
-		DestroyPhysicsHandle(GrippedObjects[i]);
+		DestroyPhysicsHandle(GrippedObjects.Items[i]);
 
-		if(HasGripAuthority(GrippedObjects[i]) || IsServer())
-			DropObjectByInterface(GrippedObjects[i].GrippedObject);
+		if(HasGripAuthority(GrippedObjects.Items[i]) || IsServer())
+			DropObjectByInterface(GrippedObjects.Items[i].GrippedObject);
 		//DropObject(GrippedObjects[i].GrippedObject, false);	
 	}
-	GrippedObjects.Empty();
+	GrippedObjects.Items.Empty();
+	MarkGripIndexDirty();
+	GrippedObjects.MarkArrayDirty();
 
-	for (int i = 0; i < LocallyGrippedObjects.Num(); i++)
+	for (int i = 0; i < LocallyGrippedObjects.Items.Num(); i++)
 	{
-		DestroyPhysicsHandle(LocallyGrippedObjects[i]);
+		DestroyPhysicsHandle(LocallyGrippedObjects.Items[i]);
 
-		if (HasGripAuthority(LocallyGrippedObjects[i]) || IsServer())
-			DropObjectByInterface(LocallyGrippedObjects[i].GrippedObject);
+		if (HasGripAuthority(LocallyGrippedObjects.Items[i]) || IsServer())
+			DropObjectByInterface(LocallyGrippedObjects.Items[i].GrippedObject);
 		//DropObject(LocallyGrippedObjects[i].GrippedObject, false);
 	}
-	LocallyGrippedObjects.Empty();
+	LocallyGrippedObjects.Items.Empty();
+	MarkGripIndexDirty();
+	LocallyGrippedObjects.MarkArrayDirty();
 
 	for (int i = 0; i < PhysicsGrips.Num(); i++)
 	{
@@ -320,6 +354,25 @@ void UGripMotionControllerComponent::Server_SendControllerTransform_Implementati
 		OnRep_ReplicatedControllerTransform();
 }
 
+void UGripMotionControllerComponent::AddReplicatedMotionSample()
+{
+	const UWorld * MyWorld = GetWorld();
+	const float UpdateInterval = ControllerNetUpdateRate > 0.0f ? 1.0f / ControllerNetUpdateRate : 0.0f;
+
+	if (MotionExtrapolator.AddSample(ReplicatedControllerTransform, this->RelativeLocation, this->RelativeRotation, MyWorld ? MyWorld->GetTimeSeconds() : 0.0f, UpdateInterval, MaxExtrapolationTime, ExtrapolationSnapDistance, ExtrapolationSnapAngle))
+	{
+		SetRelativeLocationAndRotation(ReplicatedControllerTransform.Position, ReplicatedControllerTransform.Rotation);
+	}
+
+	// Keeps the lerp mode consistent if it gets switched back at runtime
+	LastUpdatesRelativePosition = this->RelativeLocation;
+	LastUpdatesRelativeRotation = this->RelativeRotation;
+	ControllerNetUpdateCount = 0.0f;
+
+	bLerpingPosition = true;
+	bReppedOnce = true;
+}
+
 bool UGripMotionControllerComponent::Server_SendControllerTransform_Validate(FBPVRComponentPosRep NewTransform)
 {
 	return true;
@@ -356,6 +409,81 @@ void UGripMotionControllerComponent::GetPhysicsVelocities(const FBPActorGripInfo
 	LinearVelocity = primComp->GetPhysicsLinearVelocity();
 }
 
+void UGripMotionControllerComponent::RebuildGripIndex()
+{
+	GripSlotsByObject.Reset();
+	GripSlotsByID.Reset();
+
+	// Same precedence as the FindByKey scans, replicated grips first and the first grip of an object wins
+	auto AddGrips = [this](const TArray<FBPActorGripInformation> & Grips, int32 SlotOffset)
+	{
+		for (int32 i = 0; i < Grips.Num(); ++i)
+		{
+			if (Grips[i].GrippedObject && !GripSlotsByObject.Contains(Grips[i].GrippedObject))
+				GripSlotsByObject.Add(Grips[i].GrippedObject, SlotOffset + i);
+
+			if (Grips[i].GripID != INVALID_VRGRIP_ID && !GripSlotsByID.Contains(Grips[i].GripID))
+				GripSlotsByID.Add(Grips[i].GripID, SlotOffset + i);
+		}
+	};
+
+	AddGrips(GrippedObjects.Items, 0);
+	AddGrips(LocallyGrippedObjects.Items, VRGRIP_LOCAL_GRIP_SLOT);
+
+	bGripIndexDirty = false;
+}
+
+FBPActorGripInformation * UGripMotionControllerComponent::GetGripInSlot(int32 Slot)
+{
+	if (Slot >= VRGRIP_LOCAL_GRIP_SLOT)
+		return LocallyGrippedObjects.Items.IsValidIndex(Slot - VRGRIP_LOCAL_GRIP_SLOT) ? &LocallyGrippedObjects.Items[Slot - VRGRIP_LOCAL_GRIP_SLOT] : nullptr;
+
+	return GrippedObjects.Items.IsValidIndex(Slot) ? &GrippedObjects.Items[Slot] : nullptr;
+}
+
+FBPActorGripInformation * UGripMotionControllerComponent::FindGripByObject(const UObject * ObjectToFind)
+{
+	if (!ObjectToFind)
+		return nullptr;
+
+	if (bGripIndexDirty)
+		RebuildGripIndex();
+
+	const int32 * Slot = GripSlotsByObject.Find(ObjectToFind);
+	FBPActorGripInformation * GripInfo = Slot ? GetGripInSlot(*Slot) : nullptr;
+
+	// The arrays changed without the index being told, rebuild it and look again
+	if (Slot && (!GripInfo || GripInfo->GrippedObject != ObjectToFind))
+	{
+		RebuildGripIndex();
+		Slot = GripSlotsByObject.Find(ObjectToFind);
+		GripInfo = Slot ? GetGripInSlot(*Slot) : nullptr;
+	}
+
+	return GripInfo;
+}
+
+FBPActorGripInformation * UGripMotionControllerComponent::FindGripByID(uint8 GripIDToFind)
+{
+	if (GripIDToFind == INVALID_VRGRIP_ID)
+		return nullptr;
+
+	if (bGripIndexDirty)
+		RebuildGripIndex();
+
+	const int32 * Slot = GripSlotsByID.Find(GripIDToFind);
+	FBPActorGripInformation * GripInfo = Slot ? GetGripInSlot(*Slot) : nullptr;
+
+	if (Slot && (!GripInfo || GripInfo->GripID != GripIDToFind))
+	{
+		RebuildGripIndex();
+		Slot = GripSlotsByID.Find(GripIDToFind);
+		GripInfo = Slot ? GetGripInSlot(*Slot) : nullptr;
+	}
+
+	return GripInfo;
+}
+
 void UGripMotionControllerComponent::GetGripByActor(FBPActorGripInformation &Grip, AActor * ActorToLookForGrip, EBPVRResultSwitch &Result)
 {
 	if (!ActorToLookForGrip)
@@ -364,13 +492,11 @@ void UGripMotionControllerComponent::GetGripByActor(FBPActorGripInformation &Gri
 		return;
 	}
 
-	FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(ActorToLookForGrip);
-	if(!GripInfo)
-		GripInfo = LocallyGrippedObjects.FindByKey(ActorToLookForGrip);
+	FBPActorGripInformation * GripInfo = FindGripByObject(ActorToLookForGrip);
 	
 	if (GripInfo)
 	{
-		Grip = *GripInfo;// GrippedObjects[i];
+		Grip = *GripInfo;// GrippedObjects.Items[i];
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
@@ -386,13 +512,11 @@ void UGripMotionControllerComponent::GetGripByComponent(FBPActorGripInformation
 		return;
 	}
 
-	FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(ComponentToLookForGrip);
-	if(!GripInfo)
-		GripInfo = LocallyGrippedObjects.FindByKey(ComponentToLookForGrip);
+	FBPActorGripInformation * GripInfo = FindGripByObject(ComponentToLookForGrip);
 
 	if (GripInfo)
 	{
-		Grip = *GripInfo;// GrippedObjects[i];
+		Grip = *GripInfo;// GrippedObjects.Items[i];
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
@@ -408,13 +532,11 @@ void UGripMotionControllerComponent::GetGripByObject(FBPActorGripInformation &Gr
 		return;
 	}
 
-	FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(ObjectToLookForGrip);
-	if(!GripInfo)
-		GripInfo = LocallyGrippedObjects.FindByKey(ObjectToLookForGrip);
+	FBPActorGripInformation * GripInfo = FindGripByObject(ObjectToLookForGrip);
 
 	if (GripInfo)
 	{
-		Grip = *GripInfo;// GrippedObjects[i];
+		Grip = *GripInfo;// GrippedObjects.Items[i];
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
@@ -430,13 +552,11 @@ void UGripMotionControllerComponent::GetGripByID(FBPActorGripInformation &Grip,
 		return;
 	}
 
-	FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(IDToLookForGrip);
-	if (!GripInfo)
-		GripInfo = LocallyGrippedObjects.FindByKey(IDToLookForGrip);
+	FBPActorGripInformation * GripInfo = FindGripByID(IDToLookForGrip);
 
 	if (GripInfo)
 	{
-		Grip = *GripInfo;// GrippedObjects[i];
+		Grip = *GripInfo;// GrippedObjects.Items[i];
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
@@ -446,21 +566,21 @@ void UGripMotionControllerComponent::GetGripByID(FBPActorGripInformation &Grip,
 
 void UGripMotionControllerComponent::SetGripPaused(const FBPActorGripInformation &Grip, EBPVRResultSwitch &Result, bool bIsPaused, bool bNoConstraintWhenPaused)
 {
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	FBPActorGripInformation * GripInformation = nullptr;
 
 	if (fIndex != INDEX_NONE)
 	{
-		GripInformation = &GrippedObjects[fIndex];
+		GripInformation = &GrippedObjects.Items[fIndex];
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			GripInformation = &LocallyGrippedObjects[fIndex];
+			GripInformation = &LocallyGrippedObjects.Items[fIndex];
 		}
 	}
 
@@ -494,19 +614,19 @@ void UGripMotionControllerComponent::SetPausedTransform(const FBPActorGripInform
 
 	FBPActorGripInformation * GripInformation = nullptr;
 
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GripInformation = &GrippedObjects[fIndex];
+		GripInformation = &GrippedObjects.Items[fIndex];
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			GripInformation = &LocallyGrippedObjects[fIndex];
+			GripInformation = &LocallyGrippedObjects.Items[fIndex];
 		}
 	}
 	
@@ -519,7 +639,7 @@ void UGripMotionControllerComponent::SetPausedTransform(const FBPActorGripInform
 		}
 		else
 		{
-			if (FBPActorPhysicsHandleInformation * PhysHandle = GetPhysicsGrip(GrippedObjects[fIndex]))
+			if (FBPActorPhysicsHandleInformation * PhysHandle = GetPhysicsGrip(GrippedObjects.Items[fIndex]))
 			{
 				UpdatePhysicsHandleTransform(*GripInformation, PausedTransform);
 			}
@@ -543,27 +663,29 @@ void UGripMotionControllerComponent::SetPausedTransform(const FBPActorGripInform
 
 void UGripMotionControllerComponent::SetGripCollisionType(const FBPActorGripInformation &Grip, EBPVRResultSwitch &Result, EGripCollisionType NewGripCollisionType)
 {
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GrippedObjects[fIndex].GripCollisionType = NewGripCollisionType;
-		ReCreateGrip(GrippedObjects[fIndex]);
+		GrippedObjects.Items[fIndex].GripCollisionType = NewGripCollisionType;
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[fIndex]);
+		ReCreateGrip(GrippedObjects.Items[fIndex]);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			LocallyGrippedObjects[fIndex].GripCollisionType = NewGripCollisionType;
+			LocallyGrippedObjects.Items[fIndex].GripCollisionType = NewGripCollisionType;
+			LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[fIndex]);
 
-			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
-				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects[fIndex]);
+			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects.Items[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
+				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects.Items[fIndex]);
 
-			ReCreateGrip(LocallyGrippedObjects[fIndex]);
+			ReCreateGrip(LocallyGrippedObjects.Items[fIndex]);
 
 			Result = EBPVRResultSwitch::OnSucceeded;
 			return;
@@ -575,24 +697,26 @@ void UGripMotionControllerComponent::SetGripCollisionType(const FBPActorGripInfo
 
 void UGripMotionControllerComponent::SetGripLateUpdateSetting(const FBPActorGripInformation &Grip, EBPVRResultSwitch &Result, EGripLateUpdateSettings NewGripLateUpdateSetting)
 {
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GrippedObjects[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
+		GrippedObjects.Items[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[fIndex]);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			LocallyGrippedObjects[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
+			LocallyGrippedObjects.Items[fIndex].GripLateUpdateSetting = NewGripLateUpdateSetting;
+			LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[fIndex]);
 
-			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
-				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects[fIndex]);
+			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects.Items[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
+				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects.Items[fIndex]);
 
 			Result = EBPVRResultSwitch::OnSucceeded;
 			return;
@@ -608,24 +732,26 @@ void UGripMotionControllerComponent::SetGripRelativeTransform(
 	const FTransform & NewRelativeTransform
 	)
 {
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GrippedObjects[fIndex].RelativeTransform = NewRelativeTransform;
+		GrippedObjects.Items[fIndex].RelativeTransform = NewRelativeTransform;
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[fIndex]);
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			LocallyGrippedObjects[fIndex].RelativeTransform = NewRelativeTransform;
+			LocallyGrippedObjects.Items[fIndex].RelativeTransform = NewRelativeTransform;
+			LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[fIndex]);
 
-			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
-				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects[fIndex]);
+			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects.Items[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
+				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects.Items[fIndex]);
 
 			Result = EBPVRResultSwitch::OnSucceeded;
 			return;
@@ -641,22 +767,22 @@ void UGripMotionControllerComponent::SetGripAdditionTransform(
 	const FTransform & NewAdditionTransform, bool bMakeGripRelative
 	)
 {
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GrippedObjects[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
+		GrippedObjects.Items[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
 
 		Result = EBPVRResultSwitch::OnSucceeded;
 		return;
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			LocallyGrippedObjects[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
+			LocallyGrippedObjects.Items[fIndex].AdditionTransform = CreateGripRelativeAdditionTransform(Grip, NewAdditionTransform, bMakeGripRelative);
 
 			Result = EBPVRResultSwitch::OnSucceeded;
 			return;
@@ -672,43 +798,45 @@ void UGripMotionControllerComponent::SetGripStiffnessAndDamping(
 	)
 {
 	Result = EBPVRResultSwitch::OnFailed;
-	int fIndex = GrippedObjects.Find(Grip);
+	int fIndex = GrippedObjects.Items.Find(Grip);
 
 	if (fIndex != INDEX_NONE)
 	{
-		GrippedObjects[fIndex].Stiffness = NewStiffness;
-		GrippedObjects[fIndex].Damping = NewDamping;
+		GrippedObjects.Items[fIndex].Stiffness = NewStiffness;
+		GrippedObjects.Items[fIndex].Damping = NewDamping;
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[fIndex]);
 
 		if (bAlsoSetAngularValues)
 		{
-			GrippedObjects[fIndex].AdvancedGripSettings.PhysicsSettings.AngularStiffness = OptionalAngularStiffness;
-			GrippedObjects[fIndex].AdvancedGripSettings.PhysicsSettings.AngularDamping = OptionalAngularDamping;
+			GrippedObjects.Items[fIndex].AdvancedGripSettings.PhysicsSettings.AngularStiffness = OptionalAngularStiffness;
+			GrippedObjects.Items[fIndex].AdvancedGripSettings.PhysicsSettings.AngularDamping = OptionalAngularDamping;
 		}
 
 		Result = EBPVRResultSwitch::OnSucceeded;
-		SetGripConstraintStiffnessAndDamping(&GrippedObjects[fIndex]);
+		SetGripConstraintStiffnessAndDamping(&GrippedObjects.Items[fIndex]);
 		//return;
 	}
 	else
 	{
-		fIndex = LocallyGrippedObjects.Find(Grip);
+		fIndex = LocallyGrippedObjects.Items.Find(Grip);
 
 		if (fIndex != INDEX_NONE)
 		{
-			LocallyGrippedObjects[fIndex].Stiffness = NewStiffness;
-			LocallyGrippedObjects[fIndex].Damping = NewDamping;
+			LocallyGrippedObjects.Items[fIndex].Stiffness = NewStiffness;
+			LocallyGrippedObjects.Items[fIndex].Damping = NewDamping;
+			LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[fIndex]);
 
 			if (bAlsoSetAngularValues)
 			{
-				LocallyGrippedObjects[fIndex].AdvancedGripSettings.PhysicsSettings.AngularStiffness = OptionalAngularStiffness;
-				LocallyGrippedObjects[fIndex].AdvancedGripSettings.PhysicsSettings.AngularDamping = OptionalAngularDamping;
+				LocallyGrippedObjects.Items[fIndex].AdvancedGripSettings.PhysicsSettings.AngularStiffness = OptionalAngularStiffness;
+				LocallyGrippedObjects.Items[fIndex].AdvancedGripSettings.PhysicsSettings.AngularDamping = OptionalAngularDamping;
 			}
 
-			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
-				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects[fIndex]);
+			if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && LocallyGrippedObjects.Items[fIndex].GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
+				Server_NotifyLocalGripAddedOrChanged(LocallyGrippedObjects.Items[fIndex]);
 
 			Result = EBPVRResultSwitch::OnSucceeded;
-			SetGripConstraintStiffnessAndDamping(&LocallyGrippedObjects[fIndex]);
+			SetGripConstraintStiffnessAndDamping(&LocallyGrippedObjects.Items[fIndex]);
 		//	return;
 		}
 	}
@@ -862,6 +990,30 @@ bool UGripMotionControllerComponent::HandleGripReplication(FBPActorGripInformati
 	return true;
 }
 
+void UGripMotionControllerComponent::HandleGripRemovalReplication(const FBPActorGripInformation & Grip)
+{
+	MarkGripIndexDirty();
+
+	// The NotifyDrop multicast normally gets here first and owns the drop, it carries the simulate state that the array doesn't.
+	// A grip that leaves the array without it (the controller wasn't relevant when it was dropped) is dropped here instead.
+	if (Grip.ValueCache.bWasInitiallyRepped && !Grip.ValueCache.bWasDropped && Grip.GrippedObject)
+	{
+		Drop_Implementation(Grip, false);
+	}
+}
+
+void UGripMotionControllerComponent::MarkGripDirty(FBPActorGripInformation & Grip)
+{
+	if (GrippedObjects.Items.Num() && &Grip >= GrippedObjects.Items.GetData() && &Grip < GrippedObjects.Items.GetData() + GrippedObjects.Items.Num())
+	{
+		GrippedObjects.MarkItemDirty(Grip);
+	}
+	else if (LocallyGrippedObjects.Items.Num() && &Grip >= LocallyGrippedObjects.Items.GetData() && &Grip < LocallyGrippedObjects.Items.GetData() + LocallyGrippedObjects.Items.Num())
+	{
+		LocallyGrippedObjects.MarkItemDirty(Grip);
+	}
+}
+
 bool UGripMotionControllerComponent::GripObject(
 	UObject * ObjectToGrip,
 	const FTransform &WorldOffset,
@@ -897,9 +1049,9 @@ bool UGripMotionControllerComponent::DropObject(
 
 	if (ObjectToDrop != nullptr)
 	{
-		FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(ObjectToDrop);
+		FBPActorGripInformation * GripInfo = GrippedObjects.Items.FindByKey(ObjectToDrop);
 		if (!GripInfo)
-			GripInfo = LocallyGrippedObjects.FindByKey(ObjectToDrop);
+			GripInfo = LocallyGrippedObjects.Items.FindByKey(ObjectToDrop);
 
 		if (GripInfo != nullptr)
 		{
@@ -908,9 +1060,9 @@ bool UGripMotionControllerComponent::DropObject(
 	}
 	else if (GripIDToDrop != INVALID_VRGRIP_ID)
 	{
-		FBPActorGripInformation * GripInfo = GrippedObjects.FindByKey(GripIDToDrop);
+		FBPActorGripInformation * GripInfo = GrippedObjects.Items.FindByKey(GripIDToDrop);
 		if (!GripInfo)
-			GripInfo = LocallyGrippedObjects.FindByKey(GripIDToDrop);
+			GripInfo = LocallyGrippedObjects.Items.FindByKey(GripIDToDrop);
 
 		if (GripInfo != nullptr)
 		{
@@ -1030,15 +1182,15 @@ bool UGripMotionControllerComponent::DropObjectByInterface(UObject * ObjectToDro
 	FBPActorGripInformation * GripInfo = nullptr;
 	if (ObjectToDrop != nullptr)
 	{
-		GripInfo = GrippedObjects.FindByKey(ObjectToDrop);
+		GripInfo = GrippedObjects.Items.FindByKey(ObjectToDrop);
 		if (!GripInfo)
-			GripInfo = LocallyGrippedObjects.FindByKey(ObjectToDrop);
+			GripInfo = LocallyGrippedObjects.Items.FindByKey(ObjectToDrop);
 	}
 	else if (GripIDToDrop != INVALID_VRGRIP_ID)
 	{
-		GripInfo = GrippedObjects.FindByKey(GripIDToDrop);
+		GripInfo = GrippedObjects.Items.FindByKey(GripIDToDrop);
 		if (!GripInfo)
-			GripInfo = LocallyGrippedObjects.FindByKey(GripIDToDrop);
+			GripInfo = LocallyGrippedObjects.Items.FindByKey(GripIDToDrop);
 	}
 
 	if (GripInfo == nullptr)
@@ -1250,19 +1402,23 @@ bool UGripMotionControllerComponent::GripActor(
 
 	if (!bIsLocalGrip)
 	{
-		int32 Index = GrippedObjects.Add(newActorGrip);
+		int32 Index = GrippedObjects.Items.Add(newActorGrip);
+		MarkGripIndexDirty();
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[Index]);
 		if(Index != INDEX_NONE)
-			NotifyGrip(GrippedObjects[Index]);
+			NotifyGrip(GrippedObjects.Items[Index]);
 	}
 	else
 	{
-		int32 Index = LocallyGrippedObjects.Add(newActorGrip);
+		int32 Index = LocallyGrippedObjects.Items.Add(newActorGrip);
+		MarkGripIndexDirty();
+		LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[Index]);
 
 		if(GetNetMode() == ENetMode::NM_Client && !IsTornOff() && newActorGrip.GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
 			Server_NotifyLocalGripAddedOrChanged(newActorGrip);
 
 		if (Index != INDEX_NONE)
-			NotifyGrip(LocallyGrippedObjects[Index]);
+			NotifyGrip(LocallyGrippedObjects.Items[Index]);
 	}
 
 	return true;
@@ -1276,7 +1432,7 @@ bool UGripMotionControllerComponent::DropActor(AActor* ActorToDrop, bool bSimula
 		return false;
 	}
 
-	FBPActorGripInformation * GripToDrop = LocallyGrippedObjects.FindByKey(ActorToDrop);
+	FBPActorGripInformation * GripToDrop = LocallyGrippedObjects.Items.FindByKey(ActorToDrop);
 
 	if(GripToDrop)
 		return DropGrip(*GripToDrop, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
@@ -1287,7 +1443,7 @@ bool UGripMotionControllerComponent::DropActor(AActor* ActorToDrop, bool bSimula
 		return false;
 	}
 
-	GripToDrop = GrippedObjects.FindByKey(ActorToDrop);
+	GripToDrop = GrippedObjects.Items.FindByKey(ActorToDrop);
 	if (GripToDrop)
 		return DropGrip(*GripToDrop, bSimulate, OptionalAngularVelocity, OptionalLinearVelocity);
 
@@ -1444,19 +1600,23 @@ bool UGripMotionControllerComponent::GripComponent(
 
 	if (!bIsLocalGrip)
 	{
-		int32 Index = GrippedObjects.Add(newActorGrip);
+		int32 Index = GrippedObjects.Items.Add(newActorGrip);
+		MarkGripIndexDirty();
+		GrippedObjects.MarkItemDirty(GrippedObjects.Items[Index]);
 		if (Index != INDEX_NONE)
-			NotifyGrip(GrippedObjects[Index]);
+			NotifyGrip(GrippedObjects.Items[Index]);
 	}
 	else
 	{
-		int32 Index = LocallyGrippedObjects.Add(newActorGrip);
+		int32 Index = LocallyGrippedObjects.Items.Add(newActorGrip);
+		MarkGripIndexDirty();
+		LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[Index]);
 
 		if (GetNetMode() == ENetMode::NM_Client && !IsTornOff() && newActorGrip.GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive)
 			Server_NotifyLocalGripAddedOrChanged(newActorGrip);
 
 		if (Index != INDEX_NONE)
-			NotifyGrip(LocallyGrippedObjects[Index]);
+			NotifyGrip(LocallyGrippedObjects.Items[Index]);
 	}
 
 	return true;
@@ -1468,7 +1628,7 @@ bool UGripMotionControllerComponent::DropComponent(UPrimitiveComponent * Compone
 	FBPActorGripInformation *GripInfo;
 	
 	// First check for it in the local grips	
-	GripInfo = LocallyGrippedObjects.FindByKey(ComponentToDrop);
+	GripInfo = LocallyGrippedObjects.Items.FindByKey(ComponentToDrop);
 
 	if (GripInfo != nullptr)
 	{
@@ -1483,7 +1643,7 @@ bool UGripMotionControllerComponent::DropComponent(UPrimitiveComponent * Compone
 	}
 
 	// Now check in the server auth gripsop)
-	GripInfo = GrippedObjects.FindByKey(ComponentToDrop);
+	GripInfo = GrippedObjects.Items.FindByKey(ComponentToDrop);
 
 	if (GripInfo != nullptr)
 	{
@@ -1502,7 +1662,7 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 {
 	int FoundIndex = 0;
 	bool bWasLocalGrip = false;
-	if (!LocallyGrippedObjects.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
+	if (!LocallyGrippedObjects.Items.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
 	{
 		if (!IsServer())
 		{
@@ -1510,7 +1670,7 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 			return false;
 		}
 
-		if (!GrippedObjects.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
+		if (!GrippedObjects.Items.Find(Grip, FoundIndex)) // This auto checks if Actor and Component are valid in the == operator
 		{
 			UE_LOG(LogVRMotionController, Warning, TEXT("VRGripMotionController drop function was passed an invalid drop"));
 			return false;
@@ -1527,13 +1687,13 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 	AActor * pActor = nullptr;
 	if (bWasLocalGrip)
 	{
-		PrimComp = LocallyGrippedObjects[FoundIndex].GetGrippedComponent();
-		pActor = LocallyGrippedObjects[FoundIndex].GetGrippedActor();
+		PrimComp = LocallyGrippedObjects.Items[FoundIndex].GetGrippedComponent();
+		pActor = LocallyGrippedObjects.Items[FoundIndex].GetGrippedActor();
 	}
 	else
 	{
-		PrimComp = GrippedObjects[FoundIndex].GetGrippedComponent();
-		pActor = GrippedObjects[FoundIndex].GetGrippedActor();
+		PrimComp = GrippedObjects.Items[FoundIndex].GetGrippedComponent();
+		pActor = GrippedObjects.Items[FoundIndex].GetGrippedActor();
 	}
 
 	if (!PrimComp && pActor)
@@ -1563,18 +1723,18 @@ bool UGripMotionControllerComponent::DropGrip(const FBPActorGripInformation &Gri
 		if (GetNetMode() == ENetMode::NM_Client)
 		{
 			if(!IsTornOff())
-				Server_NotifyLocalGripRemoved(LocallyGrippedObjects[FoundIndex].GripID, OptionalAngularVelocity, OptionalLinearVelocity);
+				Server_NotifyLocalGripRemoved(LocallyGrippedObjects.Items[FoundIndex].GripID, OptionalAngularVelocity, OptionalLinearVelocity);
 
 			// Have to call this ourselves
-			Drop_Implementation(LocallyGrippedObjects[FoundIndex], bSimulate);
+			Drop_Implementation(LocallyGrippedObjects.Items[FoundIndex], bSimulate);
 		}
 		else // Server notifyDrop it
 		{
-			NotifyDrop(LocallyGrippedObjects[FoundIndex], bSimulate);
+			NotifyDrop(LocallyGrippedObjects.Items[FoundIndex], bSimulate);
 		}
 	}
 	else
-		NotifyDrop(GrippedObjects[FoundIndex], bSimulate);
+		NotifyDrop(GrippedObjects.Items[FoundIndex], bSimulate);
 
 	//GrippedObjects.RemoveAt(FoundIndex);		
 	return true;
@@ -1598,9 +1758,9 @@ bool UGripMotionControllerComponent::DropAndSocketObject(const FTransform_NetQua
 	FBPActorGripInformation * GripInfo = nullptr;
 
 	if (ObjectToDrop)
-		GripInfo = LocallyGrippedObjects.FindByKey(ObjectToDrop);
+		GripInfo = LocallyGrippedObjects.Items.FindByKey(ObjectToDrop);
 	else if (GripIDToDrop != INVALID_VRGRIP_ID)
-		GripInfo = LocallyGrippedObjects.FindByKey(GripIDToDrop);
+		GripInfo = LocallyGrippedObjects.Items.FindByKey(GripIDToDrop);
 
 	if(GripInfo) // This auto checks if Actor and Component are valid in the == operator
 	{
@@ -1615,9 +1775,9 @@ bool UGripMotionControllerComponent::DropAndSocketObject(const FTransform_NetQua
 		}
 
 		if(ObjectToDrop)
-			GripInfo = GrippedObjects.FindByKey(ObjectToDrop);
+			GripInfo = GrippedObjects.Items.FindByKey(ObjectToDrop);
 		else if(GripIDToDrop != INVALID_VRGRIP_ID)
-			GripInfo = GrippedObjects.FindByKey(GripIDToDrop);
+			GripInfo = GrippedObjects.Items.FindByKey(GripIDToDrop);
 
 		if(GripInfo) // This auto checks if Actor and Component are valid in the == operator
 		{
@@ -1647,7 +1807,7 @@ bool UGripMotionControllerComponent::DropAndSocketGrip(const FBPActorGripInforma
 	bool bWasLocalGrip = false;
 	FBPActorGripInformation * GripInfo = nullptr;
 
-	GripInfo = LocallyGrippedObjects.FindByKey(GripToDrop);
+	GripInfo = LocallyGrippedObjects.Items.FindByKey(GripToDrop);
 	if (GripInfo) // This auto checks if Actor and Component are valid in the == operator
 	{
 		bWasLocalGrip = true;
@@ -1660,7 +1820,7 @@ bool UGripMotionControllerComponent::DropAndSocketGrip(const FBPActorGripInforma
 			return false;
 		}
 
-		GripInfo = GrippedObjects.FindByKey(GripToDrop);
+		GripInfo = GrippedObjects.Items.FindByKey(GripToDrop);
 
 		if (GripInfo) // This auto checks if Actor and Component are valid in the == operator
 		{
@@ -1975,26 +2135,30 @@ void UGripMotionControllerComponent::DropAndSocket_Implementation(const FBPActor
 	FBPActorGripInformation DropBroadcastData = NewDrop;
 
 	int fIndex = 0;
-	if (LocallyGrippedObjects.Find(NewDrop, fIndex))
+	if (LocallyGrippedObjects.Items.Find(NewDrop, fIndex))
 	{
 		if (HasGripAuthority(NewDrop) || GetNetMode() < ENetMode::NM_Client)
 		{
-			LocallyGrippedObjects.RemoveAt(fIndex);
+			LocallyGrippedObjects.Items.RemoveAt(fIndex);
+			MarkGripIndexDirty();
+			LocallyGrippedObjects.MarkArrayDirty();
 		}
 		else
-			LocallyGrippedObjects[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
+			LocallyGrippedObjects.Items[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
 	}
 	else
 	{
 		fIndex = 0;
-		if (GrippedObjects.Find(NewDrop, fIndex))
+		if (GrippedObjects.Items.Find(NewDrop, fIndex))
 		{
 			if (HasGripAuthority(NewDrop) || GetNetMode() < ENetMode::NM_Client)
 			{
-				GrippedObjects.RemoveAt(fIndex);
+				GrippedObjects.Items.RemoveAt(fIndex);
+				MarkGripIndexDirty();
+				GrippedObjects.MarkArrayDirty();
 			}
 			else
-				GrippedObjects[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
+				GrippedObjects.Items[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
 		}
 	}
 
@@ -2006,6 +2170,9 @@ void UGripMotionControllerComponent::DropAndSocket_Implementation(const FBPActor
 // No longer an RPC, now is called from RepNotify so that joining clients also correctly set up grips
 bool UGripMotionControllerComponent::NotifyGrip(FBPActorGripInformation &NewGrip, bool bIsReInit)
 {
+	// Re-capture the interface answers on the next tick, a re-init can be from the object changing its settings
+	NewGrip.InterfaceCache.bIsValid = false;
+
 	UPrimitiveComponent *root = NULL;
 	AActor *pActor = NULL;
 
@@ -2247,6 +2414,10 @@ void UGripMotionControllerComponent::NotifyDrop_Implementation(const FBPActorGri
 		return;
 	}
 
+	// Let the removal from the replicated array know that this grip is already dropped
+	if (FBPActorGripInformation * GripInfo = FindGripByID(NewDrop.GripID))
+		GripInfo->ValueCache.bWasDropped = true;
+
 	Drop_Implementation(NewDrop, bSimulate);
 }
 
@@ -2268,16 +2439,16 @@ void UGripMotionControllerComponent::Drop_Implementation(const FBPActorGripInfor
 	}	
 	else // Now check for this same hand with duplicate grips on this object
 	{
-		for (int i = 0; i < LocallyGrippedObjects.Num(); ++i)
+		for (int i = 0; i < LocallyGrippedObjects.Items.Num(); ++i)
 		{
-			if (LocallyGrippedObjects[i].GrippedObject == NewDrop.GrippedObject && LocallyGrippedObjects[i].GripID != NewDrop.GripID)
+			if (LocallyGrippedObjects.Items[i].GrippedObject == NewDrop.GrippedObject && LocallyGrippedObjects.Items[i].GripID != NewDrop.GripID)
 			{
 				bSkipFullDrop = true;
 			}
 		}
-		for (int i = 0; i < GrippedObjects.Num(); ++i)
+		for (int i = 0; i < GrippedObjects.Items.Num(); ++i)
 		{
-			if (GrippedObjects[i].GrippedObject == NewDrop.GrippedObject && GrippedObjects[i].GripID != NewDrop.GripID)
+			if (GrippedObjects.Items[i].GrippedObject == NewDrop.GrippedObject && GrippedObjects.Items[i].GripID != NewDrop.GripID)
 			{
 				bSkipFullDrop = true;
 			}
@@ -2513,26 +2684,30 @@ void UGripMotionControllerComponent::Drop_Implementation(const FBPActorGripInfor
 	FBPActorGripInformation DropBroadcastData = NewDrop;
 
 	int fIndex = 0;
-	if (LocallyGrippedObjects.Find(NewDrop, fIndex))
+	if (LocallyGrippedObjects.Items.Find(NewDrop, fIndex))
 	{
 		if (HasGripAuthority(NewDrop) || GetNetMode() < ENetMode::NM_Client)
 		{
-			LocallyGrippedObjects.RemoveAt(fIndex);
+			LocallyGrippedObjects.Items.RemoveAt(fIndex);
+			MarkGripIndexDirty();
+			LocallyGrippedObjects.MarkArrayDirty();
 		}
 		else
-			LocallyGrippedObjects[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
+			LocallyGrippedObjects.Items[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
 	}
 	else
 	{
 		fIndex = 0;
-		if (GrippedObjects.Find(NewDrop, fIndex))
+		if (GrippedObjects.Items.Find(NewDrop, fIndex))
 		{
 			if (HasGripAuthority(NewDrop) || GetNetMode() < ENetMode::NM_Client)
 			{
-				GrippedObjects.RemoveAt(fIndex);
+				GrippedObjects.Items.RemoveAt(fIndex);
+				MarkGripIndexDirty();
+				GrippedObjects.MarkArrayDirty();
 			}
 			else
-				GrippedObjects[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
+				GrippedObjects.Items[fIndex].bIsPaused = true; // Pause it instead of dropping, dropping can corrupt the array in rare cases
 		}
 	}
 
@@ -2552,12 +2727,12 @@ bool UGripMotionControllerComponent::BP_HasGripMovementAuthority(const FBPActorG
 
 bool UGripMotionControllerComponent::AddSecondaryAttachmentPoint(UObject * GrippedObjectToAddAttachment, USceneComponent * SecondaryPointComponent, const FTransform & OriginalTransform, bool bTransformIsAlreadyRelative, float LerpToTime,/* float SecondarySmoothingScaler,*/ bool bIsSlotGrip)
 {
-	if (!GrippedObjectToAddAttachment || !SecondaryPointComponent || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!GrippedObjectToAddAttachment || !SecondaryPointComponent || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
 	FBPActorGripInformation * GripToUse = nullptr;
 
-	GripToUse = LocallyGrippedObjects.FindByKey(GrippedObjectToAddAttachment);
+	GripToUse = LocallyGrippedObjects.Items.FindByKey(GrippedObjectToAddAttachment);
 
 	// Search replicated grips if not found in local
 	if (!GripToUse)
@@ -2569,7 +2744,7 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentPoint(UObject * Gripp
 			return false;
 		}
 
-		GripToUse = GrippedObjects.FindByKey(GrippedObjectToAddAttachment);
+		GripToUse = GrippedObjects.Items.FindByKey(GrippedObjectToAddAttachment);
 	}
 
 	if (GripToUse)
@@ -2582,12 +2757,12 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentPoint(UObject * Gripp
 
 bool UGripMotionControllerComponent::AddSecondaryAttachmentToGrip(const FBPActorGripInformation & GripToAddAttachment, USceneComponent * SecondaryPointComponent, const FTransform &OriginalTransform, bool bTransformIsAlreadyRelative, float LerpToTime, bool bIsSlotGrip)
 {
-	if (!GripToAddAttachment.GrippedObject || GripToAddAttachment.GripID == INVALID_VRGRIP_ID || !SecondaryPointComponent || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!GripToAddAttachment.GrippedObject || GripToAddAttachment.GripID == INVALID_VRGRIP_ID || !SecondaryPointComponent || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
 	FBPActorGripInformation * GripToUse = nullptr;
 
-	GripToUse = LocallyGrippedObjects.FindByKey(GripToAddAttachment.GripID);
+	GripToUse = LocallyGrippedObjects.Items.FindByKey(GripToAddAttachment.GripID);
 
 	// Search replicated grips if not found in local
 	if (!GripToUse)
@@ -2599,7 +2774,7 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentToGrip(const FBPActor
 			return false;
 		}
 
-		GripToUse = GrippedObjects.FindByKey(GripToAddAttachment.GripID);
+		GripToUse = GrippedObjects.Items.FindByKey(GripToAddAttachment.GripID);
 	}
 
 	if (!GripToUse || !GripToUse->GrippedObject)
@@ -2659,6 +2834,7 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentToGrip(const FBPActor
 	GripToUse->AdvancedGripSettings.SecondaryGripSettings.SmoothingOneEuro.ResetSmoothingFilter();
 	//	GripToUse->SecondaryGripInfo.SecondarySmoothingScaler = FMath::Clamp(SecondarySmoothingScaler, 0.01f, 1.0f);
 	GripToUse->SecondaryGripInfo.bIsSlotGrip = bIsSlotGrip;
+	MarkGripDirty(*GripToUse);
 
 	if (GripToUse->SecondaryGripInfo.GripLerpState == EGripLerpState::EndLerp)
 		LerpToTime = 0.0f;
@@ -2699,13 +2875,13 @@ bool UGripMotionControllerComponent::AddSecondaryAttachmentToGrip(const FBPActor
 
 bool UGripMotionControllerComponent::RemoveSecondaryAttachmentPoint(UObject * GrippedObjectToRemoveAttachment, float LerpToTime)
 {
-	if (!GrippedObjectToRemoveAttachment || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!GrippedObjectToRemoveAttachment || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
 	FBPActorGripInformation * GripToUse = nullptr;
 
 	// Duplicating the logic for each array for now
-	GripToUse = LocallyGrippedObjects.FindByKey(GrippedObjectToRemoveAttachment);
+	GripToUse = LocallyGrippedObjects.Items.FindByKey(GrippedObjectToRemoveAttachment);
 
 	// Check replicated grips if it wasn't found in local
 	if (!GripToUse)
@@ -2716,7 +2892,7 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentPoint(UObject * Gr
 			return false;
 		}
 
-		GripToUse = GrippedObjects.FindByKey(GrippedObjectToRemoveAttachment);
+		GripToUse = GrippedObjects.Items.FindByKey(GrippedObjectToRemoveAttachment);
 	}
 
 	// Handle the grip if it was found
@@ -2730,13 +2906,13 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentPoint(UObject * Gr
 
 bool UGripMotionControllerComponent::RemoveSecondaryAttachmentFromGrip(const FBPActorGripInformation & GripToRemoveAttachment, float LerpToTime)
 {
-	if (!GripToRemoveAttachment.GrippedObject || GripToRemoveAttachment.GripID == INVALID_VRGRIP_ID || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!GripToRemoveAttachment.GrippedObject || GripToRemoveAttachment.GripID == INVALID_VRGRIP_ID || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
 	FBPActorGripInformation * GripToUse = nullptr;
 
 	// Duplicating the logic for each array for now
-	GripToUse = LocallyGrippedObjects.FindByKey(GripToRemoveAttachment.GripID);
+	GripToUse = LocallyGrippedObjects.Items.FindByKey(GripToRemoveAttachment.GripID);
 
 	// Check replicated grips if it wasn't found in local
 	if (!GripToUse)
@@ -2747,7 +2923,7 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentFromGrip(const FBP
 			return false;
 		}
 
-		GripToUse = GrippedObjects.FindByKey(GripToRemoveAttachment.GripID);
+		GripToUse = GrippedObjects.Items.FindByKey(GripToRemoveAttachment.GripID);
 	}
 
 	// Handle the grip if it was found
@@ -2838,6 +3014,7 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentFromGrip(const FBP
 
 		GripToUse->SecondaryGripInfo.SecondaryAttachment = nullptr;
 		GripToUse->SecondaryGripInfo.bHasSecondaryAttachment = false;
+		MarkGripDirty(*GripToUse);
 
 		if (GripToUse->GripMovementReplicationSetting == EGripMovementReplicationSettings::ClientSide_Authoritive && GetNetMode() == ENetMode::NM_Client)
 		{
@@ -2871,12 +3048,12 @@ bool UGripMotionControllerComponent::RemoveSecondaryAttachmentFromGrip(const FBP
 
 bool UGripMotionControllerComponent::TeleportMoveGrippedActor(AActor * GrippedActorToMove, bool bTeleportPhysicsGrips)
 {
-	if (!GrippedActorToMove || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!GrippedActorToMove || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
-	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.FindByKey(GrippedActorToMove);
+	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.Items.FindByKey(GrippedActorToMove);
 	if (!GripInfo)
-		GrippedObjects.FindByKey(GrippedActorToMove);
+		GrippedObjects.Items.FindByKey(GrippedActorToMove);
 
 	if (GripInfo)
 	{
@@ -2888,12 +3065,12 @@ bool UGripMotionControllerComponent::TeleportMoveGrippedActor(AActor * GrippedAc
 
 bool UGripMotionControllerComponent::TeleportMoveGrippedComponent(UPrimitiveComponent * ComponentToMove, bool bTeleportPhysicsGrips)
 {
-	if (!ComponentToMove || (!GrippedObjects.Num() && !LocallyGrippedObjects.Num()))
+	if (!ComponentToMove || (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num()))
 		return false;
 
-	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.FindByKey(ComponentToMove);
+	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.Items.FindByKey(ComponentToMove);
 	if (!GripInfo)
-		GrippedObjects.FindByKey(ComponentToMove);
+		GrippedObjects.Items.FindByKey(ComponentToMove);
 
 	if (GripInfo)
 	{
@@ -3088,18 +3265,18 @@ bool UGripMotionControllerComponent::TeleportMoveGrip_Impl(FBPActorGripInformati
 
 void UGripMotionControllerComponent::PostTeleportMoveGrippedObjects()
 {
-	if (!GrippedObjects.Num() && !LocallyGrippedObjects.Num())
+	if (!GrippedObjects.Items.Num() && !LocallyGrippedObjects.Items.Num())
 		return;
 
 	this->bIsPostTeleport = true;
-	/*for (int i = 0; i < LocallyGrippedObjects.Num(); i++)
+	/*for (int i = 0; i < LocallyGrippedObjects.Items.Num(); i++)
 	{
-		TeleportMoveGrip(LocallyGrippedObjects[i], true);
+		TeleportMoveGrip(LocallyGrippedObjects.Items[i], true);
 	}
 
-	for (int i = 0; i < GrippedObjects.Num(); i++)
+	for (int i = 0; i < GrippedObjects.Items.Num(); i++)
 	{
-		TeleportMoveGrip(GrippedObjects[i], true);
+		TeleportMoveGrip(GrippedObjects.Items[i], true);
 	}*/
 }
 
@@ -3213,7 +3390,16 @@ void UGripMotionControllerComponent::TickComponent(float DeltaTime, enum ELevelT
 	}
 	else
 	{
-		if (bLerpingPosition)
+		if (bLerpingPosition && ReplicatedMotionSmoothing == EVRReplicatedMotionSmoothing::Extrapolate)
+		{
+			FVector NewPosition;
+			FRotator NewRotation;
+
+			// Keeps going until it has settled on the last update, a new one restarts it
+			bLerpingPosition = MotionExtrapolator.Evaluate(GetWorld()->GetTimeSeconds(), MaxExtrapolationTime, NewPosition, NewRotation);
+			SetRelativeLocationAndRotation(NewPosition, NewRotation);
+		}
+		else if (bLerpingPosition)
 		{
 			ControllerNetUpdateCount += DeltaTime;
 			float LerpVal = FMath::Clamp(ControllerNetUpdateCount / (1.0f / ControllerNetUpdateRate), 0.0f, 1.0f);
@@ -3305,7 +3491,7 @@ void UGripMotionControllerComponent::TickGrip(float DeltaTime)
 	SCOPE_CYCLE_COUNTER(STAT_TickGrip);
 
 	// Debug test that we aren't floating physics handles
-	if (PhysicsGrips.Num() > (GrippedObjects.Num() + LocallyGrippedObjects.Num()))
+	if (PhysicsGrips.Num() > (GrippedObjects.Items.Num() + LocallyGrippedObjects.Items.Num()))
 	{
 		CleanUpBadPhysicsHandles();
 		UE_LOG(LogVRMotionController, Warning, TEXT("Something went wrong, there were too many physics handles for how many grips exist! Cleaned up bad handles."));
@@ -3314,9 +3500,14 @@ void UGripMotionControllerComponent::TickGrip(float DeltaTime)
 
 	FTransform ParentTransform = this->GetComponentTransform();
 
+	// The async sweeps queued last tick are consumed by the grips this tick
+	Swap(LastGripSweeps, QueuedGripSweeps);
+	QueuedGripSweeps.Reset();
+	AsyncGripSweepsThisFrame = 0;
+
 	// Split into separate functions so that I didn't have to combine arrays since I have some removal going on
-	HandleGripArray(GrippedObjects, ParentTransform, DeltaTime, true);
-	HandleGripArray(LocallyGrippedObjects, ParentTransform, DeltaTime);
+	HandleGripArray(GrippedObjects.Items, ParentTransform, DeltaTime, true);
+	HandleGripArray(LocallyGrippedObjects.Items, ParentTransform, DeltaTime);
 
 	// Empty out the teleport flag
 	bIsPostTeleport = false;
@@ -3328,6 +3519,9 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 	{
 		FTransform WorldTransform;
 
+		// Re-used for every grip so that resolving the cached scripts doesn't allocate
+		TArray<UVRGripScriptBase*> GripScripts;
+
 		for (int i = GrippedObjectsArray.Num() - 1; i >= 0; --i)
 		{
 			if (!HasGripMovementAuthority(GrippedObjectsArray[i]))
@@ -3378,20 +3572,15 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 				if (!root || !actor)
 					continue;
 
-				// Check if either implements the interface
-				bool bRootHasInterface = false;
-				bool bActorHasInterface = false;
-				
-				if (root->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
+				// Check if either implements the interface, only re-checked when the cache was invalidated or the root changed
+				if (!Grip->InterfaceCache.bIsValid || Grip->InterfaceCache.CachedRoot.Get() != root)
 				{
-					bRootHasInterface = true;
-				}
-				if (actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass()))
-				{
-					// Actor grip interface is checked after component
-					bActorHasInterface = true;
+					CacheGripInterface(*Grip, root, actor);
 				}
 
+				const bool bRootHasInterface = Grip->InterfaceCache.bRootHasInterface;
+				const bool bActorHasInterface = Grip->InterfaceCache.bActorHasInterface;
+
 				if (Grip->GripCollisionType == EGripCollisionType::CustomGrip)
 				{
 					// Don't perform logic on the movement for this object, just pass in the GripTick() event with the controller difference instead
@@ -3405,15 +3594,11 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 
 				bool bRescalePhysicsGrips = false;
 				
-				TArray<UVRGripScriptBase*> GripScripts;
+				GripScripts.Reset();
 
-				if (bRootHasInterface)
+				for (const TWeakObjectPtr<UVRGripScriptBase> & Script : Grip->InterfaceCache.GripScripts)
 				{
-					IVRGripInterface::Execute_GetGripScripts(root, GripScripts);
-				}
-				else if (bActorHasInterface)
-				{
-					IVRGripInterface::Execute_GetGripScripts(actor, GripScripts);
+					GripScripts.Add(Script.Get());
 				}
 
 
@@ -3427,12 +3612,7 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 				{
 					if (HasGripAuthority(*Grip))
 					{
-						if (bRootHasInterface)
-							DropGrip(*Grip, IVRGripInterface::Execute_SimulateOnDrop(root));
-						else if (bActorHasInterface)
-							DropGrip(*Grip, IVRGripInterface::Execute_SimulateOnDrop(actor));
-						else
-							DropGrip(*Grip, true);
+						DropGrip(*Grip, Grip->InterfaceCache.bSimulateOnDrop);
 					}
 
 					continue;
@@ -3473,16 +3653,7 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 					}
 					else
 					{
-						float BreakDistance = 0.0f;
-						if (bRootHasInterface)
-						{
-							BreakDistance = IVRGripInterface::Execute_GripBreakDistance(root);
-						}
-						else if (bActorHasInterface)
-						{
-							// Actor grip interface is checked after component
-							BreakDistance = IVRGripInterface::Execute_GripBreakDistance(actor);
-						}
+						float BreakDistance = Grip->InterfaceCache.GripBreakDistance;
 
 						FVector CheckDistance;
 						if (!GetPhysicsJointLength(*Grip, root, CheckDistance))
@@ -3528,10 +3699,7 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 								}
 								else if(HasGripAuthority(*Grip))
 								{
-									if(bRootHasInterface)
-										DropGrip(*Grip, IVRGripInterface::Execute_SimulateOnDrop(root));
-									else
-										DropGrip(*Grip, IVRGripInterface::Execute_SimulateOnDrop(actor));
+									DropGrip(*Grip, Grip->InterfaceCache.bSimulateOnDrop);
 
 									// Don't bother moving it, it is dropped now
 									continue;
@@ -3564,10 +3732,8 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 							Params.AddIgnoredActor(actor);
 							Params.AddIgnoredActors(root->MoveIgnoreActors);
 
-							TArray<FHitResult> Hits;
-							
 							// Switched over to component sweep because it picks up on pivot offsets without me manually calculating it
-							if (GetWorld()->ComponentSweepMulti(Hits, root, root->GetComponentLocation(), WorldTransform.GetLocation(), WorldTransform.GetRotation(), Params))
+							if (SweepGripForCollision(*Grip, root, WorldTransform, Params))
 							{
 								Grip->bColliding = true;
 							}
@@ -3628,10 +3794,9 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 						Params.AddIgnoredActor(actor);
 						Params.AddIgnoredActors(root->MoveIgnoreActors);
 
-						TArray<FHitResult> Hits;
 						// Checking both current and next position for overlap using this grip type
 						// Switched over to component sweep because it picks up on pivot offsets without me manually calculating it
-						if (GetWorld()->ComponentSweepMulti(Hits, root, root->GetComponentLocation(), WorldTransform.GetLocation(), WorldTransform.GetRotation(), Params))
+						if (SweepGripForCollision(*Grip, root, WorldTransform, Params))
 						{
 							if (!Grip->bColliding)
 							{
@@ -3657,13 +3822,12 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 						// Make sure that there is no collision on course before turning off collision and snapping to controller
 						FBPActorPhysicsHandleInformation * GripHandle = GetPhysicsGrip(*Grip);
 
-						TArray<FHitResult> Hits;
 						FComponentQueryParams Params(NAME_None, this->GetOwner());
 						Params.bTraceAsyncScene = root->bCheckAsyncSceneOnMove;
 						Params.AddIgnoredActor(actor);
 						Params.AddIgnoredActors(root->MoveIgnoreActors);
 
-						if (GetWorld()->ComponentSweepMulti(Hits, root, root->GetComponentLocation(), WorldTransform.GetLocation(), WorldTransform.GetRotation(), Params))
+						if (SweepGripForCollision(*Grip, root, WorldTransform, Params))
 						{
 							Grip->bColliding = true;
 						}
@@ -3734,7 +3898,20 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 							// ComponentSweepMulti does nothing if moving < KINDA_SMALL_NUMBER in distance, so it's important to not try to sweep distances smaller than that. 
 							const float MinMovementDistSq = (FMath::Square(4.f*KINDA_SMALL_NUMBER));
 
-							if (bUseWithoutTracking || move.SizeSquared() > MinMovementDistSq || NewOrientation != OriginalOrientation)
+							if (bUseAsyncGripSweeps)
+							{
+								FComponentQueryParams Params(TEXT("sweep_params"), root->GetOwner());
+								FCollisionResponseParams ResponseParam;
+								root->InitSweepCollisionParams(Params, ResponseParam);
+								Params.AddIgnoredActor(this->GetOwner());
+
+								FHitResult BlockingHit;
+								Grip->bColliding = SweepGripForCollision(*Grip, root, WorldTransform, Params, &BlockingHit);
+
+								if (BlockingHit.bBlockingHit && root->GetOwner())
+									root->DispatchBlockingHit(*root->GetOwner(), BlockingHit);
+							}
+							else if (bUseWithoutTracking || move.SizeSquared() > MinMovementDistSq || NewOrientation != OriginalOrientation)
 							{
 								if (CheckComponentWithSweep(root, move, OriginalOrientation, false))
 								{
@@ -3815,6 +3992,50 @@ void UGripMotionControllerComponent::HandleGripArray(TArray<FBPActorGripInformat
 }
 
 
+void UGripMotionControllerComponent::CacheGripInterface(FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor)
+{
+	FBPActorGripInformation::FGripInterfaceCache & Cache = Grip.InterfaceCache;
+	Cache = FBPActorGripInformation::FGripInterfaceCache();
+
+	Cache.bIsValid = true;
+	Cache.CachedRoot = root;
+	Cache.bRootHasInterface = root && root->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass());
+	Cache.bActorHasInterface = actor && actor->GetClass()->ImplementsInterface(UVRGripInterface::StaticClass());
+
+	// Actor grip interface is checked after component
+	UObject * InterfaceObject = Cache.bRootHasInterface ? (UObject*)root : (Cache.bActorHasInterface ? (UObject*)actor : nullptr);
+
+	if (!InterfaceObject)
+		return;
+
+	Cache.bSimulateOnDrop = IVRGripInterface::Execute_SimulateOnDrop(InterfaceObject);
+	Cache.GripBreakDistance = IVRGripInterface::Execute_GripBreakDistance(InterfaceObject);
+	Cache.SecondaryGripType = IVRGripInterface::Execute_SecondaryGripType(InterfaceObject);
+
+	TArray<UVRGripScriptBase*> GripScripts;
+	IVRGripInterface::Execute_GetGripScripts(InterfaceObject, GripScripts);
+
+	for (UVRGripScriptBase* Script : GripScripts)
+	{
+		Cache.GripScripts.Add(Script);
+	}
+}
+
+void UGripMotionControllerComponent::InvalidateGripInterfaceCache(UObject * ObjectToRefresh)
+{
+	for (FBPActorGripInformation & Grip : GrippedObjects.Items)
+	{
+		if (!ObjectToRefresh || Grip.GrippedObject == ObjectToRefresh)
+			Grip.InterfaceCache.bIsValid = false;
+	}
+
+	for (FBPActorGripInformation & Grip : LocallyGrippedObjects.Items)
+	{
+		if (!ObjectToRefresh || Grip.GrippedObject == ObjectToRefresh)
+			Grip.InterfaceCache.bIsValid = false;
+	}
+}
+
 void UGripMotionControllerComponent::CleanUpBadGrip(TArray<FBPActorGripInformation> &GrippedObjectsArray, int GripIndex, bool bReplicatedArray)
 {
 	// Object has been destroyed without notification to plugin
@@ -3832,6 +4053,9 @@ void UGripMotionControllerComponent::CleanUpBadGrip(TArray<FBPActorGripInformati
 		}
 	}
 
+	// The object may have been garbage collected out from under the index
+	MarkGripIndexDirty();
+
 	if (HasGripAuthority(GrippedObjectsArray[GripIndex]))
 	{
 		DropGrip(GrippedObjectsArray[GripIndex], false);
@@ -3848,9 +4072,9 @@ void UGripMotionControllerComponent::CleanUpBadPhysicsHandles()
 	// Clean up tailing physics handles with null objects
 	for (int g = PhysicsGrips.Num() - 1; g >= 0; --g)
 	{
-		FBPActorGripInformation * GripInfo = LocallyGrippedObjects.FindByKey(PhysicsGrips[g].GripID);
+		FBPActorGripInformation * GripInfo = LocallyGrippedObjects.Items.FindByKey(PhysicsGrips[g].GripID);
 		if(!GripInfo)
-			GrippedObjects.FindByKey(PhysicsGrips[g].GripID);
+			GrippedObjects.Items.FindByKey(PhysicsGrips[g].GripID);
 
 		if (!GripInfo)
 		{
@@ -4367,6 +4591,68 @@ static void PullBackHitComp(FHitResult& Hit, const FVector& Start, const FVector
 	Hit.Time = FMath::Clamp(Hit.Time - DesiredTimeBack, 0.f, 1.f);
 }
 
+bool UGripMotionControllerComponent::SweepGripForCollision(FBPActorGripInformation & Grip, UPrimitiveComponent * root, const FTransform & WorldTransform, const FComponentQueryParams & Params, FHitResult * OutBlockingHit)
+{
+	UWorld * World = GetWorld();
+
+	if (!bUseAsyncGripSweeps)
+	{
+		TArray<FHitResult> Hits;
+		return World->ComponentSweepMulti(Hits, root, root->GetComponentLocation(), WorldTransform.GetLocation(), WorldTransform.GetRotation(), Params);
+	}
+
+	// Keep the last known state if there is no result for this grip yet
+	bool bColliding = Grip.bColliding;
+
+	if (const FTraceHandle * LastHandle = LastGripSweeps.Find(Grip.GripID))
+	{
+		FTraceDatum SweepData;
+		if (World->QueryTraceData(*LastHandle, SweepData))
+		{
+			const FHitResult * BlockingHit = SweepData.OutHits.FindByPredicate([](const FHitResult & Hit) { return Hit.bBlockingHit; });
+			bColliding = BlockingHit != nullptr;
+
+			if (BlockingHit && OutBlockingHit)
+				*OutBlockingHit = *BlockingHit;
+		}
+	}
+
+	if (MaxAsyncGripSweepsPerFrame > 0 && AsyncGripSweepsThisFrame >= MaxAsyncGripSweepsPerFrame)
+	{
+		INC_DWORD_STAT(STAT_GripSweepsOverBudget);
+		return bColliding;
+	}
+
+	// Async queries can't sweep the component geometry, shape components sweep their own shape and
+	// everything else sweeps a box of its local bounds, oriented like the sync sweep with the target rotation
+	FCollisionShape Shape;
+	FVector LocalOrigin = FVector::ZeroVector;
+
+	if (root->IsA<UShapeComponent>())
+	{
+		Shape = root->GetCollisionShape();
+	}
+	else
+	{
+		const FBoxSphereBounds LocalBounds = root->CalcBounds(FTransform::Identity);
+		LocalOrigin = LocalBounds.Origin;
+		Shape = FCollisionShape::MakeBox(LocalBounds.BoxExtent * WorldTransform.GetScale3D().GetAbs());
+	}
+
+	const FVector Start = root->GetComponentTransform().TransformPosition(LocalOrigin);
+	const FVector End = WorldTransform.TransformPosition(LocalOrigin);
+	const FQuat ShapeRotation = WorldTransform.GetRotation();
+
+	FCollisionQueryParams AsyncParams = Params;
+	AsyncParams.AddIgnoredComponent(root);
+
+	QueuedGripSweeps.Add(Grip.GripID, World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, ShapeRotation, root->GetCollisionObjectType(), Shape, AsyncParams, FCollisionResponseParams(root->GetCollisionResponseToChannels())));
+	++AsyncGripSweepsThisFrame;
+	INC_DWORD_STAT(STAT_GripSweepsAsyncQueued);
+
+	return bColliding;
+}
+
 bool UGripMotionControllerComponent::CheckComponentWithSweep(UPrimitiveComponent * ComponentToCheck, FVector Move, FRotator newOrientation, bool bSkipSimulatingComponents/*,  bool &bHadBlockingHitOut*/)
 {
 	TArray<FHitResult> Hits;
@@ -4655,54 +4941,54 @@ bool UGripMotionControllerComponent::FGripViewExtension::IsActiveThisFrame(class
 
 void UGripMotionControllerComponent::GetAllGrips(TArray<FBPActorGripInformation> &GripArray)
 {
-	GripArray.Append(GrippedObjects);
-	GripArray.Append(LocallyGrippedObjects);
+	GripArray.Append(GrippedObjects.Items);
+	GripArray.Append(LocallyGrippedObjects.Items);
 }
 
 void UGripMotionControllerComponent::GetGrippedObjects(TArray<UObject*> &GrippedObjectsArray)
 {
-	for (int i = 0; i < GrippedObjects.Num(); ++i)
+	for (int i = 0; i < GrippedObjects.Items.Num(); ++i)
 	{
-		if (GrippedObjects[i].GrippedObject)
-			GrippedObjectsArray.Add(GrippedObjects[i].GrippedObject);
+		if (GrippedObjects.Items[i].GrippedObject)
+			GrippedObjectsArray.Add(GrippedObjects.Items[i].GrippedObject);
 	}
 
-	for (int i = 0; i < LocallyGrippedObjects.Num(); ++i)
+	for (int i = 0; i < LocallyGrippedObjects.Items.Num(); ++i)
 	{
-		if (LocallyGrippedObjects[i].GrippedObject)
-			GrippedObjectsArray.Add(LocallyGrippedObjects[i].GrippedObject);
+		if (LocallyGrippedObjects.Items[i].GrippedObject)
+			GrippedObjectsArray.Add(LocallyGrippedObjects.Items[i].GrippedObject);
 	}
 
 }
 
 void UGripMotionControllerComponent::GetGrippedActors(TArray<AActor*> &GrippedObjectsArray)
 {
-	for (int i = 0; i < GrippedObjects.Num(); ++i)
+	for (int i = 0; i < GrippedObjects.Items.Num(); ++i)
 	{
-		if(GrippedObjects[i].GetGrippedActor())
-			GrippedObjectsArray.Add(GrippedObjects[i].GetGrippedActor());
+		if(GrippedObjects.Items[i].GetGrippedActor())
+			GrippedObjectsArray.Add(GrippedObjects.Items[i].GetGrippedActor());
 	}
 
-	for (int i = 0; i < LocallyGrippedObjects.Num(); ++i)
+	for (int i = 0; i < LocallyGrippedObjects.Items.Num(); ++i)
 	{
-		if (LocallyGrippedObjects[i].GetGrippedActor())
-			GrippedObjectsArray.Add(LocallyGrippedObjects[i].GetGrippedActor());
+		if (LocallyGrippedObjects.Items[i].GetGrippedActor())
+			GrippedObjectsArray.Add(LocallyGrippedObjects.Items[i].GetGrippedActor());
 	}
 
 }
 
 void UGripMotionControllerComponent::GetGrippedComponents(TArray<UPrimitiveComponent*> &GrippedComponentsArray)
 {
-	for (int i = 0; i < GrippedObjects.Num(); ++i)
+	for (int i = 0; i < GrippedObjects.Items.Num(); ++i)
 	{
-		if (GrippedObjects[i].GetGrippedComponent())
-			GrippedComponentsArray.Add(GrippedObjects[i].GetGrippedComponent());
+		if (GrippedObjects.Items[i].GetGrippedComponent())
+			GrippedComponentsArray.Add(GrippedObjects.Items[i].GetGrippedComponent());
 	}
 
-	for (int i = 0; i < LocallyGrippedObjects.Num(); ++i)
+	for (int i = 0; i < LocallyGrippedObjects.Items.Num(); ++i)
 	{
-		if (LocallyGrippedObjects[i].GetGrippedComponent())
-			GrippedComponentsArray.Add(LocallyGrippedObjects[i].GetGrippedComponent());
+		if (LocallyGrippedObjects.Items[i].GetGrippedComponent())
+			GrippedComponentsArray.Add(LocallyGrippedObjects.Items[i].GetGrippedComponent());
 	}
 }
 
@@ -4739,21 +5025,25 @@ void UGripMotionControllerComponent::Server_NotifyLocalGripAddedOrChanged_Implem
 		return;
 	}
 
-	if (!LocallyGrippedObjects.Contains(newGrip))
+	if (!LocallyGrippedObjects.Items.Contains(newGrip))
 	{
-		int32 NewIndex = LocallyGrippedObjects.Add(newGrip);
+		int32 NewIndex = LocallyGrippedObjects.Items.Add(newGrip);
+		MarkGripIndexDirty();
+		LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[NewIndex]);
 
-		HandleGripReplication(LocallyGrippedObjects[NewIndex]);
+		HandleGripReplication(LocallyGrippedObjects.Items[NewIndex]);
 		// Initialize the differences, clients will do this themselves on the rep back, this sets up the cache
 		//HandleGripReplication(LocallyGrippedObjects[LocallyGrippedObjects.Num() - 1]);
 	}
 	else
 	{
 		int32 IndexFound;
-		if (LocallyGrippedObjects.Find(newGrip, IndexFound))
+		if (LocallyGrippedObjects.Items.Find(newGrip, IndexFound))
 		{
-			LocallyGrippedObjects[IndexFound].RepCopy(newGrip);
-			HandleGripReplication(LocallyGrippedObjects[IndexFound]);
+			LocallyGrippedObjects.Items[IndexFound].RepCopy(newGrip);
+			MarkGripIndexDirty();
+			LocallyGrippedObjects.MarkItemDirty(LocallyGrippedObjects.Items[IndexFound]);
+			HandleGripReplication(LocallyGrippedObjects.Items[IndexFound]);
 		}
 	}
 
@@ -4795,11 +5085,12 @@ void UGripMotionControllerComponent::Server_NotifySecondaryAttachmentChanged_Imp
 	const FBPSecondaryGripInfo& SecondaryGripInfo)
 {
 
-	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.FindByKey(GripID);
+	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.Items.FindByKey(GripID);
 	if (GripInfo != nullptr)
 	{
 		// I override the = operator now so that it won't set the lerp components
 		GripInfo->SecondaryGripInfo.RepCopy(SecondaryGripInfo);
+		MarkGripDirty(*GripInfo);
 
 		// Initialize the differences, clients will do this themselves on the rep back
 		HandleGripReplication(*GripInfo);
@@ -4819,12 +5110,13 @@ void UGripMotionControllerComponent::Server_NotifySecondaryAttachmentChanged_Ret
 	const FBPSecondaryGripInfo& SecondaryGripInfo, const FTransform_NetQuantize & NewRelativeTransform)
 {
 
-	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.FindByKey(GripID);
+	FBPActorGripInformation * GripInfo = LocallyGrippedObjects.Items.FindByKey(GripID);
 	if (GripInfo != nullptr)
 	{
 		// I override the = operator now so that it won't set the lerp components
 		GripInfo->SecondaryGripInfo.RepCopy(SecondaryGripInfo);
 		GripInfo->RelativeTransform = NewRelativeTransform;
+		MarkGripDirty(*GripInfo);
 
 		// Initialize the differences, clients will do this themselves on the rep back
 		HandleGripReplication(*GripInfo);
@@ -4871,6 +5163,8 @@ void UGripMotionControllerComponent::GetControllerDeviceID(FXRDeviceId & DeviceI
 FExpandedLateUpdateManager::FExpandedLateUpdateManager()
 	: LateUpdateGameWriteIndex(0)
 	, LateUpdateRenderReadIndex(0)
+	, SetupCount(0)
+	, bUseHierarchyCache(true)
 {
 	SkipLateUpdate[0] = false;
 	SkipLateUpdate[1] = false;
@@ -4883,9 +5177,14 @@ void FExpandedLateUpdateManager::Setup(const FTransform& ParentToWorld, UGripMot
 
 	check(IsInGameThread());
 
+	SCOPE_CYCLE_COUNTER(STAT_LateUpdateSetup);
+
+	bUseHierarchyCache = GripMotionControllerCvars::CacheLateUpdatePrimitives > 0;
+	++SetupCount;
+
 	LateUpdateParentToWorld[LateUpdateGameWriteIndex] = ParentToWorld;
 	LateUpdatePrimitives[LateUpdateGameWriteIndex].Reset();
-	GatherLateUpdatePrimitives(Component);
+	GatherCachedLateUpdatePrimitives(Component);
 	SkipLateUpdate[LateUpdateGameWriteIndex] = bSkipLateUpdate;
 
 	//Add additional late updates registered to this controller that aren't children and aren't gripped
@@ -4894,12 +5193,19 @@ void FExpandedLateUpdateManager::Setup(const FTransform& ParentToWorld, UGripMot
 	for (UPrimitiveComponent* primComp : Component->AdditionalLateUpdateComponents)
 	{
 		if (primComp)
-			GatherLateUpdatePrimitives(primComp);
+			GatherCachedLateUpdatePrimitives(primComp);
 	}
 
 
-	ProcessGripArrayLateUpdatePrimitives(Component, Component->LocallyGrippedObjects);
-	ProcessGripArrayLateUpdatePrimitives(Component, Component->GrippedObjects);
+	ProcessGripArrayLateUpdatePrimitives(Component, Component->LocallyGrippedObjects.Items);
+	ProcessGripArrayLateUpdatePrimitives(Component, Component->GrippedObjects.Items);
+
+	// Drop the hierarchies of released objects and removed components
+	const uint32 CurrentSetup = SetupCount;
+	CachedHierarchies.RemoveAll([CurrentSetup](const FLateUpdateHierarchy & Hierarchy)
+	{
+		return Hierarchy.LastUsedSetup != CurrentSetup;
+	});
 
 	LateUpdateGameWriteIndex = (LateUpdateGameWriteIndex + 1) % 2;
 }
@@ -4979,10 +5285,127 @@ void FExpandedLateUpdateManager::GatherLateUpdatePrimitives(USceneComponent* Par
 	}
 }
 
-void FExpandedLateUpdateManager::ProcessGripArrayLateUpdatePrimitives(UGripMotionControllerComponent * MotionControllerComponent, TArray<FBPActorGripInformation> & GripArray)
+void FExpandedLateUpdateManager::GatherCachedLateUpdatePrimitives(USceneComponent* ParentComponent)
 {
-	for (FBPActorGripInformation actor : GripArray)
+	if (!bUseHierarchyCache)
 	{
+		GatherLateUpdatePrimitives(ParentComponent);
+		return;
+	}
+
+	GatherCachedLateUpdatePrimitives(CachedHierarchies[FindOrAddHierarchy(ParentComponent)]);
+}
+
+void FExpandedLateUpdateManager::GatherCachedLateUpdatePrimitives(FLateUpdateHierarchy & Hierarchy)
+{
+	if (!IsHierarchyValid(Hierarchy))
+	{
+		BuildHierarchy(Hierarchy);
+		INC_DWORD_STAT(STAT_LateUpdateHierarchyRebuilds);
+	}
+
+	for (const FLateUpdateHierarchy::FNode & Node : Hierarchy.Nodes)
+	{
+		CacheSceneInfo(Node.Component.Get());
+	}
+}
+
+int32 FExpandedLateUpdateManager::FindOrAddHierarchy(USceneComponent* RootComponent)
+{
+	for (int32 i = 0; i < CachedHierarchies.Num(); ++i)
+	{
+		if (CachedHierarchies[i].Root.Get() == RootComponent)
+		{
+			CachedHierarchies[i].LastUsedSetup = SetupCount;
+			return i;
+		}
+	}
+
+	int32 Index = CachedHierarchies.AddDefaulted();
+	CachedHierarchies[Index].Root = RootComponent;
+	CachedHierarchies[Index].LastUsedSetup = SetupCount;
+	return Index;
+}
+
+void FExpandedLateUpdateManager::BuildHierarchy(FLateUpdateHierarchy & Hierarchy)
+{
+	Hierarchy.Nodes.Reset();
+
+	USceneComponent* RootComponent = Hierarchy.Root.Get();
+	if (!RootComponent)
+		return;
+
+	// Depth first, the same set of components as GetChildrenComponents(true) without allocating a list for every level
+	TArray<USceneComponent*, TInlineAllocator<16>> Stack;
+	Stack.Add(RootComponent);
+
+	while (Stack.Num())
+	{
+		USceneComponent* Component = Stack.Pop(false);
+
+		FLateUpdateHierarchy::FNode Node;
+		Node.Component = Component;
+		Node.AttachParent = Component->GetAttachParent();
+		Node.NumAttachChildren = Component->GetAttachChildren().Num();
+		Hierarchy.Nodes.Add(Node);
+
+		for (USceneComponent* Child : Component->GetAttachChildren())
+		{
+			if (Child != nullptr)
+				Stack.Add(Child);
+		}
+	}
+}
+
+bool FExpandedLateUpdateManager::IsHierarchyValid(const FLateUpdateHierarchy & Hierarchy)
+{
+	if (!Hierarchy.Nodes.Num())
+		return false;
+
+	for (int32 i = 0; i < Hierarchy.Nodes.Num(); ++i)
+	{
+		const FLateUpdateHierarchy::FNode & Node = Hierarchy.Nodes[i];
+		const USceneComponent* Component = Node.Component.Get();
+
+		if (!Component || Component->GetAttachChildren().Num() != Node.NumAttachChildren)
+			return false;
+
+		// The root can move around freely, everything under it has to still be attached where it was
+		if (i > 0 && Component->GetAttachParent() != Node.AttachParent)
+			return false;
+	}
+
+	return true;
+}
+
+void FExpandedLateUpdateManager::ProcessGripArrayLateUpdatePrimitives(UGripMotionControllerComponent * MotionControllerComponent, const TArray<FBPActorGripInformation> & GripArray)
+{
+	for (const FBPActorGripInformation & actor : GripArray)
+	{
+		// Resolve the late update root first so that grips which are skipped this frame keep their cached hierarchy
+		USceneComponent * rootComponent = nullptr;
+
+		switch (actor.GripTargetType)
+		{
+		case EGripTargetType::ActorGrip:
+			//case EGripTargetType::InteractibleActorGrip:
+		{
+			if (AActor * pActor = actor.GetGrippedActor())
+				rootComponent = pActor->GetRootComponent();
+		}break;
+
+		case EGripTargetType::ComponentGrip:
+			//case EGripTargetType::InteractibleComponentGrip:
+		{
+			rootComponent = actor.GetGrippedComponent();
+		}break;
+		}
+
+		if (!rootComponent)
+			continue;
+
+		int32 HierarchyIndex = bUseHierarchyCache ? FindOrAddHierarchy(rootComponent) : INDEX_NONE;
+
 		// Skip actors that are colliding if turning off late updates during collision.
 		// Also skip turning off late updates for SweepWithPhysics, as it should always be locked to the hand
 
@@ -5031,31 +5454,9 @@ void FExpandedLateUpdateManager::ProcessGripArrayLateUpdatePrimitives(UGripMotio
 		}
 
 		// Get late update primitives
-		switch (actor.GripTargetType)
-		{
-		case EGripTargetType::ActorGrip:
-			//case EGripTargetType::InteractibleActorGrip:
-		{
-			AActor * pActor = actor.GetGrippedActor();
-			if (pActor)
-			{
-				if (USceneComponent * rootComponent = pActor->GetRootComponent())
-				{
-					GatherLateUpdatePrimitives(rootComponent);
-				}
-			}
-
-		}break;
-
-		case EGripTargetType::ComponentGrip:
-			//case EGripTargetType::InteractibleComponentGrip:
-		{
-			UPrimitiveComponent * cPrimComp = actor.GetGrippedComponent();
-			if (cPrimComp)
-			{
-				GatherLateUpdatePrimitives(cPrimComp);
-			}
-		}break;
-		}
+		if (HierarchyIndex != INDEX_NONE)
+			GatherCachedLateUpdatePrimitives(CachedHierarchies[HierarchyIndex]);
+		else
+			GatherLateUpdatePrimitives(rootComponent);
 	}
 }
\ No newline at end of file
@@ -67,7 +67,9 @@ bool UGS_Default::GetWorldTransform_Implementation
 		// Checking secondary grip type for the scaling setting
 		ESecondaryGripType SecondaryType = ESecondaryGripType::SG_None;
 
-		if (bRootHasInterface)
+		if (Grip.InterfaceCache.bIsValid)
+			SecondaryType = Grip.InterfaceCache.SecondaryGripType;
+		else if (bRootHasInterface)
 			SecondaryType = IVRGripInterface::Execute_SecondaryGripType(root);
 		else if (bActorHasInterface)
 			SecondaryType = IVRGripInterface::Execute_SecondaryGripType(actor);
@@ -29,6 +29,10 @@ UReplicatedVRCameraComponent::UReplicatedVRCameraComponent(const FObjectInitiali
 
 	bSetPositionDuringTick = false;
 	bSmoothReplicatedMotion = false;
+	ReplicatedMotionSmoothing = EVRReplicatedMotionSmoothing::Lerp;
+	MaxExtrapolationTime = 0.1f;
+	ExtrapolationSnapDistance = 50.0f;
+	ExtrapolationSnapAngle = 60.0f;
 	bLerpingPosition = false;
 	bReppedOnce = false;
 
@@ -78,6 +82,25 @@ void UReplicatedVRCameraComponent::Server_SendCameraTransform_Implementation(FBP
 	}
 }
 
+void UReplicatedVRCameraComponent::AddReplicatedMotionSample()
+{
+	const UWorld * MyWorld = GetWorld();
+	const float UpdateInterval = NetUpdateRate > 0.0f ? 1.0f / NetUpdateRate : 0.0f;
+
+	if (MotionExtrapolator.AddSample(ReplicatedCameraTransform, this->RelativeLocation, this->RelativeRotation, MyWorld ? MyWorld->GetTimeSeconds() : 0.0f, UpdateInterval, MaxExtrapolationTime, ExtrapolationSnapDistance, ExtrapolationSnapAngle))
+	{
+		SetRelativeLocationAndRotation(ReplicatedCameraTransform.Position, ReplicatedCameraTransform.Rotation);
+	}
+
+	// Keeps the lerp mode consistent if it gets switched back at runtime
+	LastUpdatesRelativePosition = this->RelativeLocation;
+	LastUpdatesRelativeRotation = this->RelativeRotation;
+	NetUpdateCount = 0.0f;
+
+	bLerpingPosition = true;
+	bReppedOnce = true;
+}
+
 bool UReplicatedVRCameraComponent::Server_SendCameraTransform_Validate(FBPVRComponentPosRep NewTransform)
 {
 	return true;
@@ -167,7 +190,16 @@ void UReplicatedVRCameraComponent::TickComponent(float DeltaTime, enum ELevelTic
 	}
 	else
 	{
-		if (bLerpingPosition)
+		if (bLerpingPosition && ReplicatedMotionSmoothing == EVRReplicatedMotionSmoothing::Extrapolate)
+		{
+			FVector NewPosition;
+			FRotator NewRotation;
+
+			// Keeps going until it has settled on the last update, a new one restarts it
+			bLerpingPosition = MotionExtrapolator.Evaluate(GetWorld()->GetTimeSeconds(), MaxExtrapolationTime, NewPosition, NewRotation);
+			SetRelativeLocationAndRotation(NewPosition, NewRotation);
+		}
+		else if (bLerpingPosition)
 		{
 			NetUpdateCount += DeltaTime;
 			float LerpVal = FMath::Clamp(NetUpdateCount / (1.0f / NetUpdateRate), 0.0f, 1.0f);
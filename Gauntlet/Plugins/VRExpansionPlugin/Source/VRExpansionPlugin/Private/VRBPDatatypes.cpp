@@ -1,6 +1,11 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "VRBPDataTypes.h"
+#include "GripMotionControllerComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("GripArray ~ NetDeltaSerialize"), STAT_GripArrayNetDeltaSerialize, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GripArray ~ Bytes Sent"), STAT_GripArrayBytesSent, STATGROUP_TickGrip);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GripArray ~ Bytes Received"), STAT_GripArrayBytesReceived, STATGROUP_TickGrip);
 
 namespace VRDataTypeCVARs
 {
@@ -89,4 +94,147 @@ bool FTransform_NetQuantize::NetSerialize(FArchive& Ar, class UPackageMap* Map,
 	}
 
 	return bOutSuccess;
-}
\ No newline at end of file
+}
+
+bool FBPGripArray::NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GripArrayNetDeltaSerialize);
+
+	// Sizes only, the net profiler breaks it down further by property
+	const int64 StartBits = DeltaParms.Writer ? DeltaParms.Writer->GetNumBits() : (DeltaParms.Reader ? DeltaParms.Reader->GetPosBits() : 0);
+
+	bool bSuccess = FFastArraySerializer::FastArrayDeltaSerialize<FBPActorGripInformation, FBPGripArray>(Items, DeltaParms, *this);
+
+	if (DeltaParms.Writer)
+	{
+		INC_DWORD_STAT_BY(STAT_GripArrayBytesSent, (DeltaParms.Writer->GetNumBits() - StartBits + 7) / 8);
+	}
+	else if (DeltaParms.Reader)
+	{
+		INC_DWORD_STAT_BY(STAT_GripArrayBytesReceived, (DeltaParms.Reader->GetPosBits() - StartBits + 7) / 8);
+	}
+
+	return bSuccess;
+}
+
+void FBPActorGripInformation::PreReplicatedRemove(const FBPGripArray & InArraySerializer)
+{
+	if (InArraySerializer.OwningController)
+		InArraySerializer.OwningController->HandleGripRemovalReplication(*this);
+}
+
+void FBPActorGripInformation::PostReplicatedAdd(const FBPGripArray & InArraySerializer)
+{
+	if (InArraySerializer.OwningController)
+	{
+		InArraySerializer.OwningController->MarkGripIndexDirty();
+		InArraySerializer.OwningController->HandleGripReplication(*this);
+	}
+}
+
+void FBPActorGripInformation::PostReplicatedChange(const FBPGripArray & InArraySerializer)
+{
+	if (InArraySerializer.OwningController)
+		InArraySerializer.OwningController->HandleGripReplication(*this);
+}
+
+bool FVRReplicatedMotionExtrapolator::AddSample(const FBPVRComponentPosRep & Update, const FVector & CurrentPosition, const FRotator & CurrentRotation, float CurrentTime, float UpdateInterval, float MaxExtrapolationTime, float SnapDistance, float SnapAngle)
+{
+	const FVector NewPosition = Update.Position;
+	const FQuat NewRotation = Update.Rotation.Quaternion();
+
+	bool bSnap = !bHasSample;
+
+	if (bHasSample)
+	{
+		// Receive times jitter, don't let two updates arriving in the same frame blow up the velocity
+		const float SampleDelta = FMath::Max3(CurrentTime - SampleTime, UpdateInterval * 0.5f, KINDA_SMALL_NUMBER);
+
+		FQuat DeltaRotation = NewRotation * SampleRotation.Inverse();
+		if (DeltaRotation.W < 0.0f)
+			DeltaRotation = DeltaRotation * -1.0f;
+
+		FVector Axis;
+		float Angle;
+		DeltaRotation.ToAxisAndAngle(Axis, Angle);
+
+		if (CurrentTime - SampleTime > FMath::Max(MaxExtrapolationTime, BlendDuration))
+		{
+			// Evaluate has stopped extrapolating and settled on the last update, so the display is at rest. The gap since
+			// then says nothing about the current motion, start the estimate over like after the first update.
+			BlendStartVelocity = FVector::ZeroVector;
+			LinearVelocity = FVector::ZeroVector;
+			AngularVelocity = FVector::ZeroVector;
+		}
+		else
+		{
+			// The displayed transform was already moving at the old estimate, starting the hermite blend with it keeps that continuous
+			BlendStartVelocity = LinearVelocity;
+
+			// Average with the previous estimate, single updates are too noisy to extrapolate from on their own
+			LinearVelocity = FMath::Lerp(LinearVelocity, (NewPosition - SamplePosition) / SampleDelta, 0.5f);
+			AngularVelocity = FMath::Lerp(AngularVelocity, Axis * (Angle / SampleDelta), 0.5f);
+		}
+
+		const FQuat CurrentQuat = CurrentRotation.Quaternion();
+
+		bSnap = (SnapDistance > 0.0f && FVector::DistSquared(CurrentPosition, NewPosition) > FMath::Square(SnapDistance)) ||
+			(SnapAngle > 0.0f && FMath::RadiansToDegrees(CurrentQuat.AngularDistance(NewRotation)) > SnapAngle);
+
+		BlendStartPosition = CurrentPosition;
+		BlendStartRotation = CurrentQuat;
+	}
+
+	if (bSnap)
+	{
+		BlendStartPosition = NewPosition;
+		BlendStartVelocity = LinearVelocity;
+		BlendStartRotation = NewRotation;
+	}
+
+	SamplePosition = NewPosition;
+	SampleRotation = NewRotation;
+	SampleTime = CurrentTime;
+	BlendDuration = FMath::Max(UpdateInterval, 0.0f);
+	bHasSample = true;
+
+	return bSnap;
+}
+
+bool FVRReplicatedMotionExtrapolator::Evaluate(float CurrentTime, float MaxExtrapolationTime, FVector & OutPosition, FRotator & OutRotation) const
+{
+	if (!bHasSample)
+	{
+		OutPosition = SamplePosition;
+		OutRotation = SampleRotation.Rotator();
+		return false;
+	}
+
+	const float Elapsed = FMath::Max(CurrentTime - SampleTime, 0.0f);
+	const float MaxTime = FMath::Max(MaxExtrapolationTime, BlendDuration);
+
+	if (Elapsed < BlendDuration)
+	{
+		// Blend from where we were displayed to where the update will be one interval from now
+		const float Alpha = Elapsed / BlendDuration;
+
+		OutPosition = FMath::CubicInterp(BlendStartPosition, BlendStartVelocity * BlendDuration, SamplePosition + LinearVelocity * BlendDuration, LinearVelocity * BlendDuration, Alpha);
+		OutRotation = FQuat::Slerp(BlendStartRotation, ExtrapolateRotation(SampleRotation, AngularVelocity, BlendDuration), Alpha).Rotator();
+		return true;
+	}
+
+	if (Elapsed <= MaxTime)
+	{
+		// Dead reckoning until the next update shows up
+		OutPosition = SamplePosition + LinearVelocity * Elapsed;
+		OutRotation = ExtrapolateRotation(SampleRotation, AngularVelocity, Elapsed).Rotator();
+		return true;
+	}
+
+	// Updates are only sent on change, if nothing arrived in the window assume it stopped and settle back onto the last update
+	const float SettleAlpha = MaxTime > 0.0f ? FMath::Clamp((Elapsed - MaxTime) / MaxTime, 0.0f, 1.0f) : 1.0f;
+
+	OutPosition = FMath::Lerp(SamplePosition + LinearVelocity * MaxTime, SamplePosition, SettleAlpha);
+	OutRotation = FQuat::Slerp(ExtrapolateRotation(SampleRotation, AngularVelocity, MaxTime), SampleRotation, SettleAlpha).Rotator();
+	return SettleAlpha < 1.0f;
+}
@@ -0,0 +1,340 @@
+#include "VRGestureCompiledDatabase.h"
+#include "VRGestureComponent.h"
+#include "Serialization/CustomVersion.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Crc.h"
+
+const FGuid FVRGestureDatabaseVersion::GUID(0x4C1E7A92, 0x3B5D4F08, 0x9A62E1C7, 0x05D8B3F4);
+
+// Register the custom version with core
+FCustomVersionRegistration GRegisterVRGestureDatabaseVersion(FVRGestureDatabaseVersion::GUID, FVRGestureDatabaseVersion::LatestVersion, TEXT("VRGestureDatabaseVer"));
+
+FVRCompiledGestureDatabase::FVRCompiledGestureDatabase() :
+	MappedHandle(nullptr),
+	MappedRegion(nullptr),
+	MappedData(nullptr),
+	MappedDataSize(0)
+{
+}
+
+FVRCompiledGestureDatabase::~FVRCompiledGestureDatabase()
+{
+	Reset();
+}
+
+void FVRCompiledGestureDatabase::PackSIMDBatches(const TArray<FVRGesture> & Gestures, TArray<FVRGestureSIMDBatch> & OutBatches, TArray<float> & OutPackedData)
+{
+	OutBatches.Reset();
+	OutPackedData.Reset();
+
+	TArray<int> SortedIndices;
+	SortedIndices.Reserve(Gestures.Num());
+
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		if (Gestures[i].Samples.Num() > 0)
+			SortedIndices.Add(i);
+	}
+
+	SortedIndices.Sort([&Gestures](const int & A, const int & B)
+	{
+		return Gestures[A].Samples.Num() < Gestures[B].Samples.Num();
+	});
+
+	int32 PackedCount = 0;
+	for (int i = 0; i < SortedIndices.Num(); i += VRGESTURE_SIMD_LANES)
+	{
+		FVRGestureSIMDBatch & Batch = OutBatches[OutBatches.AddDefaulted()];
+
+		for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES && i + Lane < SortedIndices.Num(); ++Lane)
+		{
+			Batch.GestureIndices[Lane] = SortedIndices[i + Lane];
+			Batch.Lengths[Lane] = Gestures[SortedIndices[i + Lane]].Samples.Num();
+			Batch.MaxLength = FMath::Max(Batch.MaxLength, Batch.Lengths[Lane]);
+		}
+
+		Batch.DataOffset = PackedCount;
+		PackedCount += Batch.MaxLength * VRGESTURE_SIMD_LANES * 3;
+	}
+
+	// Single allocation for every batch, padding stays zeroed
+	OutPackedData.SetNumZeroed(PackedCount);
+
+	for (const FVRGestureSIMDBatch & Batch : OutBatches)
+	{
+		float * X = OutPackedData.GetData() + Batch.DataOffset;
+		float * Y = X + Batch.MaxLength * VRGESTURE_SIMD_LANES;
+		float * Z = Y + Batch.MaxLength * VRGESTURE_SIMD_LANES;
+
+		for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+		{
+			if (Batch.GestureIndices[Lane] == INDEX_NONE)
+				continue;
+
+			const TArray<FVector> & Samples = Gestures[Batch.GestureIndices[Lane]].Samples;
+			for (int j = 0; j < Samples.Num(); ++j)
+			{
+				X[j * VRGESTURE_SIMD_LANES + Lane] = Samples[j].X;
+				Y[j * VRGESTURE_SIMD_LANES + Lane] = Samples[j].Y;
+				Z[j * VRGESTURE_SIMD_LANES + Lane] = Samples[j].Z;
+			}
+		}
+	}
+}
+
+bool FVRCompiledGestureDatabase::ScaleSamplesToDatabase(TArray<FVector> & Samples, float TargetGestureScale)
+{
+	if (Samples.Num() < 1)
+		return false;
+
+	const float MaxSize = FBox(Samples).GetSize().GetMax();
+
+	// Samples that were already compiled (or restored from a compiled copy) are left alone so that hashing them again gives the same result
+	if (MaxSize <= 0.0f || FMath::IsNearlyEqual(MaxSize, TargetGestureScale, TargetGestureScale * KINDA_SMALL_NUMBER))
+		return false;
+
+	const float Scaler = TargetGestureScale / MaxSize;
+
+	for (FVector & Sample : Samples)
+	{
+		Sample *= Scaler;
+	}
+
+	return true;
+}
+
+uint32 FVRCompiledGestureDatabase::HashGestures(const TArray<FVRGesture> & Gestures, float TargetGestureScale)
+{
+	uint32 Hash = 0;
+	TArray<FVector> ScaledSamples;
+
+	for (const FVRGesture & Gesture : Gestures)
+	{
+		const int32 SampleCount = Gesture.Samples.Num();
+		Hash = FCrc::MemCrc32(&SampleCount, sizeof(SampleCount), Hash);
+
+		// Mirror mode decides which gestures get a mirrored copy compiled in
+		const uint8 MirrorMode = (uint8)Gesture.GestureSettings.MirrorMode;
+		Hash = FCrc::MemCrc32(&MirrorMode, sizeof(MirrorMode), Hash);
+
+		// Hashes the samples that end up in the blob
+		const FVector * Samples = Gesture.Samples.GetData();
+		if (Gesture.GestureSettings.bEnableScaling)
+		{
+			ScaledSamples = Gesture.Samples;
+			if (ScaleSamplesToDatabase(ScaledSamples, TargetGestureScale))
+				Samples = ScaledSamples.GetData();
+		}
+
+		Hash = FCrc::MemCrc32(Samples, SampleCount * sizeof(FVector), Hash);
+	}
+
+	return Hash;
+}
+
+uint32 FVRCompiledGestureDatabase::HashGestureLayout(const TArray<FVRGesture> & Gestures)
+{
+	uint32 Hash = 0;
+
+	for (const FVRGesture & Gesture : Gestures)
+	{
+		const int32 SampleCount = Gesture.Samples.Num();
+		Hash = FCrc::MemCrc32(&SampleCount, sizeof(SampleCount), Hash);
+
+		const uint8 MirrorMode = (uint8)Gesture.GestureSettings.MirrorMode;
+		Hash = FCrc::MemCrc32(&MirrorMode, sizeof(MirrorMode), Hash);
+
+		// Decides which gestures are quantized and how the prefilter indexes them
+		const uint8 bEnableScaling = Gesture.GestureSettings.bEnableScaling ? 1 : 0;
+		Hash = FCrc::MemCrc32(&bEnableScaling, sizeof(bEnableScaling), Hash);
+	}
+
+	return Hash;
+}
+
+bool FVRCompiledGestureDatabase::Matches(const TArray<FVRGesture> & Gestures, float TargetGestureScale) const
+{
+	return IsValid() && GetHeader()->GestureCount == Gestures.Num() && GetHeader()->TargetGestureScale == TargetGestureScale && GetHeader()->SourceHash == HashGestures(Gestures, TargetGestureScale);
+}
+
+int64 FVRCompiledGestureDatabase::GetExpectedSize(const FVRCompiledGestureHeader & Header)
+{
+	return sizeof(FVRCompiledGestureHeader) +
+		(int64)Header.GestureCount * sizeof(FVRCompiledGestureRecord) +
+		(int64)Header.SIMDBatchCount * sizeof(FVRGestureSIMDBatch) +
+		(int64)Header.SampleCount * sizeof(FVector) +
+		(int64)Header.SIMDFloatCount * sizeof(float);
+}
+
+void FVRCompiledGestureDatabase::Compile(const TArray<FVRGesture> & SourceGestures, float TargetGestureScale)
+{
+	Reset();
+
+	// Detection scales the input to the database and compares it against the samples as they are, so gestures that scale are
+	// brought to the database scale here instead of needing a RecalculateGestures first. Everything below is built from these.
+	TArray<FVRGesture> Gestures(SourceGestures);
+	for (FVRGesture & Gesture : Gestures)
+	{
+		if (Gesture.GestureSettings.bEnableScaling)
+			ScaleSamplesToDatabase(Gesture.Samples, TargetGestureScale);
+	}
+
+	TArray<FVRGestureSIMDBatch> Batches;
+	TArray<float> PackedData;
+	PackSIMDBatches(Gestures, Batches, PackedData);
+
+	FVRCompiledGestureHeader Header;
+	Header.Magic = VRGESTURE_COMPILED_MAGIC;
+	Header.Version = VRGESTURE_COMPILED_VERSION;
+	Header.GestureCount = Gestures.Num();
+	Header.SampleCount = 0;
+	Header.SIMDBatchCount = Batches.Num();
+	Header.SIMDFloatCount = PackedData.Num();
+	Header.TargetGestureScale = TargetGestureScale;
+	Header.SourceHash = HashGestures(SourceGestures, TargetGestureScale);
+
+	for (const FVRGesture & Gesture : Gestures)
+	{
+		Header.SampleCount += Gesture.Samples.Num();
+
+		if (Gesture.GestureSettings.MirrorMode != EVRGestureMirrorMode::GES_NoMirror)
+			Header.SampleCount += Gesture.Samples.Num();
+	}
+
+	Blob.SetNumZeroed((int32)GetExpectedSize(Header));
+	FMemory::Memcpy(Blob.GetData(), &Header, sizeof(FVRCompiledGestureHeader));
+
+	FVRCompiledGestureRecord * Records = const_cast<FVRCompiledGestureRecord *>(GetRecords());
+	FVector * Samples = const_cast<FVector *>(GetSamples());
+	int32 SampleOffset = 0;
+
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		const TArray<FVector> & SourceSamples = Gestures[i].Samples;
+		FVRCompiledGestureRecord & Record = Records[i];
+
+		Record.SampleOffset = SampleOffset;
+		Record.SampleCount = SourceSamples.Num();
+		Record.MirroredSampleOffset = INDEX_NONE;
+		Record.Envelope.Build(SourceSamples);
+
+		FMemory::Memcpy(Samples + SampleOffset, SourceSamples.GetData(), SourceSamples.Num() * sizeof(FVector));
+		SampleOffset += SourceSamples.Num();
+
+		if (Gestures[i].GestureSettings.MirrorMode != EVRGestureMirrorMode::GES_NoMirror)
+		{
+			Record.MirroredSampleOffset = SampleOffset;
+
+			for (const FVector & Sample : SourceSamples)
+			{
+				Samples[SampleOffset++] = FVector(Sample.X, -Sample.Y, Sample.Z);
+			}
+		}
+	}
+
+	if (Batches.Num())
+		FMemory::Memcpy(const_cast<FVRGestureSIMDBatch *>(GetSIMDBatches()), Batches.GetData(), Batches.Num() * sizeof(FVRGestureSIMDBatch));
+
+	if (PackedData.Num())
+		FMemory::Memcpy(const_cast<float *>(GetSIMDData()), PackedData.GetData(), PackedData.Num() * sizeof(float));
+}
+
+void FVRCompiledGestureDatabase::Serialize(FArchive & Ar)
+{
+	if (Ar.IsLoading())
+	{
+		Reset();
+		Blob.BulkSerialize(Ar);
+
+		if (!IsValid())
+		{
+			UE_LOG(LogVRGestureComponent, Warning, TEXT("Discarding an invalid compiled gesture database of %d bytes"), Blob.Num());
+			Blob.Empty();
+		}
+	}
+	else if (MappedRegion)
+	{
+		TArray<uint8> MappedCopy(GetData(), (int32)GetDataSize());
+		MappedCopy.BulkSerialize(Ar);
+	}
+	else
+	{
+		Blob.BulkSerialize(Ar);
+	}
+}
+
+bool FVRCompiledGestureDatabase::MapFile(const FString & Filename)
+{
+	Reset();
+
+	IMappedFileHandle * Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename);
+	if (!Handle)
+		return false;
+
+	IMappedFileRegion * Region = Handle->MapRegion(0, Handle->GetFileSize());
+	if (!Region)
+	{
+		delete Handle;
+		return false;
+	}
+
+	MappedHandle = Handle;
+	MappedRegion = Region;
+	MappedData = Region->GetMappedPtr();
+	MappedDataSize = Region->GetMappedSize();
+
+	if (!IsValid())
+	{
+		UE_LOG(LogVRGestureComponent, Warning, TEXT("Compiled gesture database %s is invalid or out of date"), *Filename);
+		Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FVRCompiledGestureDatabase::WriteToFile(const FString & Filename) const
+{
+	if (!IsValid())
+		return false;
+
+	return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(GetData(), (int32)GetDataSize()), *Filename);
+}
+
+void FVRCompiledGestureDatabase::Reset()
+{
+	// Region has to go before the handle it was mapped from
+	if (MappedRegion)
+	{
+		delete MappedRegion;
+		MappedRegion = nullptr;
+	}
+
+	if (MappedHandle)
+	{
+		delete MappedHandle;
+		MappedHandle = nullptr;
+	}
+
+	MappedData = nullptr;
+	MappedDataSize = 0;
+	Blob.Empty();
+}
+
+bool FVRCompiledGestureDatabase::IsValid() const
+{
+	if (GetDataSize() < (int64)sizeof(FVRCompiledGestureHeader))
+		return false;
+
+	const FVRCompiledGestureHeader * Header = GetHeader();
+
+	if (Header->Magic != VRGESTURE_COMPILED_MAGIC || Header->Version != VRGESTURE_COMPILED_VERSION)
+		return false;
+
+	if (Header->GestureCount < 0 || Header->SampleCount < 0 || Header->SIMDBatchCount < 0 || Header->SIMDFloatCount < 0)
+		return false;
+
+	return GetExpectedSize(*Header) == GetDataSize();
+}
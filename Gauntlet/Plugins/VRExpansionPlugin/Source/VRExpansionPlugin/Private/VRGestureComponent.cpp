@@ -1,7 +1,45 @@
 #include "VRGestureComponent.h"
+#include "VRGestureManager.h"
 #include "TimerManager.h"
+#include "Async/Async.h"
+
+DEFINE_LOG_CATEGORY(LogVRGestureComponent);
 
 DECLARE_CYCLE_STAT(TEXT("TickGesture ~ TickingGesture"), STAT_TickGesture, STATGROUP_TickGesture);
+DECLARE_CYCLE_STAT(TEXT("TickGesture ~ AsyncRecognition"), STAT_GestureAsyncRecognition, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Detection Workspace Allocations"), STAT_GestureDTWAllocations, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Lower Bound Candidates"), STAT_GestureLBCandidates, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Pruned By LB_Kim"), STAT_GesturePrunedKim, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Pruned By LB_Keogh"), STAT_GesturePrunedKeogh, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Pruned By Best Match"), STAT_GesturePrunedBest, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Full DTW Runs"), STAT_GestureFullDTW, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Pruned By Prefilter"), STAT_GesturePrunedPrefilter, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Skipped By Prefilter Index"), STAT_GestureSkippedPrefilterIndex, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Detection Input Samples"), STAT_GestureDetectionSamples, STATGROUP_TickGesture);
+
+// Slack on the lower bounds so float summation order can never prune a gesture that would have matched
+const float GESTURE_LOWER_BOUND_SLACK = 1.0001f;
+
+// Counts a workspace allocation if a detection buffer grew past its previous capacity, warmed up detection should never hit this
+static void CountWorkspaceGrowth(int32 PreviousCapacity, int32 NewCapacity)
+{
+	if (NewCapacity > PreviousCapacity)
+	{
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+}
+
+  // CVars
+namespace VRGestureCvars
+{
+	static int32 ValidateVectorizedDTW = 0;
+	FAutoConsoleVariableRef CVarValidateVectorizedDTW(
+		TEXT("vr.ValidateVectorizedGestureDTW"),
+		ValidateVectorizedDTW,
+		TEXT("When on, gesture components using the vectorized DTW will also run the scalar reference dtw() and log any mismatch in the best match.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+}
 
 UVRGestureComponent::UVRGestureComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -18,6 +56,21 @@ UVRGestureComponent::UVRGestureComponent(const FObjectInitializer& ObjectInitial
 	MirroringHand = EVRGestureMirrorMode::GES_NoMirror;
 	bDrawSplinesCurved = true;
 	bGetGestureInWorldSpace = true;
+	bUseStreamingDetection = false;
+	bTrackGestureProgress = false;
+	bQuantizedInputValid = false;
+	bPrefilterInputValid = false;
+	bUseGestureManager = false;
+	GestureProgressThreshold = 0.5f;
+	bUseVectorizedDTW = false;
+	bUseLowerBoundPruning = false;
+	bUseAsyncDetection = false;
+	RecognitionSequence = 0;
+	bAsyncRecognitionInFlight = false;
+	bAsyncRecognitionPending = false;
+	StreamingStatesDB = nullptr;
+	StreamingStatesGestureCount = 0;
+	StreamingSampleCount = 0;
 }
 
 void UGesturesDatabase::FillSplineWithGesture(FVRGesture &Gesture, USplineComponent * SplineComponent, bool bCenterPointsOnSpline, bool bScaleToBounds, float OptionalBounds, bool bUseCurvedPoints, bool bFillInSplineMeshComponents, UStaticMesh * Mesh, UMaterial * MeshMat)
@@ -123,29 +176,15 @@ void UVRGestureComponent::BeginRecording(bool bRunDetection, bool bFlattenGestur
 	bDrawRecordingGesture = bDrawGesture;
 	bDrawRecordingGestureAsSpline = bDrawAsSpline;
 	bRecordingFlattenGesture = bFlattenGesture;
-	GestureLog.GestureSize.Init();
 
-	// Reinit the drawing spline
+	// Not drawing or not as a spline, remove the components if they exist
 	if (!bDrawAsSpline || !bDrawGesture)
-		RecordingGestureDraw.Clear(); // Not drawing or not as a spline, remove the components if they exist
-	else
-	{
-		RecordingGestureDraw.Reset(); // Otherwise just clear points and hide mesh components
-
-		if (RecordingGestureDraw.SplineComponent == nullptr)
-		{
-			RecordingGestureDraw.SplineComponent = NewObject<USplineComponent>(GetAttachParent());
-			RecordingGestureDraw.SplineComponent->RegisterComponentWithWorld(GetWorld());
-			RecordingGestureDraw.SplineComponent->SetMobility(EComponentMobility::Movable);
-			RecordingGestureDraw.SplineComponent->AttachToComponent(GetAttachParent(), FAttachmentTransformRules::KeepRelativeTransform);
-			RecordingGestureDraw.SplineComponent->ClearSplinePoints(true);
-		}
-	}
+		RecordingGestureDraw.Clear();
 
-	// Reset does the reserve already
-	GestureLog.Samples.Reset(RecordingBufferSize);
+	if (bDrawAsSpline || !bDrawGesture)
+		RecordingLineDraw.Clear();
 
-	CurrentState = bRunDetection ? EVRGestureState::GES_Detecting : EVRGestureState::GES_Recording;
+	ResetRecordingState(bRunDetection);
 
 	if (TargetCharacter != nullptr)
 	{
@@ -160,12 +199,51 @@ void UVRGestureComponent::BeginRecording(bool bRunDetection, bool bFlattenGestur
 		OriginatingTransform = this->GetComponentTransform();
 
 	StartVector = OriginatingTransform.InverseTransformPosition(this->GetComponentLocation());
+
+	// Size and place the trail segments up front, drawing only updates them from here on
+	if (bDrawAsSpline && bDrawGesture && SplineMesh != nullptr && SplineMaterial != nullptr)
+	{
+		if (bGetGestureInWorldSpace || !TargetCharacter)
+			RecordingGestureDraw.Init(this, RecordingBufferSize - 1, SplineMesh, SplineMaterial, nullptr, FTransform(OriginatingTransform.GetRotation(), OriginatingTransform.TransformPosition(StartVector)));
+		else
+			RecordingGestureDraw.Init(this, RecordingBufferSize - 1, SplineMesh, SplineMaterial, TargetCharacter->GetRootComponent(), FTransform(StartVector));
+	}
+	else if (bDrawGesture && !bDrawAsSpline)
+	{
+		RecordingLineDraw.Init(this, RecordingBufferSize - 1, FTransform(StartVector) * OriginatingTransform);
+	}
+
 	this->SetComponentTickEnabled(true);
 
-	if (!TickGestureTimer_Handle.IsValid())
+	if (bUseGestureManager)
+	{
+		// The manager captures and detects for us at its own rate
+		if (TickGestureTimer_Handle.IsValid())
+			GetWorld()->GetTimerManager().ClearTimer(TickGestureTimer_Handle);
+
+		if (UVRGestureManager * Manager = UVRGestureManager::Get(GetWorld()))
+		{
+			Manager->RegisterGestureComponent(this);
+			RegisteredManager = Manager;
+
+			// Keep the delta at the rate that we are actually sampled at
+			RecordingDelta = Manager->GetUpdateInterval();
+		}
+	}
+	else if (!TickGestureTimer_Handle.IsValid())
 		GetWorld()->GetTimerManager().SetTimer(TickGestureTimer_Handle, this, &UVRGestureComponent::TickGesture, RecordingDelta, true);
 }
 
+void UVRGestureComponent::UnregisterFromGestureManager()
+{
+	if (UVRGestureManager * Manager = RegisteredManager.Get())
+	{
+		Manager->UnregisterGestureComponent(this);
+	}
+
+	RegisteredManager.Reset();
+}
+
 void UVRGestureComponent::CaptureGestureFrame()
 {
 	FVector NewSample = OriginatingTransform.InverseTransformPosition(this->GetComponentLocation()) - StartVector;
@@ -180,106 +258,217 @@ void UVRGestureComponent::CaptureGestureFrame()
 		NewSample.Z = FMath::GridSnap(NewSample.Z, RecordingClampingTolerance);
 	}
 
+	AddGestureSample(NewSample);
+}
+
+void UVRGestureComponent::AddGestureSample(const FVector & NewSample)
+{
 	// Add in newest sample at beginning (reverse order)
-	if (NewSample != FVector::ZeroVector && (GestureLog.Samples.Num() < 1 || !GestureLog.Samples[0].Equals(NewSample, SameSampleTolerance)))
+	if (NewSample != FVector::ZeroVector && (SampleWindow.Num() < 1 || !SampleWindow.GetNewest().Equals(NewSample, SameSampleTolerance)))
 	{
-		bool bClearLatestSpline = false;
-		// Pop off oldest sample
-		if (GestureLog.Samples.Num() >= RecordingBufferSize)
+
+		if (bDrawRecordingGesture)
 		{
-			GestureLog.Samples.Pop(false);
-			bClearLatestSpline = true;
+			if (!bDrawRecordingGestureAsSpline)
+				RecordingLineDraw.AddPoint(NewSample);
+			else if (SplineMesh != nullptr && SplineMaterial != nullptr)
+				RecordingGestureDraw.AddPoint(NewSample, bDrawSplinesCurved);
 		}
-		
-		GestureLog.GestureSize.Max.X = FMath::Max(NewSample.X, GestureLog.GestureSize.Max.X);
-		GestureLog.GestureSize.Max.Y = FMath::Max(NewSample.Y, GestureLog.GestureSize.Max.Y);
-		GestureLog.GestureSize.Max.Z = FMath::Max(NewSample.Z, GestureLog.GestureSize.Max.Z);
 
-		GestureLog.GestureSize.Min.X = FMath::Min(NewSample.X, GestureLog.GestureSize.Min.X);
-		GestureLog.GestureSize.Min.Y = FMath::Min(NewSample.Y, GestureLog.GestureSize.Min.Y);
-		GestureLog.GestureSize.Min.Z = FMath::Min(NewSample.Z, GestureLog.GestureSize.Min.Z);
+		// Drops the oldest sample once the window is full and keeps the bounds of the window exact
+		SampleWindow.Push(NewSample);
+		bGestureChanged = true;
+
+		if (ShouldUpdateStreamingStates() && CurrentState == EVRGestureState::GES_Detecting)
+			UpdateStreamingStates(NewSample);
+	}
+}
 
+void FVRGestureSplineDraw::Init(USceneComponent * Owner, int SegmentCount, UStaticMesh * Mesh, UMaterialInterface * Material, USceneComponent * AttachParent, const FTransform & StartTransform)
+{
+	SegmentCount = FMath::Max(SegmentCount, 1);
 
-		if (bDrawRecordingGesture && bDrawRecordingGestureAsSpline && SplineMesh != nullptr && SplineMaterial != nullptr)
+	// Drop any segments that were destroyed out from under us or that the ring no longer needs
+	for (int i = SplineMeshes.Num() - 1; i >= 0; --i)
+	{
+		if (SplineMeshes[i] == nullptr || SplineMeshes[i]->IsBeingDestroyed() || i >= SegmentCount)
 		{
+			if (SplineMeshes[i] != nullptr && !SplineMeshes[i]->IsBeingDestroyed())
+				SplineMeshes[i]->DestroyComponent();
 
-			if (bClearLatestSpline)
-				RecordingGestureDraw.ClearLastPoint();
+			SplineMeshes.RemoveAt(i, 1, false);
+		}
+	}
 
-			RecordingGestureDraw.SplineComponent->AddSplinePoint(NewSample, ESplineCoordinateSpace::Local, false);
-			int SplineIndex = RecordingGestureDraw.SplineComponent->GetNumberOfSplinePoints() - 1;
-			RecordingGestureDraw.SplineComponent->SetSplinePointType(SplineIndex, bDrawSplinesCurved ? ESplinePointType::Curve : ESplinePointType::Linear, true);
+	while (SplineMeshes.Num() < SegmentCount)
+	{
+		USplineMeshComponent * MeshComp = NewObject<USplineMeshComponent>(Owner);
+		MeshComp->SetMobility(EComponentMobility::Movable);
+		MeshComp->RegisterComponentWithWorld(Owner->GetWorld());
+		SplineMeshes.Add(MeshComp);
+	}
 
-			bool bFoundEmptyMesh = false;
-			USplineMeshComponent * MeshComp = nullptr;
-			int MeshIndex = 0;
+	for (USplineMeshComponent * MeshComp : SplineMeshes)
+	{
+		MeshComp->SetStaticMesh(Mesh);
+		MeshComp->SetMaterial(0, Material);
 
-			for (int i = 0; i < RecordingGestureDraw.SplineMeshes.Num(); i++)
-			{
-				MeshIndex = i;
-				MeshComp = RecordingGestureDraw.SplineMeshes[i];
-				if (MeshComp == nullptr)
-				{
-					RecordingGestureDraw.SplineMeshes[i] = NewObject<USplineMeshComponent>(RecordingGestureDraw.SplineComponent);
-					MeshComp = RecordingGestureDraw.SplineMeshes[i];
-
-					MeshComp->RegisterComponentWithWorld(GetWorld());
-					MeshComp->SetMobility(EComponentMobility::Movable);
-					MeshComp->SetStaticMesh(SplineMesh);
-					MeshComp->SetMaterial(0, (UMaterialInterface*)SplineMaterial);
-					bFoundEmptyMesh = true;
-					break;
-				}
-				else if (!MeshComp->IsVisible())
-				{
-					bFoundEmptyMesh = true;
-					break;
-				}
-			}
+		if (AttachParent)
+		{
+			if (MeshComp->GetAttachParent() != AttachParent)
+				MeshComp->AttachToComponent(AttachParent, FAttachmentTransformRules::KeepRelativeTransform);
 
-			if (!bFoundEmptyMesh)
-			{
-				USplineMeshComponent * newSplineMesh = NewObject<USplineMeshComponent>(RecordingGestureDraw.SplineComponent);
-				MeshComp = newSplineMesh;
-				MeshComp->RegisterComponentWithWorld(GetWorld());
-				MeshComp->SetMobility(EComponentMobility::Movable);
-				RecordingGestureDraw.SplineMeshes.Add(MeshComp);
-				MeshIndex = RecordingGestureDraw.SplineMeshes.Num() - 1;
-				MeshComp->SetStaticMesh(SplineMesh);
-				MeshComp->SetMaterial(0, (UMaterialInterface*)SplineMaterial);
-				if (!bGetGestureInWorldSpace && TargetCharacter)
-					MeshComp->AttachToComponent(TargetCharacter->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-			}
+			MeshComp->SetRelativeLocationAndRotation(StartTransform.GetLocation(), StartTransform.GetRotation());
+		}
+		else
+		{
+			if (MeshComp->GetAttachParent() != nullptr)
+				MeshComp->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
 
-			if (MeshComp != nullptr)
-			{
-				// Fill in last mesh component tangent and end pos
-				if (RecordingGestureDraw.LastIndexSet != MeshIndex && RecordingGestureDraw.SplineMeshes[RecordingGestureDraw.LastIndexSet] != nullptr)
-				{
-					RecordingGestureDraw.SplineMeshes[RecordingGestureDraw.LastIndexSet]->SetEndPosition(NewSample, false);
-					RecordingGestureDraw.SplineMeshes[RecordingGestureDraw.LastIndexSet]->SetEndTangent(RecordingGestureDraw.SplineComponent->GetTangentAtSplinePoint(SplineIndex, ESplineCoordinateSpace::Local), true);
-				}
+			MeshComp->SetWorldLocationAndRotation(StartTransform.GetLocation(), StartTransform.GetRotation());
+		}
+	}
 
-				MeshComp->SetStartAndEnd(NewSample,
-					RecordingGestureDraw.SplineComponent->GetTangentAtSplinePoint(SplineIndex, ESplineCoordinateSpace::Local),
-					NewSample,
-					FVector::ZeroVector,
-					true);
+	Reset();
+}
 
-				if (bGetGestureInWorldSpace)
-					MeshComp->SetWorldLocationAndRotation(OriginatingTransform.TransformPosition(StartVector), OriginatingTransform.GetRotation());
-				else
-					MeshComp->SetRelativeLocationAndRotation(/*OriginatingTransform.TransformPosition(*/StartVector/*)*/, FQuat::Identity/*OriginatingTransform.GetRotation()*/);
+void FVRGestureLineDraw::Init(USceneComponent * Owner, int SegmentCount, const FTransform & InDrawTransform)
+{
+#if ENABLE_DRAW_DEBUG
+	UWorld * World = Owner->GetWorld();
 
-				RecordingGestureDraw.LastIndexSet = MeshIndex;
-				MeshComp->SetVisibility(true);
-			}
-		
-		}
+	// no debug line drawing on dedicated server
+	if (!World || World->GetNetMode() == NM_DedicatedServer)
+		return;
 
-		GestureLog.Samples.Insert(NewSample, 0);
-		bGestureChanged = true;
+	if (LineBatch == nullptr || LineBatch->IsBeingDestroyed())
+	{
+		LineBatch = NewObject<ULineBatchComponent>(Owner);
+
+		// Lines never expire on their own and the trail is always visible, so skip ticking and bounds
+		LineBatch->bCalculateAccurateBounds = false;
+		LineBatch->PrimaryComponentTick.bCanEverTick = false;
+		LineBatch->RegisterComponentWithWorld(World);
+	}
+
+	MaxSegments = FMath::Max(SegmentCount, 1);
+	LineBatch->BatchedLines.Reserve(MaxSegments);
+	DrawTransform = InDrawTransform;
+
+	Reset();
+#endif
+}
+
+void FVRGestureLineDraw::AddPoint(const FVector & Point)
+{
+#if ENABLE_DRAW_DEBUG
+	if (LineBatch == nullptr)
+		return;
+
+	const FVector WorldPoint = DrawTransform.TransformPosition(Point);
+
+	if (!bHasPoint)
+	{
+		LastPoint = WorldPoint;
+		bHasPoint = true;
+		return;
+	}
+
+	// Persistent (zero lifetime) line, the oldest segment is overwritten in place once the ring is full
+	const FBatchedLine Line(LastPoint, WorldPoint, FLinearColor::White, 0.f, 0.f, SDPG_World);
+
+	if (LineBatch->BatchedLines.Num() < MaxSegments)
+		LineBatch->BatchedLines.Add(Line);
+	else
+		LineBatch->BatchedLines[NextSegment] = Line;
+
+	NextSegment = (NextSegment + 1) % MaxSegments;
+	LastPoint = WorldPoint;
+
+	LineBatch->MarkRenderStateDirty();
+#endif
+}
+
+void FVRGestureSplineDraw::AddPoint(const FVector & Point, bool bCurved)
+{
+	if (SplineMeshes.Num() < 1)
+		return;
+
+	if (PointCount < 1)
+	{
+		LastPoints[0] = Point;
+		PointCount = 1;
+		return;
+	}
+
+	const FVector & LastPoint = LastPoints[0];
+	const FVector SegmentTangent = Point - LastPoint;
+
+	// Catmull-Rom tangent at the last point now that the point after it is known, the newest point has no next point yet
+	const FVector StartTangent = (bCurved && PointCount > 1) ? (Point - LastPoints[1]) * 0.5f : SegmentTangent;
+
+	if (ActiveSegments > 0 && bCurved)
+	{
+		const int LastSegment = (NextSegment + SplineMeshes.Num() - 1) % SplineMeshes.Num();
+		if (SplineMeshes[LastSegment] != nullptr)
+			SplineMeshes[LastSegment]->SetEndTangent(StartTangent, true);
+	}
+
+	if (USplineMeshComponent * MeshComp = SplineMeshes[NextSegment])
+	{
+		MeshComp->SetStartAndEnd(LastPoint, StartTangent, Point, SegmentTangent, true);
+		MeshComp->SetVisibility(true);
+	}
+
+	NextSegment = (NextSegment + 1) % SplineMeshes.Num();
+	ActiveSegments = FMath::Min(ActiveSegments + 1, SplineMeshes.Num());
+
+	LastPoints[1] = LastPoints[0];
+	LastPoints[0] = Point;
+	PointCount = 2;
+}
+
+void UVRGestureComponent::ResetRecordingState(bool bRunDetection)
+{
+	// The workspace may be resized below
+	WaitForAsyncRecognition();
+
+	// Only allocates if the buffer size changed
+	SampleWindow.Init(RecordingBufferSize);
+	GestureLog.Samples.Reset();
+	GestureLog.GestureSize.Init();
+	RecognitionSequence++;
+	bAsyncRecognitionPending = false;
+
+	if (ShouldUpdateStreamingStates())
+		InitStreamingStates();
+
+	if (!bUseStreamingDetection && bRunDetection)
+		SizeDTWWorkspace();
+
+	CurrentState = bRunDetection ? EVRGestureState::GES_Detecting : EVRGestureState::GES_Recording;
+}
+
+void UVRGestureComponent::RunGestureDetection()
+{
+	if (bTrackGestureProgress && bGestureChanged)
+		UpdateGestureProgress();
+
+	if (bUseStreamingDetection)
+		RecognizeGestureStreaming();
+	else if (bUseAsyncDetection || bAsyncRecognitionInFlight)
+		DispatchAsyncRecognition();
+	else if (GesturesDB && GesturesDB->ShouldProcessSamples())
+	{
+		if (bGestureChanged)
+			GetDetectionSamples(ProcessedGestureLog);
+
+		RecognizeGesture(ProcessedGestureLog);
 	}
+	else
+		RecognizeGesture(SampleWindow.GetView());
+
+	bGestureChanged = false;
 }
 
 void UVRGestureComponent::TickGesture()
@@ -291,8 +480,7 @@ void UVRGestureComponent::TickGesture()
 	case EVRGestureState::GES_Detecting:
 	{
 		CaptureGestureFrame();
-		RecognizeGesture(GestureLog);
-		bGestureChanged = false;
+		RunGestureDetection();
 	}break;
 
 	case EVRGestureState::GES_Recording:
@@ -303,182 +491,1575 @@ void UVRGestureComponent::TickGesture()
 	case EVRGestureState::GES_None:
 	default: {}break;
 	}
+}
+
+void UVRGestureComponent::GetDetectionSamples(FVRGesture & OutGesture)
+{
+	const int32 PreviousCapacity = OutGesture.Samples.Max() + SampleProcessor.Scratch.Max() + SampleProcessor.Stack.Max() + SampleProcessor.Keep.Max();
+
+	// Reset and append instead of assigning so the output keeps its allocation
+	OutGesture.Samples.Reset();
+	OutGesture.GestureSize = SampleWindow.GetBounds();
 
-	if (bDrawRecordingGesture)
+	if (!GesturesDB || !GesturesDB->ShouldProcessSamples() || SampleWindow.Num() < 3)
 	{
-		if (!bDrawRecordingGestureAsSpline)
-		{
-			FTransform DrawTransform = FTransform(StartVector) * OriginatingTransform;
-			// Setting the lifetime to the recording htz now, should remove the flicker.
-			DrawDebugGesture(this, DrawTransform, GestureLog, FColor::White, false, 0, RecordingDelta, 0.0f);
-		}
+		SampleWindow.CopyTo(OutGesture);
+	}
+	else
+	{
+		// Database settings are in database scale, the live samples get scaled up to it during the DTW
+		float MaxSize = OutGesture.GestureSize.GetSize().GetMax();
+		float ToLiveScale = MaxSize > 0.0f ? MaxSize / GesturesDB->TargetGestureScale : 1.0f;
+
+		// The processed samples stay inside the original bounds, so the size is kept for the scaling
+		SampleProcessor.Process(SampleWindow.GetSamples(), GesturesDB->ResampleSpacing * ToLiveScale, GesturesDB->SimplifyTolerance * ToLiveScale, GesturesDB->bAlignToPrincipalAxis, OutGesture.Samples);
+
+		// Unless they were rotated, then the size has to match the rotated samples like it does for the database gestures
+		if (GesturesDB->bAlignToPrincipalAxis)
+			OutGesture.GestureSize = FBox(OutGesture.Samples);
 	}
+
+	INC_DWORD_STAT_BY(STAT_GestureDetectionSamples, OutGesture.Samples.Num());
+	CountWorkspaceGrowth(PreviousCapacity, OutGesture.Samples.Max() + SampleProcessor.Scratch.Max() + SampleProcessor.Stack.Max() + SampleProcessor.Keep.Max());
 }
 
-void UVRGestureComponent::RecognizeGesture(FVRGesture inputGesture)
+void FVRGestureSampleProcessor::ResampleByArcLength(TArrayView<const FVector> InSamples, float Spacing, TArray<FVector> & OutSamples)
 {
-	if (!GesturesDB || inputGesture.Samples.Num() < 1 || !bGestureChanged)
+	OutSamples.Reset();
+
+	if (InSamples.Num() < 1)
 		return;
 
-	float minDist = MAX_FLT;
+	OutSamples.Add(InSamples[0]);
 
-	int OutGestureIndex = -1;
-	bool bMirrorGesture = false;
+	if (Spacing <= KINDA_SMALL_NUMBER)
+	{
+		OutSamples.Append(InSamples.GetData() + 1, InSamples.Num() - 1);
+		return;
+	}
 
-	FVector Size = inputGesture.GestureSize.GetSize();
-	float Scaler = GesturesDB->TargetGestureScale / Size.GetMax();
-	float FinalScaler = Scaler;
+	FVector LastPoint = InSamples[0];
+	float DistSinceLast = 0.0f;
 
-	for (int i = 0; i < GesturesDB->Gestures.Num(); i++)
+	for (int i = 1; i < InSamples.Num(); ++i)
 	{
-		FVRGesture &exampleGesture = GesturesDB->Gestures[i];
+		float SegmentLength = FVector::Dist(LastPoint, InSamples[i]);
 
-		if (!exampleGesture.GestureSettings.bEnabled || exampleGesture.Samples.Num() < 1 || inputGesture.Samples.Num() < exampleGesture.GestureSettings.Minimum_Gesture_Length)
-			continue;
+		// Drop as many points as fit on this segment
+		while (DistSinceLast + SegmentLength >= Spacing && SegmentLength > 0.0f)
+		{
+			float Alpha = (Spacing - DistSinceLast) / SegmentLength;
+			LastPoint = FMath::Lerp(LastPoint, InSamples[i], Alpha);
+			OutSamples.Add(LastPoint);
 
-		FinalScaler = exampleGesture.GestureSettings.bEnableScaling ? Scaler : 1.f;
+			SegmentLength = FVector::Dist(LastPoint, InSamples[i]);
+			DistSinceLast = 0.0f;
+		}
 
-		bMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand != EVRGestureMirrorMode::GES_MirrorBoth && MirroringHand == exampleGesture.GestureSettings.MirrorMode);
+		DistSinceLast += SegmentLength;
+		LastPoint = InSamples[i];
+	}
 
-		if (GetGestureDistance(inputGesture.Samples[0] * FinalScaler, exampleGesture.Samples[0], bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold))
-		{
-			float d = dtw(inputGesture, exampleGesture, bMirrorGesture, FinalScaler) / (exampleGesture.Samples.Num());
-			if (d < minDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
-			{
-				minDist = d;
-				OutGestureIndex = i;
-			}
-		}
-		else if (exampleGesture.GestureSettings.MirrorMode == EVRGestureMirrorMode::GES_MirrorBoth)
+	// Always end on the last sample
+	if (DistSinceLast > KINDA_SMALL_NUMBER)
+		OutSamples.Add(InSamples[InSamples.Num() - 1]);
+}
+
+void FVRGestureSampleProcessor::Simplify(TArrayView<const FVector> InSamples, float Tolerance, TArray<FVector> & OutSamples)
+{
+	OutSamples.Reset();
+
+	if (InSamples.Num() < 3 || Tolerance <= 0.0f)
+	{
+		OutSamples.Append(InSamples.GetData(), InSamples.Num());
+		return;
+	}
+
+	const float ToleranceSquared = FMath::Square(Tolerance);
+
+	Keep.Reset();
+	Keep.AddZeroed(InSamples.Num());
+	Keep[0] = true;
+	Keep.Last() = true;
+
+	// Ranges still to check, as pairs of first and last index
+	Stack.Reset();
+	Stack.Add(0);
+	Stack.Add(InSamples.Num() - 1);
+
+	while (Stack.Num() > 0)
+	{
+		const int32 Last = Stack.Pop(false);
+		const int32 First = Stack.Pop(false);
+
+		float FurthestDistSquared = ToleranceSquared;
+		int32 FurthestIndex = INDEX_NONE;
+
+		for (int32 i = First + 1; i < Last; ++i)
 		{
-			bMirrorGesture = true;
-			if (GetGestureDistance(inputGesture.Samples[0] * FinalScaler, exampleGesture.Samples[0], bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold))
+			float DistSquared = FMath::PointDistToSegmentSquared(InSamples[i], InSamples[First], InSamples[Last]);
+			if (DistSquared > FurthestDistSquared)
 			{
-				float d = dtw(inputGesture, exampleGesture, bMirrorGesture, FinalScaler) / (exampleGesture.Samples.Num());
-				if (d < minDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
-				{
-					minDist = d;
-					OutGestureIndex = i;
-				}
+				FurthestDistSquared = DistSquared;
+				FurthestIndex = i;
 			}
 		}
 
-		/*if (exampleGesture.MirrorMode == EVRGestureMirrorMode::GES_MirrorBoth)
+		if (FurthestIndex != INDEX_NONE)
 		{
-			bMirrorGesture = true;
+			Keep[FurthestIndex] = true;
 
-			if (GetGestureDistance(inputGesture.Samples[0], exampleGesture.Samples[0], bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold))
-			{
-				float d = dtw(inputGesture, exampleGesture, bMirrorGesture) / (exampleGesture.Samples.Num());
-				if (d < minDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
-				{
-					minDist = d;
-					OutGestureIndex = i;
-				}
-			}
-		}*/
+			Stack.Add(First);
+			Stack.Add(FurthestIndex);
+			Stack.Add(FurthestIndex);
+			Stack.Add(Last);
+		}
 	}
 
-	if (/*minDist < FMath::Square(globalThreshold) && */OutGestureIndex != -1)
+	for (int32 i = 0; i < InSamples.Num(); ++i)
 	{
-		OnGestureDetected(GesturesDB->Gestures[OutGestureIndex].GestureType, /*minDist,*/ GesturesDB->Gestures[OutGestureIndex].Name, OutGestureIndex, GesturesDB);
-		OnGestureDetected_Bind.Broadcast(GesturesDB->Gestures[OutGestureIndex].GestureType, /*minDist,*/ GesturesDB->Gestures[OutGestureIndex].Name, OutGestureIndex, GesturesDB);
-		ClearRecording(); // Clear the recording out, we don't want to detect this gesture again with the same data
-		RecordingGestureDraw.Reset();
+		if (Keep[i])
+			OutSamples.Add(InSamples[i]);
 	}
 }
 
-float UVRGestureComponent::dtw(FVRGesture seq1, FVRGesture seq2, bool bMirrorGesture, float Scaler)
+void FVRGestureSampleProcessor::AlignToPrincipalAxis(TArray<FVector> & Samples)
 {
+	const int Count = Samples.Num();
 
-	// #TODO: Skip copying the array and reversing it in the future, we only ever use the reversed value.
-	// So pre-reverse it and keep it stored like that on init. When we do the initial sample we can check off of the first index instead of last then
-
-	// Should also be able to get SizeSquared for values and compared to squared thresholds instead of doing the full SQRT calc.
+	if (Count < 2)
+		return;
 
-	// Getting number of average samples recorded over of a gesture (top down) may be able to achieve a basic % completed check
-	// to see how far into detecting a gesture we are, this would require ignoring the last position threshold though....
+	// Covariance of the stroke in the Y/Z plane
+	float MeanY = 0.f;
+	float MeanZ = 0.f;
 
-	int RowCount = seq1.Samples.Num() + 1;
-	int ColumnCount = seq2.Samples.Num() + 1;
+	for (const FVector & Sample : Samples)
+	{
+		MeanY += Sample.Y;
+		MeanZ += Sample.Z;
+	}
 
-	TArray<float> LookupTable;
-	LookupTable.AddZeroed(ColumnCount * RowCount);
+	MeanY /= Count;
+	MeanZ /= Count;
 
-	TArray<int> SlopeI;
-	SlopeI.AddZeroed(ColumnCount * RowCount);
-	TArray<int> SlopeJ;
-	SlopeJ.AddZeroed(ColumnCount * RowCount);
+	float Syy = 0.f;
+	float Szz = 0.f;
+	float Syz = 0.f;
 
-	for (int i = 1; i < (ColumnCount * RowCount); i++)
+	for (const FVector & Sample : Samples)
 	{
-		LookupTable[i] = MAX_FLT;
+		const float DeltaY = Sample.Y - MeanY;
+		const float DeltaZ = Sample.Z - MeanZ;
+		Syy += DeltaY * DeltaY;
+		Szz += DeltaZ * DeltaZ;
+		Syz += DeltaY * DeltaZ;
 	}
-	// Don't need to do this, it is already handled by add zeroed
-	//tab[0, 0] = 0;
 
-	int icol = 0, icolneg = 0;
+	if (Syy + Szz <= KINDA_SMALL_NUMBER)
+		return;
 
-	// Dynamic computation of the DTW matrix.
-	for (int i = 1; i < RowCount; i++)
-	{
-		for (int j = 1; j < ColumnCount; j++)
-		{
-			icol = i * ColumnCount;
-			icolneg = icol - ColumnCount;// (i - 1) * ColumnCount;
+	// Angle of the principal axis from +Y, closed form for a 2x2 symmetric matrix
+	float Angle = 0.5f * FMath::Atan2(2.f * Syz, Syy - Szz);
 
-			if (
-				LookupTable[icol + (j - 1)] < LookupTable[icolneg + (j - 1)] &&
-				LookupTable[icol + (j - 1)] < LookupTable[icolneg + j] &&
-				SlopeI[icol + (j - 1)] < maxSlope)
-			{
-				LookupTable[icol + j] = GetGestureDistance(seq1.Samples[i - 1] * Scaler, seq2.Samples[j - 1], bMirrorGesture) + LookupTable[icol + j - 1];
-				SlopeI[icol + j] = SlopeJ[icol + j - 1] + 1;
-				SlopeJ[icol + j] = 0;
-			}
-			else if (
-				LookupTable[icolneg + j] < LookupTable[icolneg + j - 1] &&
-				LookupTable[icolneg + j] < LookupTable[icol + j - 1] &&
-				SlopeJ[icolneg + j] < maxSlope)
-			{
-				LookupTable[icol + j] = GetGestureDistance(seq1.Samples[i - 1] * Scaler, seq2.Samples[j - 1], bMirrorGesture) + LookupTable[icolneg + j];
-				SlopeI[icol + j] = 0;
-				SlopeJ[icol + j] = SlopeJ[icolneg + j] + 1;
-			}
-			else
-			{
-				LookupTable[icol + j] = GetGestureDistance(seq1.Samples[i - 1] * Scaler, seq2.Samples[j - 1], bMirrorGesture) + LookupTable[icolneg + j - 1];
-				SlopeI[icol + j] = 0;
-				SlopeJ[icol + j] = 0;
-			}
-		}
-	}
+	// The axis has no direction of its own, point it from the oldest towards the newest sample so the same stroke always ends up the same way around
+	// Closed strokes (start and end in the same place) can still flip, they should be recorded with alignment off
+	const FVector Pivot = Samples[Count - 1];
+	const FVector & Newest = Samples[0];
 
-	// Find best between seq2 and an ending (postfix) of seq1.
-	float bestMatch = FLT_MAX;
+	if ((Newest.Y - Pivot.Y) * FMath::Cos(Angle) + (Newest.Z - Pivot.Z) * FMath::Sin(Angle) < 0.f)
+		Angle += PI;
 
-	for (int i = 1; i < seq1.Samples.Num() + 1/* - seq2.Minimum_Gesture_Length*/; i++)
+	// Rotate by -Angle about the oldest sample, it is where the recording started so the samples stay relative to it
+	float Sin = 0.f;
+	float Cos = 0.f;
+	FMath::SinCos(&Sin, &Cos, -Angle);
+
+	for (FVector & Sample : Samples)
 	{
-		if (LookupTable[(i*ColumnCount) + seq2.Samples.Num()] < bestMatch)
-		bestMatch = LookupTable[(i*ColumnCount) + seq2.Samples.Num()];
+		const float DeltaY = Sample.Y - Pivot.Y;
+		const float DeltaZ = Sample.Z - Pivot.Z;
+		Sample.Y = Pivot.Y + DeltaY * Cos - DeltaZ * Sin;
+		Sample.Z = Pivot.Z + DeltaY * Sin + DeltaZ * Cos;
 	}
+}
 
-	return bestMatch;
+void FVRGestureSampleProcessor::Process(TArrayView<const FVector> InSamples, float Spacing, float Tolerance, bool bAlignToPrincipalAxis, TArray<FVector> & OutSamples)
+{
+	if (Tolerance > 0.0f && Spacing > 0.0f)
+	{
+		// Simplify first so that the resampled points end up evenly spaced
+		Simplify(InSamples, Tolerance, Scratch);
+		ResampleByArcLength(Scratch, Spacing, OutSamples);
+	}
+	else if (Tolerance > 0.0f)
+	{
+		Simplify(InSamples, Tolerance, OutSamples);
+	}
+	else
+	{
+		ResampleByArcLength(InSamples, Spacing, OutSamples);
+	}
+
+	if (bAlignToPrincipalAxis)
+		AlignToPrincipalAxis(OutSamples);
 }
 
-void UVRGestureComponent::DrawDebugGesture(UObject* WorldContextObject, FTransform &StartTransform, FVRGesture GestureToDraw, FColor const& Color, bool bPersistentLines, uint8 DepthPriority, float LifeTime, float Thickness)
+void UVRGestureComponent::RecognizeGesture(const FVRGestureView & inputGesture)
 {
-#if ENABLE_DRAW_DEBUG
+	if (!GesturesDB || inputGesture.Samples.Num() < 1 || !bGestureChanged)
+		return;
 
-	UWorld* InWorld = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	GesturesDB->UpdateGestureCache();
 
-	if (InWorld != nullptr)
+	float minDist = MAX_FLT;
+	int OutGestureIndex = INDEX_NONE;
+
+	if (bUseVectorizedDTW)
 	{
-		// no debug line drawing on dedicated server
-		if (GEngine->GetNetMode(InWorld) != NM_DedicatedServer && GestureToDraw.Samples.Num() > 1)
+		OutGestureIndex = FindBestGestureVectorized(GesturesDB, inputGesture, minDist);
+
+		if (VRGestureCvars::ValidateVectorizedDTW > 0)
 		{
-			bool bMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand == GestureToDraw.GestureSettings.MirrorMode);
-			FVector MirrorVector = FVector(1.f, -1.f, 1.f); // Only mirroring on Y axis to flip Left/Right
+			float ReferenceDist = MAX_FLT;
+			int ReferenceIndex = FindBestGesture(GesturesDB, inputGesture, ReferenceDist);
+
+			if (ReferenceIndex != OutGestureIndex)
+			{
+				UE_LOG(LogVRGestureComponent, Warning, TEXT("Vectorized gesture DTW mismatch: scalar matched %i (%f), vectorized matched %i (%f)"), ReferenceIndex, ReferenceDist, OutGestureIndex, minDist);
+			}
+		}
+	}
+	else
+	{
+		OutGestureIndex = FindBestGesture(GesturesDB, inputGesture, minDist);
+	}
+
+	if (/*minDist < FMath::Square(globalThreshold) && */OutGestureIndex != INDEX_NONE)
+	{
+		BroadcastGestureDetected(OutGestureIndex);
+	}
+}
+
+void UVRGestureComponent::DispatchAsyncRecognition()
+{
+	if (bGestureChanged)
+		bAsyncRecognitionPending = true;
+
+	// The task uses our DTW workspace, so only one can run at a time
+	if (!bAsyncRecognitionPending || bAsyncRecognitionInFlight || !GesturesDB || SampleWindow.Num() < 1)
+		return;
+
+	bAsyncRecognitionPending = false;
+	bAsyncRecognitionInFlight = true;
+
+	// Build any cached database data here so the task only ever reads from it
+	GesturesDB->UpdateGestureCache();
+
+	GetDetectionSamples(AsyncRecognitionSnapshot);
+
+	const int Sequence = RecognitionSequence;
+	TWeakObjectPtr<UVRGestureComponent> WeakThis(this);
+
+	// The task keeps the database it was started with, GesturesDB can be swapped out while it runs.
+	// Both BeginDestroys wait on this task, so it is safe for it to use the component and database directly
+	UGesturesDatabase * TaskDB = GesturesDB;
+	TWeakObjectPtr<UGesturesDatabase> WeakTaskDB(TaskDB);
+
+	AsyncRecognitionTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this, WeakThis, TaskDB, WeakTaskDB, Sequence]()
+	{
+		int GestureIndex = INDEX_NONE;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GestureAsyncRecognition);
+
+			float minDist = MAX_FLT;
+			GestureIndex = bUseVectorizedDTW ? FindBestGestureVectorized(TaskDB, AsyncRecognitionSnapshot, minDist) : FindBestGesture(TaskDB, AsyncRecognitionSnapshot, minDist);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakTaskDB, Sequence, GestureIndex]()
+		{
+			if (UVRGestureComponent * GestureComponent = WeakThis.Get())
+			{
+				GestureComponent->OnAsyncRecognitionComplete(Sequence, WeakTaskDB.Get(), GestureIndex);
+			}
+		});
+	}, TStatId(), nullptr, ENamedThreads::AnyHiPriThreadHiPriTask);
+
+	TaskDB->AddAsyncReader(AsyncRecognitionTask);
+}
+
+void UVRGestureComponent::OnAsyncRecognitionComplete(int Sequence, UGesturesDatabase * TaskDB, int GestureIndex)
+{
+	bAsyncRecognitionInFlight = false;
+	AsyncRecognitionTask = nullptr;
+
+	// Recording was cleared or restarted since this was dispatched
+	if (Sequence != RecognitionSequence || CurrentState != EVRGestureState::GES_Detecting)
+		return;
+
+	// The index is into the database the task ran against, it means nothing for a different one
+	if (TaskDB != GesturesDB)
+	{
+		bAsyncRecognitionPending = true;
+		GestureIndex = INDEX_NONE;
+	}
+
+	if (GestureIndex != INDEX_NONE && GesturesDB && GesturesDB->Gestures.IsValidIndex(GestureIndex))
+	{
+		BroadcastGestureDetected(GestureIndex);
+	}
+	else if (bAsyncRecognitionPending && bUseAsyncDetection)
+	{
+		// New samples came in while this was running, start on them right away instead of waiting on the next tick
+		DispatchAsyncRecognition();
+	}
+}
+
+void UVRGestureComponent::BroadcastGestureDetected(int GestureIndex)
+{
+	OnGestureDetected(GesturesDB->Gestures[GestureIndex].GestureType, /*minDist,*/ GesturesDB->Gestures[GestureIndex].Name, GestureIndex, GesturesDB);
+	OnGestureDetected_Bind.Broadcast(GesturesDB->Gestures[GestureIndex].GestureType, /*minDist,*/ GesturesDB->Gestures[GestureIndex].Name, GestureIndex, GesturesDB);
+	ClearRecording(); // Clear the recording out, we don't want to detect this gesture again with the same data
+	RecordingGestureDraw.Reset();
+}
+
+bool UVRGestureComponent::CheckFirstThreshold(const UGesturesDatabase * Database, const FVRGestureView & inputGesture, int GestureIndex, float Scaler, float & OutScaler, bool & bOutMirrorGesture, float & OutFirstDistance)
+{
+	const FVRGesture & exampleGesture = Database->Gestures[GestureIndex];
+	const TArrayView<const FVector> ExampleSamples = Database->GetGestureSamples(GestureIndex, false);
+
+	if (!exampleGesture.GestureSettings.bEnabled || ExampleSamples.Num() < 1 || inputGesture.Samples.Num() < exampleGesture.GestureSettings.Minimum_Gesture_Length)
+		return false;
+
+	OutScaler = exampleGesture.GestureSettings.bEnableScaling ? Scaler : 1.f;
+
+	bOutMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand != EVRGestureMirrorMode::GES_MirrorBoth && MirroringHand == exampleGesture.GestureSettings.MirrorMode);
+
+	OutFirstDistance = GetGestureDistance(inputGesture.Samples[0] * OutScaler, ExampleSamples[0], bOutMirrorGesture);
+
+	// Both mode only checks the mirrored gesture if the normal one was thrown out
+	if (OutFirstDistance >= FMath::Square(exampleGesture.GestureSettings.firstThreshold) && exampleGesture.GestureSettings.MirrorMode == EVRGestureMirrorMode::GES_MirrorBoth)
+	{
+		bOutMirrorGesture = true;
+		OutFirstDistance = GetGestureDistance(inputGesture.Samples[0] * OutScaler, ExampleSamples[0], bOutMirrorGesture);
+	}
+
+	return OutFirstDistance < FMath::Square(exampleGesture.GestureSettings.firstThreshold);
+}
+
+bool UVRGestureComponent::BeginBatchedRecognition()
+{
+	if (!GesturesDB || !bGestureChanged)
+		return false;
+
+	if (SampleWindow.Num() < 1)
+	{
+		bGestureChanged = false;
+		return false;
+	}
+
+	if (bTrackGestureProgress)
+		UpdateGestureProgress();
+
+	if (GesturesDB->ShouldProcessSamples())
+	{
+		GetDetectionSamples(ProcessedGestureLog);
+		BatchedInput = FVRGestureView(ProcessedGestureLog);
+	}
+	else
+	{
+		BatchedInput = SampleWindow.GetView();
+	}
+
+	BatchedScaler = GetDatabaseScaler(GesturesDB, BatchedInput.GestureSize);
+	PrepareRecognitionInput(GesturesDB, BatchedInput, BatchedScaler);
+	BatchedMinDist = MAX_FLT;
+	BatchedGestureIndex = INDEX_NONE;
+	return true;
+}
+
+void UVRGestureComponent::ScoreBatchedGesture(int GestureIndex)
+{
+	const FVRGesture & exampleGesture = GesturesDB->Gestures[GestureIndex];
+	const TArrayView<const FVector> ExampleSamples = GesturesDB->GetGestureSamples(GestureIndex, false);
+
+	float FinalScaler = 1.f;
+	bool bMirrorGesture = false;
+	float FirstDistance = 0.f;
+
+	if (!CheckFirstThreshold(GesturesDB, BatchedInput, GestureIndex, BatchedScaler, FinalScaler, bMirrorGesture, FirstDistance))
+		return;
+
+	if (!PassesPrefilter(GesturesDB, BatchedInput, GestureIndex, bMirrorGesture, FinalScaler))
+		return;
+
+	if (bUseLowerBoundPruning)
+	{
+		INC_DWORD_STAT(STAT_GestureLBCandidates);
+
+		// Gestures are walked in index order here, so the best match so far can be used as the limit directly
+		FBox InputBounds(BatchedInput.GestureSize.Min * FinalScaler, BatchedInput.GestureSize.Max * FinalScaler);
+		float CostLimit = FMath::Min(BatchedMinDist, FMath::Square(exampleGesture.GestureSettings.FullThreshold)) * ExampleSamples.Num();
+		float LowerBound = 0.f;
+
+		if (!PassesLowerBounds(InputBounds, GesturesDB->GetGestureEnvelope(GestureIndex), GesturesDB->GetGestureSamples(GestureIndex, bMirrorGesture), bMirrorGesture, FirstDistance, CostLimit, LowerBound))
+			return;
+	}
+
+	INC_DWORD_STAT(STAT_GestureFullDTW);
+	float d = GetGestureCost(GesturesDB, BatchedInput, GestureIndex, bMirrorGesture, FinalScaler) / (ExampleSamples.Num());
+	if (d < BatchedMinDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+	{
+		BatchedMinDist = d;
+		BatchedGestureIndex = GestureIndex;
+	}
+}
+
+void UVRGestureComponent::EndBatchedRecognition()
+{
+	bGestureChanged = false;
+
+	// Don't hold on to a view of the window past the pass
+	BatchedInput = FVRGestureView();
+
+	if (BatchedGestureIndex != INDEX_NONE)
+	{
+		BroadcastGestureDetected(BatchedGestureIndex);
+	}
+}
+
+int UVRGestureComponent::FindBestGesture(UGesturesDatabase * Database, const FVRGestureView & inputGesture, float & OutDistance)
+{
+	float minDist = MAX_FLT;
+
+	int OutGestureIndex = INDEX_NONE;
+	bool bMirrorGesture = false;
+
+	float Scaler = GetDatabaseScaler(Database, inputGesture.GestureSize);
+	float FinalScaler = Scaler;
+	float FirstDistance = 0.f;
+	float LowerBound = 0.f;
+
+	PrepareRecognitionInput(Database, inputGesture, Scaler);
+
+	const int32 CandidateCapacity = DTWWorkspace.Candidates.Max();
+
+	if (bUseLowerBoundPruning)
+		DTWWorkspace.Candidates.Reset();
+
+	// Only walks the gestures the prefilter index picked if it has one, they are in index order like the full walk
+	const bool bWalkPrefilterCandidates = bPrefilterInputValid && PrefilterInput.bHasCandidates;
+	const int32 WalkCount = bWalkPrefilterCandidates ? PrefilterInput.Candidates.Num() : Database->Gestures.Num();
+
+	for (int32 WalkIndex = 0; WalkIndex < WalkCount; WalkIndex++)
+	{
+		const int i = bWalkPrefilterCandidates ? PrefilterInput.Candidates[WalkIndex] : WalkIndex;
+		FVRGesture &exampleGesture = Database->Gestures[i];
+		const TArrayView<const FVector> ExampleSamples = Database->GetGestureSamples(i, false);
+
+		if (!CheckFirstThreshold(Database, inputGesture, i, Scaler, FinalScaler, bMirrorGesture, FirstDistance))
+			continue;
+
+		if (!PassesPrefilter(Database, inputGesture, i, bMirrorGesture, FinalScaler))
+			continue;
+
+		if (bUseLowerBoundPruning)
+		{
+			INC_DWORD_STAT(STAT_GestureLBCandidates);
+
+			FBox InputBounds(inputGesture.GestureSize.Min * FinalScaler, inputGesture.GestureSize.Max * FinalScaler);
+			float CostLimit = FMath::Square(exampleGesture.GestureSettings.FullThreshold) * ExampleSamples.Num();
+
+			if (PassesLowerBounds(InputBounds, Database->GetGestureEnvelope(i), Database->GetGestureSamples(i, bMirrorGesture), bMirrorGesture, FirstDistance, CostLimit, LowerBound))
+			{
+				DTWWorkspace.Candidates.Emplace(LowerBound / ExampleSamples.Num(), i, FinalScaler, bMirrorGesture);
+			}
+
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_GestureFullDTW);
+		float d = GetGestureCost(Database, inputGesture, i, bMirrorGesture, FinalScaler) / (ExampleSamples.Num());
+		if (d < minDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+		{
+			minDist = d;
+			OutGestureIndex = i;
+		}
+	}
+
+	if (bUseLowerBoundPruning)
+	{
+		CountWorkspaceGrowth(CandidateCapacity, DTWWorkspace.Candidates.Max());
+
+		// Most likely matches first so that the best match tightens as early as possible
+		DTWWorkspace.Candidates.Sort();
+
+		for (const FVRGestureCandidate & Candidate : DTWWorkspace.Candidates)
+		{
+			// Sorted, so nothing after this can beat the best match either
+			if (Candidate.LowerBound > minDist * GESTURE_LOWER_BOUND_SLACK)
+			{
+				INC_DWORD_STAT_BY(STAT_GesturePrunedBest, DTWWorkspace.Candidates.Num() - (&Candidate - DTWWorkspace.Candidates.GetData()));
+				break;
+			}
+
+			FVRGesture &exampleGesture = Database->Gestures[Candidate.GestureIndex];
+
+			const TArrayView<const FVector> ExampleSamples = Database->GetGestureSamples(Candidate.GestureIndex, false);
+
+			INC_DWORD_STAT(STAT_GestureFullDTW);
+			float d = GetGestureCost(Database, inputGesture, Candidate.GestureIndex, Candidate.bMirrorGesture, Candidate.Scaler) / (ExampleSamples.Num());
+
+			// Candidates aren't in index order anymore, break ties towards the lower index like the un-pruned loop does
+			if ((d < minDist || (d == minDist && Candidate.GestureIndex < OutGestureIndex)) && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+			{
+				minDist = d;
+				OutGestureIndex = Candidate.GestureIndex;
+			}
+		}
+	}
+
+	OutDistance = minDist;
+	return OutGestureIndex;
+}
+
+bool UVRGestureComponent::PassesLowerBounds(const FBox & InputBounds, const FVRGestureEnvelope & Envelope, TArrayView<const FVector> GestureSamples, bool bMirrorGesture, float FirstDistance, float CostLimit, float & OutBound)
+{
+	// Every warping path starts on the newest sample of both sequences and visits every gesture sample at least once,
+	// pairing it with some input sample that is inside of the input bounds.
+	const int GestureLength = GestureSamples.Num();
+	const float Limit = CostLimit * GESTURE_LOWER_BOUND_SLACK;
+
+	OutBound = FirstDistance;
+
+	if (GestureLength < 2)
+		return OutBound <= Limit;
+
+	// LB_Kim, the start point is exact and the end point is at least its distance to the input bounds.
+	// Everything between is at least the distance between the gesture envelope and the input bounds.
+	OutBound += InputBounds.ComputeSquaredDistanceToPoint(GestureSamples[GestureLength - 1]);
+	OutBound += (GestureLength - 2) * FVRGestureEnvelope::BoxDistSquared(InputBounds, bMirrorGesture ? Envelope.MirroredBounds : Envelope.Bounds);
+
+	if (OutBound > Limit)
+	{
+		INC_DWORD_STAT(STAT_GesturePrunedKim);
+		return false;
+	}
+
+	// LB_Keogh against the input envelope, each gesture sample is at least its distance to the input bounds
+	float KeoghBound = FirstDistance;
+	for (int j = 1; j < GestureLength; j++)
+	{
+		KeoghBound += InputBounds.ComputeSquaredDistanceToPoint(GestureSamples[j]);
+
+		if (KeoghBound > Limit)
+		{
+			OutBound = KeoghBound;
+			INC_DWORD_STAT(STAT_GesturePrunedKeogh);
+			return false;
+		}
+	}
+
+	OutBound = FMath::Max(OutBound, KeoghBound);
+	return true;
+}
+
+int UVRGestureComponent::FindBestGestureVectorized(UGesturesDatabase * Database, const FVRGestureView & inputGesture, float & OutDistance)
+{
+	float minDist = MAX_FLT;
+	int OutGestureIndex = INDEX_NONE;
+
+	float Scaler = GetDatabaseScaler(Database, inputGesture.GestureSize);
+
+	PrepareRecognitionInput(Database, inputGesture, Scaler);
+
+	float LaneScalers[VRGESTURE_SIMD_LANES];
+	float LaneYSigns[VRGESTURE_SIMD_LANES];
+	float LaneBestMatch[VRGESTURE_SIMD_LANES];
+	bool bLaneActive[VRGESTURE_SIMD_LANES];
+
+	TArrayView<const FVRGestureSIMDBatch> Batches = Database->GetSIMDBatches();
+	const float * PackedData = Database->GetSIMDSampleData();
+
+	for (const FVRGestureSIMDBatch & Batch : Batches)
+	{
+		bool bAnyLaneActive = false;
+
+		// Same early outs as the scalar path, decided per lane
+		for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+		{
+			bLaneActive[Lane] = false;
+			LaneScalers[Lane] = 1.f;
+			LaneYSigns[Lane] = 1.f;
+
+			if (Batch.GestureIndices[Lane] == INDEX_NONE)
+				continue;
+
+			FVRGesture &exampleGesture = Database->Gestures[Batch.GestureIndices[Lane]];
+
+			const TArrayView<const FVector> ExampleSamples = Database->GetGestureSamples(Batch.GestureIndices[Lane], false);
+
+			if (!exampleGesture.GestureSettings.bEnabled || ExampleSamples.Num() < 1 || inputGesture.Samples.Num() < exampleGesture.GestureSettings.Minimum_Gesture_Length)
+				continue;
+
+			LaneScalers[Lane] = exampleGesture.GestureSettings.bEnableScaling ? Scaler : 1.f;
+
+			bool bMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand != EVRGestureMirrorMode::GES_MirrorBoth && MirroringHand == exampleGesture.GestureSettings.MirrorMode);
+
+			if (GetGestureDistance(inputGesture.Samples[0] * LaneScalers[Lane], ExampleSamples[0], bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold))
+			{
+				bLaneActive[Lane] = true;
+			}
+			else if (exampleGesture.GestureSettings.MirrorMode == EVRGestureMirrorMode::GES_MirrorBoth)
+			{
+				bMirrorGesture = true;
+				bLaneActive[Lane] = GetGestureDistance(inputGesture.Samples[0] * LaneScalers[Lane], ExampleSamples[0], bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold);
+			}
+
+			LaneYSigns[Lane] = bMirrorGesture ? -1.f : 1.f;
+
+			if (bLaneActive[Lane])
+				bLaneActive[Lane] = PassesPrefilter(Database, inputGesture, Batch.GestureIndices[Lane], bMirrorGesture, LaneScalers[Lane]);
+
+			if (bLaneActive[Lane] && bUseLowerBoundPruning)
+			{
+				INC_DWORD_STAT(STAT_GestureLBCandidates);
+
+				FBox InputBounds(inputGesture.GestureSize.Min * LaneScalers[Lane], inputGesture.GestureSize.Max * LaneScalers[Lane]);
+				float CostLimit = FMath::Min(minDist, FMath::Square(exampleGesture.GestureSettings.FullThreshold)) * ExampleSamples.Num();
+				float FirstDistance = GetGestureDistance(inputGesture.Samples[0] * LaneScalers[Lane], ExampleSamples[0], bMirrorGesture);
+				float LowerBound = 0.f;
+
+				bLaneActive[Lane] = PassesLowerBounds(InputBounds, Database->GetGestureEnvelope(Batch.GestureIndices[Lane]), Database->GetGestureSamples(Batch.GestureIndices[Lane], bMirrorGesture), bMirrorGesture, FirstDistance, CostLimit, LowerBound);
+			}
+
+			// Windowed gestures don't fit the batch kernel, score them on their own
+			if (bLaneActive[Lane] && exampleGesture.GestureSettings.WarpingWindow != EVRGestureWarpingWindow::GES_NoWindow)
+			{
+				bLaneActive[Lane] = false;
+
+				INC_DWORD_STAT(STAT_GestureFullDTW);
+				float d = dtwWindowed(inputGesture, Database->GetGestureSamples(Batch.GestureIndices[Lane], bMirrorGesture), exampleGesture.GestureSettings, LaneScalers[Lane]) / (ExampleSamples.Num());
+				if ((d < minDist || (d == minDist && Batch.GestureIndices[Lane] < OutGestureIndex)) && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+				{
+					minDist = d;
+					OutGestureIndex = Batch.GestureIndices[Lane];
+				}
+			}
+
+			bAnyLaneActive |= bLaneActive[Lane];
+		}
+
+		if (!bAnyLaneActive)
+			continue;
+
+		INC_DWORD_STAT(STAT_GestureFullDTW);
+		dtwBatch(inputGesture, Batch, PackedData, LaneScalers, LaneYSigns, LaneBestMatch);
+
+		for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+		{
+			if (!bLaneActive[Lane])
+				continue;
+
+			const int GestureIndex = Batch.GestureIndices[Lane];
+			FVRGesture &exampleGesture = Database->Gestures[GestureIndex];
+			const TArrayView<const FVector> ExampleSamples = Database->GetGestureSamples(GestureIndex, false);
+
+			float d = LaneBestMatch[Lane] / (ExampleSamples.Num());
+
+			// Batches are ordered by length, so break ties towards the lower index like the scalar path does
+			if ((d < minDist || (d == minDist && GestureIndex < OutGestureIndex)) && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+			{
+				minDist = d;
+				OutGestureIndex = GestureIndex;
+			}
+		}
+	}
+
+	OutDistance = minDist;
+	return OutGestureIndex;
+}
+
+void UVRGestureComponent::InitStreamingStates()
+{
+	StreamingStates.Reset();
+	StreamingSampleCount = 0;
+	StreamingStatesDB = GesturesDB;
+	StreamingStatesGestureCount = GesturesDB ? GesturesDB->Gestures.Num() : 0;
+
+	GestureProgress.Reset();
+	GestureProgress.AddZeroed(StreamingStatesGestureCount);
+
+	if (!GesturesDB)
+		return;
+
+	GesturesDB->UpdateGestureCache();
+
+	for (int i = 0; i < GesturesDB->Gestures.Num(); i++)
+	{
+		FVRGesture &exampleGesture = GesturesDB->Gestures[i];
+		const TArrayView<const FVector> ExampleSamples = GesturesDB->GetGestureSamples(i, false);
+
+		bool bMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand != EVRGestureMirrorMode::GES_MirrorBoth && MirroringHand == exampleGesture.GestureSettings.MirrorMode);
+		int StateIndex = StreamingStates.AddDefaulted();
+		StreamingStates[StateIndex].Init(i, ExampleSamples.Num(), bMirrorGesture);
+
+		// Both mode checks the mirrored gesture as well, so it needs its own running row
+		if (!bMirrorGesture && exampleGesture.GestureSettings.MirrorMode == EVRGestureMirrorMode::GES_MirrorBoth)
+		{
+			StateIndex = StreamingStates.AddDefaulted();
+			StreamingStates[StateIndex].Init(i, ExampleSamples.Num(), true);
+		}
+	}
+}
+
+void UVRGestureComponent::UpdateStreamingStates(const FVector & NewSample)
+{
+	if (!GesturesDB)
+		return;
+
+	// Database was swapped or had gestures added / removed since we built the states
+	if (StreamingStatesDB != GesturesDB || StreamingStatesGestureCount != GesturesDB->Gestures.Num())
+	{
+		InitStreamingStates();
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+
+	GesturesDB->UpdateGestureCache();
+
+	float Scaler = GetDatabaseScaler(SampleWindow.GetBounds());
+
+	for (FVRGestureStreamingState & State : StreamingStates)
+	{
+		FVRGesture &exampleGesture = GesturesDB->Gestures[State.GestureIndex];
+		const TArrayView<const FVector> ExampleSamples = GesturesDB->GetGestureSamples(State.GestureIndex, false);
+
+		// Gesture was re-recorded or recalculated at a different length
+		if (State.LookupRow.Num() != ExampleSamples.Num() + 1)
+		{
+			const int32 PreviousCapacity = State.LookupRow.Max();
+			State.Init(State.GestureIndex, ExampleSamples.Num(), State.bMirrorGesture);
+			CountWorkspaceGrowth(PreviousCapacity, State.LookupRow.Max());
+		}
+
+		if (ExampleSamples.Num() < 1)
+			continue;
+
+		State.AddSample(exampleGesture.GestureSettings.bEnableScaling ? NewSample * Scaler : NewSample, GesturesDB->GetGestureSamples(State.GestureIndex, State.bMirrorGesture), StreamingSampleCount, RecordingBufferSize, maxSlope, FMath::Square(exampleGesture.GestureSettings.FullThreshold));
+	}
+
+	StreamingSampleCount++;
+}
+
+void FVRGestureStreamingState::AddSample(const FVector & Sample, TArrayView<const FVector> GestureSamples, int SampleIndex, int WindowSize, int MaxSlope, float PrefixThreshold)
+{
+	const int ColumnCount = LookupRow.Num();
+	const int GestureLength = GestureSamples.Num();
+
+	// dtw() only sees the samples in the window, paths that started on an older sample can't be extended
+	const int OldestStart = SampleIndex - WindowSize + 1;
+
+	// The previous rows value in the free starting column, every sample is allowed to begin the gesture
+	float DiagonalCost = 0.f;
+	int DiagonalStart = SampleIndex;
+
+	LookupRow[0] = 0.f;
+	PathStart[0] = SampleIndex;
+	PrefixLength = 0;
+
+	for (int j = 1; j < ColumnCount; j++)
+	{
+		const float Distance = FVector::DistSquared(Sample, GestureSamples[GestureLength - j]);
+
+		// Values from the previous row, they get overwritten below
+		const int UpStart = PathStart[j];
+		const float UpCost = UpStart >= OldestStart ? LookupRow[j] : MAX_FLT;
+		const float LeftCost = PathStart[j - 1] >= OldestStart ? LookupRow[j - 1] : MAX_FLT;
+
+		// Same step choice and slope bookkeeping as dtw()
+		if (
+			LeftCost < DiagonalCost &&
+			LeftCost < UpCost &&
+			SlopeI[j - 1] < MaxSlope)
+		{
+			LookupRow[j] = Distance + LeftCost;
+			SlopeI[j] = SlopeJ[j - 1] + 1;
+			SlopeJ[j] = 0;
+			PathStart[j] = PathStart[j - 1];
+		}
+		else if (
+			UpCost < DiagonalCost &&
+			UpCost < LeftCost &&
+			SlopeJ[j] < MaxSlope)
+		{
+			LookupRow[j] = Distance + UpCost;
+			SlopeI[j] = 0;
+			SlopeJ[j] = SlopeJ[j] + 1;
+		}
+		else
+		{
+			LookupRow[j] = Distance + DiagonalCost;
+			SlopeI[j] = 0;
+			SlopeJ[j] = 0;
+			PathStart[j] = DiagonalStart;
+		}
+
+		// Each column is the cost of matching the first j gesture samples, so the prefix progress falls out of the row for free
+		if (LookupRow[j] < PrefixThreshold * j)
+			PrefixLength = j;
+
+		DiagonalCost = UpCost;
+		DiagonalStart = UpStart;
+	}
+
+	LastMatchCost = LookupRow[ColumnCount - 1];
+	LastMatchStart = PathStart[ColumnCount - 1];
+}
+
+void UVRGestureComponent::UpdateGestureProgress()
+{
+	if (!GesturesDB || StreamingStatesDB != GesturesDB || StreamingStatesGestureCount != GesturesDB->Gestures.Num())
+		return;
+
+	// States for the same gesture are next to each other (normal then mirrored), the best of them is used
+	int StateIndex = 0;
+	while (StateIndex < StreamingStates.Num())
+	{
+		const int GestureIndex = StreamingStates[StateIndex].GestureIndex;
+		const FVRGesture & exampleGesture = GesturesDB->Gestures[GestureIndex];
+		const TArrayView<const FVector> ExampleSamples = GesturesDB->GetGestureSamples(GestureIndex, false);
+		float Progress = 0.f;
+
+		for (; StateIndex < StreamingStates.Num() && StreamingStates[StateIndex].GestureIndex == GestureIndex; ++StateIndex)
+		{
+			const FVRGestureStreamingState & State = StreamingStates[StateIndex];
+
+			if (!exampleGesture.GestureSettings.bEnabled || ExampleSamples.Num() < 1 || State.PrefixLength < 1)
+				continue;
+
+			// Path started on a sample that has since fallen out of the buffer
+			if (StreamingSampleCount - State.PathStart[State.PrefixLength] > RecordingBufferSize)
+				continue;
+
+			Progress = FMath::Max(Progress, (float)State.PrefixLength / ExampleSamples.Num());
+		}
+
+		const float LastProgress = GestureProgress[GestureIndex];
+		GestureProgress[GestureIndex] = Progress;
+
+		if (LastProgress < GestureProgressThreshold && Progress >= GestureProgressThreshold)
+		{
+			OnGestureProgress_Bind.Broadcast(exampleGesture.GestureType, exampleGesture.Name, GestureIndex, Progress, GesturesDB);
+		}
+	}
+}
+
+void UVRGestureComponent::RecognizeGestureStreaming()
+{
+	if (!GesturesDB || SampleWindow.Num() < 1 || !bGestureChanged)
+		return;
+
+	if (StreamingStatesDB != GesturesDB || StreamingStatesGestureCount != GesturesDB->Gestures.Num())
+		return;
+
+	float minDist = MAX_FLT;
+	int OutGestureIndex = -1;
+
+	float Scaler = GetDatabaseScaler(SampleWindow.GetBounds());
+	float FinalScaler = Scaler;
+
+	for (const FVRGestureStreamingState & State : StreamingStates)
+	{
+		FVRGesture &exampleGesture = GesturesDB->Gestures[State.GestureIndex];
+		const TArrayView<const FVector> ExampleSamples = GesturesDB->GetGestureSamples(State.GestureIndex, false);
+
+		if (!exampleGesture.GestureSettings.bEnabled || ExampleSamples.Num() < 1 || SampleWindow.Num() < exampleGesture.GestureSettings.Minimum_Gesture_Length)
+			continue;
+
+		// Path started on a sample that has since fallen out of the buffer
+		if (StreamingSampleCount - State.LastMatchStart > RecordingBufferSize)
+			continue;
+
+		FinalScaler = exampleGesture.GestureSettings.bEnableScaling ? Scaler : 1.f;
+
+		if (GetGestureDistance(SampleWindow.GetNewest() * FinalScaler, ExampleSamples[0], State.bMirrorGesture) < FMath::Square(exampleGesture.GestureSettings.firstThreshold))
+		{
+			float d = State.LastMatchCost / (ExampleSamples.Num());
+			if (d < minDist && d < FMath::Square(exampleGesture.GestureSettings.FullThreshold))
+			{
+				minDist = d;
+				OutGestureIndex = State.GestureIndex;
+			}
+		}
+	}
+
+	if (OutGestureIndex != -1)
+	{
+		BroadcastGestureDetected(OutGestureIndex);
+	}
+}
+
+void UVRGestureComponent::SizeDTWWorkspace()
+{
+	int LongestGesture = 0;
+
+	if (GesturesDB)
+	{
+		GesturesDB->UpdateGestureCache();
+
+		for (int i = 0; i < GesturesDB->Gestures.Num(); ++i)
+		{
+			LongestGesture = FMath::Max(LongestGesture, GesturesDB->GetGestureSampleCount(i));
+		}
+	}
+
+	DTWWorkspace.Reserve(RecordingBufferSize + 1, LongestGesture + 1);
+	DTWWorkspace.ReserveCandidates(GesturesDB ? GesturesDB->Gestures.Num() : 0);
+}
+
+float UVRGestureComponent::dtw(const FVRGestureView & seq1, TArrayView<const FVector> seq2, float Scaler)
+{
+
+	// Should also be able to get SizeSquared for values and compared to squared thresholds instead of doing the full SQRT calc.
+
+	// Getting number of average samples recorded over of a gesture (top down) may be able to achieve a basic % completed check
+	// to see how far into detecting a gesture we are, this would require ignoring the last position threshold though....
+
+	int RowCount = seq1.Samples.Num() + 1;
+	int ColumnCount = seq2.Num() + 1;
+
+	// Only allocates if the database or buffer grew since the workspace was sized
+	if (DTWWorkspace.SetTableSize(RowCount, ColumnCount))
+	{
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+
+	TArray<float> & LookupTable = DTWWorkspace.LookupTable;
+	TArray<int> & SlopeI = DTWWorkspace.SlopeI;
+	TArray<int> & SlopeJ = DTWWorkspace.SlopeJ;
+
+	// Every inner cell is written before it is read, so only the first row and column need initializing
+	LookupTable[0] = 0.f;
+	SlopeI[0] = 0;
+	SlopeJ[0] = 0;
+
+	for (int j = 1; j < ColumnCount; j++)
+	{
+		LookupTable[j] = MAX_FLT;
+		SlopeI[j] = 0;
+		SlopeJ[j] = 0;
+	}
+
+	for (int i = 1; i < RowCount; i++)
+	{
+		LookupTable[i * ColumnCount] = MAX_FLT;
+		SlopeI[i * ColumnCount] = 0;
+		SlopeJ[i * ColumnCount] = 0;
+	}
+
+	int icol = 0, icolneg = 0;
+
+	// Dynamic computation of the DTW matrix.
+	for (int i = 1; i < RowCount; i++)
+	{
+		for (int j = 1; j < ColumnCount; j++)
+		{
+			icol = i * ColumnCount;
+			icolneg = icol - ColumnCount;// (i - 1) * ColumnCount;
+
+			if (
+				LookupTable[icol + (j - 1)] < LookupTable[icolneg + (j - 1)] &&
+				LookupTable[icol + (j - 1)] < LookupTable[icolneg + j] &&
+				SlopeI[icol + (j - 1)] < maxSlope)
+			{
+				LookupTable[icol + j] = FVector::DistSquared(seq1.Samples[i - 1] * Scaler, seq2[j - 1]) + LookupTable[icol + j - 1];
+				SlopeI[icol + j] = SlopeJ[icol + j - 1] + 1;
+				SlopeJ[icol + j] = 0;
+			}
+			else if (
+				LookupTable[icolneg + j] < LookupTable[icolneg + j - 1] &&
+				LookupTable[icolneg + j] < LookupTable[icol + j - 1] &&
+				SlopeJ[icolneg + j] < maxSlope)
+			{
+				LookupTable[icol + j] = FVector::DistSquared(seq1.Samples[i - 1] * Scaler, seq2[j - 1]) + LookupTable[icolneg + j];
+				SlopeI[icol + j] = 0;
+				SlopeJ[icol + j] = SlopeJ[icolneg + j] + 1;
+			}
+			else
+			{
+				LookupTable[icol + j] = FVector::DistSquared(seq1.Samples[i - 1] * Scaler, seq2[j - 1]) + LookupTable[icolneg + j - 1];
+				SlopeI[icol + j] = 0;
+				SlopeJ[icol + j] = 0;
+			}
+		}
+	}
+
+	// Find best between seq2 and an ending (postfix) of seq1.
+	float bestMatch = FLT_MAX;
+
+	for (int i = 1; i < seq1.Samples.Num() + 1/* - seq2.Minimum_Gesture_Length*/; i++)
+	{
+		if (LookupTable[(i*ColumnCount) + seq2.Num()] < bestMatch)
+		bestMatch = LookupTable[(i*ColumnCount) + seq2.Num()];
+	}
+
+	return bestMatch;
+}
+
+void UVRGestureComponent::PrepareRecognitionInput(const UGesturesDatabase * Database, const FVRGestureView & seq1, float Scaler)
+{
+	QuantizeInput(Database, seq1, Scaler);
+
+	bPrefilterInputValid = Database && Database->Prefilter;
+
+	if (bPrefilterInputValid)
+	{
+		const int32 PreviousCapacity = PrefilterInput.GetCapacity();
+		Database->Prefilter->BuildInputFeatures(seq1, PrefilterInput);
+		Database->Prefilter->GatherCandidates(PrefilterInput, Scaler, Database->Gestures.Num());
+		CountWorkspaceGrowth(PreviousCapacity, PrefilterInput.GetCapacity());
+
+		if (PrefilterInput.bHasCandidates)
+			INC_DWORD_STAT_BY(STAT_GestureSkippedPrefilterIndex, Database->Gestures.Num() - PrefilterInput.Candidates.Num());
+	}
+}
+
+bool UVRGestureComponent::PassesPrefilter(const UGesturesDatabase * Database, const FVRGestureView & seq1, int GestureIndex, bool bMirrorGesture, float Scaler)
+{
+	if (!bPrefilterInputValid || !Database->Prefilter)
+		return true;
+
+	// Ruled out by the prefilter index, it was already counted when the candidates were gathered
+	if (!PrefilterInput.IsCandidate(GestureIndex))
+		return false;
+
+	if (Database->Prefilter->TestGesture(seq1, PrefilterInput, Scaler, GestureIndex, bMirrorGesture))
+		return true;
+
+	INC_DWORD_STAT(STAT_GesturePrunedPrefilter);
+	return false;
+}
+
+void UVRGestureComponent::QuantizeInput(const UGesturesDatabase * Database, const FVRGestureView & seq1, float Scaler)
+{
+	bQuantizedInputValid = Database && Database->bUseQuantizedSamples;
+
+	if (!bQuantizedInputValid)
+		return;
+
+	const float QuantizeScale = Scaler * Database->GetQuantizeScale();
+
+	// Keeps its allocation, the input is at most the buffer size
+	const int32 PreviousCapacity = QuantizedInput.Max();
+	QuantizedInput.Reset();
+
+	for (const FVector & Sample : seq1.Samples)
+	{
+		QuantizedInput.Emplace(Sample, QuantizeScale);
+	}
+
+	CountWorkspaceGrowth(PreviousCapacity, QuantizedInput.Max());
+}
+
+float UVRGestureComponent::dtwQuantized(TArrayView<const FVRGestureQuantizedSample> seq1, TArrayView<const FVRGestureQuantizedSample> seq2, float DistanceScale)
+{
+	int RowCount = seq1.Num() + 1;
+	int ColumnCount = seq2.Num() + 1;
+
+	if (DTWWorkspace.SetTableSize(RowCount, ColumnCount))
+	{
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+
+	TArray<float> & LookupTable = DTWWorkspace.LookupTable;
+	TArray<int> & SlopeI = DTWWorkspace.SlopeI;
+	TArray<int> & SlopeJ = DTWWorkspace.SlopeJ;
+
+	LookupTable[0] = 0.f;
+	SlopeI[0] = 0;
+	SlopeJ[0] = 0;
+
+	for (int j = 1; j < ColumnCount; j++)
+	{
+		LookupTable[j] = MAX_FLT;
+		SlopeI[j] = 0;
+		SlopeJ[j] = 0;
+	}
+
+	for (int i = 1; i < RowCount; i++)
+	{
+		LookupTable[i * ColumnCount] = MAX_FLT;
+		SlopeI[i * ColumnCount] = 0;
+		SlopeJ[i * ColumnCount] = 0;
+	}
+
+	// Same step rules as dtw(), only the distance differs. Costs are still accumulated as floats, the sums would overflow an int32.
+	for (int i = 1; i < RowCount; i++)
+	{
+		const FVRGestureQuantizedSample & InputSample = seq1[i - 1];
+		const int icol = i * ColumnCount;
+		const int icolneg = icol - ColumnCount;
+
+		for (int j = 1; j < ColumnCount; j++)
+		{
+			const float Distance = InputSample.DistSquared(seq2[j - 1]) * DistanceScale;
+
+			if (
+				LookupTable[icol + (j - 1)] < LookupTable[icolneg + (j - 1)] &&
+				LookupTable[icol + (j - 1)] < LookupTable[icolneg + j] &&
+				SlopeI[icol + (j - 1)] < maxSlope)
+			{
+				LookupTable[icol + j] = Distance + LookupTable[icol + j - 1];
+				SlopeI[icol + j] = SlopeJ[icol + j - 1] + 1;
+				SlopeJ[icol + j] = 0;
+			}
+			else if (
+				LookupTable[icolneg + j] < LookupTable[icolneg + j - 1] &&
+				LookupTable[icolneg + j] < LookupTable[icol + j - 1] &&
+				SlopeJ[icolneg + j] < maxSlope)
+			{
+				LookupTable[icol + j] = Distance + LookupTable[icolneg + j];
+				SlopeI[icol + j] = 0;
+				SlopeJ[icol + j] = SlopeJ[icolneg + j] + 1;
+			}
+			else
+			{
+				LookupTable[icol + j] = Distance + LookupTable[icolneg + j - 1];
+				SlopeI[icol + j] = 0;
+				SlopeJ[icol + j] = 0;
+			}
+		}
+	}
+
+	float bestMatch = FLT_MAX;
+
+	for (int i = 1; i < RowCount; i++)
+	{
+		if (LookupTable[(i * ColumnCount) + seq2.Num()] < bestMatch)
+			bestMatch = LookupTable[(i * ColumnCount) + seq2.Num()];
+	}
+
+	return bestMatch;
+}
+
+float UVRGestureComponent::dtwWindowed(const FVRGestureView & seq1, TArrayView<const FVector> seq2, const FVRGestureSettings & Settings, float Scaler)
+{
+	const int InputLength = seq1.Samples.Num();
+	const int GestureLength = seq2.Num();
+	const int ColumnCount = GestureLength + 1;
+
+	// Only the previous and current rows are needed, anything outside of the window reads as unreachable
+	if (DTWWorkspace.SetTableSize(2, ColumnCount))
+	{
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+
+	float * PrevCost = DTWWorkspace.LookupTable.GetData();
+	float * CurCost = PrevCost + ColumnCount;
+	int * PrevSlopeI = DTWWorkspace.SlopeI.GetData();
+	int * CurSlopeI = PrevSlopeI + ColumnCount;
+	int * PrevSlopeJ = DTWWorkspace.SlopeJ.GetData();
+	int * CurSlopeJ = PrevSlopeJ + ColumnCount;
+
+	// Row 0 only holds the starting cell
+	PrevCost[0] = 0.f;
+	PrevSlopeI[0] = 0;
+	PrevSlopeJ[0] = 0;
+	int PrevLow = 0;
+	int PrevHigh = 0;
+
+	int RowLow = 0;
+	int RowHigh = 0;
+	float bestMatch = FLT_MAX;
+
+	const int LastRow = Settings.GetWindowLastRow(InputLength, GestureLength);
+
+	for (int i = 1; i <= LastRow; i++)
+	{
+		if (!Settings.GetWindowRange(i, InputLength, GestureLength, RowLow, RowHigh))
+		{
+			// Empty row, nothing in the next one can be reached from here
+			PrevLow = 1;
+			PrevHigh = 0;
+			continue;
+		}
+
+		const FVector InputSample = seq1.Samples[i - 1] * Scaler;
+
+		for (int j = RowLow; j <= RowHigh; j++)
+		{
+			const bool bLeftValid = j - 1 >= RowLow;
+			const bool bUpValid = j >= PrevLow && j <= PrevHigh;
+			const bool bDiagonalValid = j - 1 >= PrevLow && j - 1 <= PrevHigh;
+
+			const float LeftCost = bLeftValid ? CurCost[j - 1] : MAX_FLT;
+			const float UpCost = bUpValid ? PrevCost[j] : MAX_FLT;
+			const float DiagonalCost = bDiagonalValid ? PrevCost[j - 1] : MAX_FLT;
+			const int LeftSlopeI = bLeftValid ? CurSlopeI[j - 1] : 0;
+			const int LeftSlopeJ = bLeftValid ? CurSlopeJ[j - 1] : 0;
+			const int UpSlopeJ = bUpValid ? PrevSlopeJ[j] : 0;
+
+			const float Distance = FVector::DistSquared(InputSample, seq2[j - 1]);
+
+			if (LeftCost < DiagonalCost && LeftCost < UpCost && LeftSlopeI < maxSlope)
+			{
+				CurCost[j] = Distance + LeftCost;
+				CurSlopeI[j] = LeftSlopeJ + 1;
+				CurSlopeJ[j] = 0;
+			}
+			else if (UpCost < DiagonalCost && UpCost < LeftCost && UpSlopeJ < maxSlope)
+			{
+				CurCost[j] = Distance + UpCost;
+				CurSlopeI[j] = 0;
+				CurSlopeJ[j] = UpSlopeJ + 1;
+			}
+			else
+			{
+				CurCost[j] = Distance + DiagonalCost;
+				CurSlopeI[j] = 0;
+				CurSlopeJ[j] = 0;
+			}
+		}
+
+		if (RowHigh == GestureLength && CurCost[GestureLength] < bestMatch)
+			bestMatch = CurCost[GestureLength];
+
+		Swap(PrevCost, CurCost);
+		Swap(PrevSlopeI, CurSlopeI);
+		Swap(PrevSlopeJ, CurSlopeJ);
+		PrevLow = RowLow;
+		PrevHigh = RowHigh;
+	}
+
+	return bestMatch;
+}
+
+void UVRGestureComponent::dtwBatch(const FVRGestureView & seq1, const FVRGestureSIMDBatch & Batch, const float * PackedData, const float * Scalers, const float * YSigns, float * OutBestMatch)
+{
+	// Mirrors dtw() exactly, including its step rules and slope counters, but with the choice between steps done as a select per lane.
+	// Only the previous and current rows are kept as we only need the last column of each row.
+	const int RowCount = seq1.Samples.Num() + 1;
+	const int ColumnCount = Batch.MaxLength + 1;
+	const int RowSize = ColumnCount * VRGESTURE_SIMD_LANES;
+
+	if (DTWWorkspace.SetBatchRowSize(ColumnCount))
+	{
+		INC_DWORD_STAT(STAT_GestureDTWAllocations);
+	}
+
+	float * PrevCost = DTWWorkspace.BatchRows.GetData();
+	float * CurCost = PrevCost + RowSize;
+	float * PrevSlopeI = CurCost + RowSize;
+	float * CurSlopeI = PrevSlopeI + RowSize;
+	float * PrevSlopeJ = CurSlopeI + RowSize;
+	float * CurSlopeJ = PrevSlopeJ + RowSize;
+
+	for (int j = 0; j < RowSize; j++)
+	{
+		PrevCost[j] = j < VRGESTURE_SIMD_LANES ? 0.f : MAX_FLT;
+		PrevSlopeI[j] = 0.f;
+		PrevSlopeJ[j] = 0.f;
+	}
+
+	for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+	{
+		OutBestMatch[Lane] = FLT_MAX;
+	}
+
+	const VectorRegister ScalerV = VectorLoad(Scalers);
+	const VectorRegister YSignV = VectorLoad(YSigns);
+	const VectorRegister MaxSlopeV = VectorSetFloat1((float)maxSlope);
+	const VectorRegister MaxCostV = VectorSetFloat1(MAX_FLT);
+	const VectorRegister ZeroV = VectorZero();
+	const VectorRegister OneV = VectorOne();
+
+	const float * TemplateX = Batch.GetX(PackedData);
+	const float * TemplateY = Batch.GetY(PackedData);
+	const float * TemplateZ = Batch.GetZ(PackedData);
+
+	for (int i = 1; i < RowCount; i++)
+	{
+		const FVector & InputSample = seq1.Samples[i - 1];
+		const VectorRegister InputX = VectorMultiply(VectorSetFloat1(InputSample.X), ScalerV);
+		const VectorRegister InputY = VectorMultiply(VectorSetFloat1(InputSample.Y), ScalerV);
+		const VectorRegister InputZ = VectorMultiply(VectorSetFloat1(InputSample.Z), ScalerV);
+
+		// First column is never reachable except for [0, 0]
+		VectorStore(MaxCostV, CurCost);
+		VectorStore(ZeroV, CurSlopeI);
+		VectorStore(ZeroV, CurSlopeJ);
+
+		VectorRegister LeftCost = MaxCostV;
+		VectorRegister LeftSlopeJ = ZeroV;
+		VectorRegister LeftSlopeI = ZeroV;
+		VectorRegister DiagonalCost = VectorLoad(PrevCost);
+
+		for (int j = 1; j < ColumnCount; j++)
+		{
+			const int Cell = j * VRGESTURE_SIMD_LANES;
+			const int Sample = Cell - VRGESTURE_SIMD_LANES;
+
+			const VectorRegister UpCost = VectorLoad(PrevCost + Cell);
+			const VectorRegister UpSlopeJ = VectorLoad(PrevSlopeJ + Cell);
+
+			const VectorRegister DeltaX = VectorSubtract(VectorLoad(TemplateX + Sample), InputX);
+			const VectorRegister DeltaY = VectorSubtract(VectorMultiply(VectorLoad(TemplateY + Sample), YSignV), InputY);
+			const VectorRegister DeltaZ = VectorSubtract(VectorLoad(TemplateZ + Sample), InputZ);
+			const VectorRegister Distance = VectorAdd(VectorAdd(VectorMultiply(DeltaX, DeltaX), VectorMultiply(DeltaY, DeltaY)), VectorMultiply(DeltaZ, DeltaZ));
+
+			const VectorRegister bHorizontal = VectorBitwiseAnd(VectorBitwiseAnd(VectorCompareGT(DiagonalCost, LeftCost), VectorCompareGT(UpCost, LeftCost)), VectorCompareGT(MaxSlopeV, LeftSlopeI));
+			const VectorRegister bVertical = VectorBitwiseAnd(VectorBitwiseAnd(VectorCompareGT(DiagonalCost, UpCost), VectorCompareGT(LeftCost, UpCost)), VectorCompareGT(MaxSlopeV, UpSlopeJ));
+
+			const VectorRegister NewCost = VectorAdd(Distance, VectorSelect(bHorizontal, LeftCost, VectorSelect(bVertical, UpCost, DiagonalCost)));
+			const VectorRegister NewSlopeI = VectorSelect(bHorizontal, VectorAdd(LeftSlopeJ, OneV), ZeroV);
+			const VectorRegister NewSlopeJ = VectorSelect(bHorizontal, ZeroV, VectorSelect(bVertical, VectorAdd(UpSlopeJ, OneV), ZeroV));
+
+			VectorStore(NewCost, CurCost + Cell);
+			VectorStore(NewSlopeI, CurSlopeI + Cell);
+			VectorStore(NewSlopeJ, CurSlopeJ + Cell);
+
+			LeftCost = NewCost;
+			LeftSlopeI = NewSlopeI;
+			LeftSlopeJ = NewSlopeJ;
+			DiagonalCost = UpCost;
+		}
+
+		// Each lane ends on its own gestures last column
+		for (int Lane = 0; Lane < VRGESTURE_SIMD_LANES; ++Lane)
+		{
+			const float LaneCost = CurCost[Batch.Lengths[Lane] * VRGESTURE_SIMD_LANES + Lane];
+			if (LaneCost < OutBestMatch[Lane])
+				OutBestMatch[Lane] = LaneCost;
+		}
+
+		Swap(PrevCost, CurCost);
+		Swap(PrevSlopeI, CurSlopeI);
+		Swap(PrevSlopeJ, CurSlopeJ);
+	}
+}
+
+void UGesturesDatabase::BuildGestureEnvelopes()
+{
+	GestureEnvelopes.Reset();
+	GestureEnvelopes.AddDefaulted(Gestures.Num());
+
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		GestureEnvelopes[i].Build(Gestures[i].Samples);
+	}
+}
+
+void UGesturesDatabase::BuildMirroredSamples()
+{
+	MirroredSampleData.Reset();
+	MirroredSampleOffsets.Reset();
+	MirroredSampleOffsets.AddUninitialized(Gestures.Num());
+	GestureSampleCounts.Reset();
+	GestureSampleCounts.AddUninitialized(Gestures.Num());
+
+	int32 MirroredCount = 0;
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		const FVRGesture & Gesture = Gestures[i];
+		GestureSampleCounts[i] = Gesture.Samples.Num();
+
+		if (Gesture.GestureSettings.MirrorMode != EVRGestureMirrorMode::GES_NoMirror)
+			MirroredCount += Gesture.Samples.Num();
+	}
+
+	MirroredSampleData.Reserve(MirroredCount);
+
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		MirroredSampleOffsets[i] = INDEX_NONE;
+
+		if (Gestures[i].GestureSettings.MirrorMode == EVRGestureMirrorMode::GES_NoMirror)
+			continue;
+
+		MirroredSampleOffsets[i] = MirroredSampleData.Num();
+
+		for (const FVector & Sample : Gestures[i].Samples)
+		{
+			MirroredSampleData.Add(FVector(Sample.X, -Sample.Y, Sample.Z));
+		}
+	}
+}
+
+void UGesturesDatabase::BuildQuantizedSamples()
+{
+	QuantizedSampleData.Reset();
+	QuantizedSampleOffsets.Reset();
+
+	if (!bUseQuantizedSamples)
+	{
+		QuantizedSampleData.Empty();
+		QuantizedSampleOffsets.Empty();
+		return;
+	}
+
+	QuantizedSampleOffsets.AddUninitialized(Gestures.Num() * 2);
+	const float QuantizeScale = GetQuantizeScale();
+
+	for (int i = 0; i < Gestures.Num(); ++i)
+	{
+		const FVRGesture & Gesture = Gestures[i];
+		const TArrayView<const FVector> Samples = GetGestureSamples(i, false);
+		QuantizedSampleOffsets[i * 2] = INDEX_NONE;
+		QuantizedSampleOffsets[i * 2 + 1] = INDEX_NONE;
+
+		// Gestures that don't scale aren't bound to the database scale, so they can't be quantized to it
+		if (!Gesture.GestureSettings.bEnableScaling || Samples.Num() < 1)
+			continue;
+
+		QuantizedSampleOffsets[i * 2] = QuantizedSampleData.Num();
+
+		for (const FVector & Sample : Samples)
+		{
+			QuantizedSampleData.Emplace(Sample, QuantizeScale);
+		}
+
+		if (Gesture.GestureSettings.MirrorMode != EVRGestureMirrorMode::GES_NoMirror)
+		{
+			QuantizedSampleOffsets[i * 2 + 1] = QuantizedSampleData.Num();
+
+			for (const FVector & Sample : Samples)
+			{
+				QuantizedSampleData.Emplace(FVector(Sample.X, -Sample.Y, Sample.Z), QuantizeScale);
+			}
+		}
+	}
+}
+
+void UGesturesDatabase::RestoreGestureSamples()
+{
+	if (!bSamplesStripped)
+		return;
+
+	WaitForAsyncReaders();
+	bSamplesStripped = false;
+
+	if (!CompiledGestures.IsValid())
+	{
+		UE_LOG(LogVRGestureComponent, Error, TEXT("Gestures database %s was cooked without samples and has no compiled copy to restore them from"), *GetName());
+		return;
+	}
+
+	// Gestures added to the array after loading already have their samples
+	const int32 CompiledCount = FMath::Min(CompiledGestures.GetHeader()->GestureCount, Gestures.Num());
+	for (int i = 0; i < CompiledCount; ++i)
+	{
+		if (Gestures[i].Samples.Num() < 1)
+		{
+			const TArrayView<const FVector> Samples = CompiledGestures.GetGestureSamples(i);
+			Gestures[i].Samples = TArray<FVector>(Samples.GetData(), Samples.Num());
+
+			// The compiled samples are at the database scale, the saved size may not be
+			Gestures[i].GestureSize = FBox(ForceInit);
+			Gestures[i].CalculateSizeOfGesture();
+		}
+	}
+
+	MarkGesturesDirty();
+}
+
+void UGesturesDatabase::CompileGestures()
+{
+	PrepareToModifyGestures();
+	CompiledGestures.Compile(Gestures, TargetGestureScale);
+	MarkGesturesDirty();
+}
+
+void UGesturesDatabase::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FVRGestureDatabaseVersion::GUID);
+
+	// If asked to, cooked data with a blob leaves the samples out of the properties, the blob already has them and they load without
+	// an allocation per gesture. PreSave compiled the blob from these gestures, the hash check is just to be safe.
+	const bool bStripSamples = Ar.IsSaving() && Ar.IsCooking() && bStripCookedSamples && CompiledGestures.Matches(Gestures, TargetGestureScale);
+	TArray<TArray<FVector>> StrippedSamples;
+
+	if (bStripSamples)
+	{
+		StrippedSamples.SetNum(Gestures.Num());
+
+		for (int i = 0; i < Gestures.Num(); ++i)
+		{
+			Swap(StrippedSamples[i], Gestures[i].Samples);
+		}
+	}
+
+	Super::Serialize(Ar);
+
+	if (bStripSamples)
+	{
+		for (int i = 0; i < Gestures.Num(); ++i)
+		{
+			Swap(StrippedSamples[i], Gestures[i].Samples);
+		}
+	}
+
+	if (Ar.CustomVer(FVRGestureDatabaseVersion::GUID) >= FVRGestureDatabaseVersion::AddedCompiledGestureData)
+	{
+		// Only cooked data carries the blob, editor assets compile on demand from their gestures
+		bool bHasCompiledGestures = Ar.IsSaving() && Ar.IsCooking() && CompiledGestures.IsValid();
+		Ar << bHasCompiledGestures;
+
+		if (bHasCompiledGestures)
+		{
+			CompiledGestures.Serialize(Ar);
+		}
+
+		bool bHasStrippedSamples = bStripSamples;
+		if (Ar.CustomVer(FVRGestureDatabaseVersion::GUID) >= FVRGestureDatabaseVersion::StrippedCookedGestureSamples)
+		{
+			Ar << bHasStrippedSamples;
+		}
+
+		if (Ar.IsLoading())
+		{
+			// Trusted without hashing the samples since there are none to hash, see UpdateGestureCache
+			bSamplesStripped = bHasStrippedSamples;
+
+			if (bSamplesStripped && !CompiledGestures.IsValid())
+			{
+				UE_LOG(LogVRGestureComponent, Error, TEXT("Gestures database %s was cooked without samples but its compiled copy is invalid"), *GetName());
+				bSamplesStripped = false;
+			}
+
+			MarkGesturesDirty();
+		}
+	}
+}
+
+void UGesturesDatabase::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// The target platform is only passed in when cooking
+	if (TargetPlatform)
+	{
+		CompileGestures();
+	}
+}
+
+void UVRGestureComponent::DrawDebugGesture(UObject* WorldContextObject, FTransform &StartTransform, const FVRGesture & GestureToDraw, FColor const& Color, bool bPersistentLines, uint8 DepthPriority, float LifeTime, float Thickness)
+{
+	DrawDebugGestureSamples(WorldContextObject, StartTransform, GestureToDraw.Samples, GestureToDraw.GestureSettings.MirrorMode, Color, bPersistentLines, DepthPriority, LifeTime, Thickness);
+}
+
+void UVRGestureComponent::DrawDebugGestureSamples(UObject* WorldContextObject, const FTransform &StartTransform, TArrayView<const FVector> Samples, EVRGestureMirrorMode MirrorMode, FColor const& Color, bool bPersistentLines, uint8 DepthPriority, float LifeTime, float Thickness)
+{
+#if ENABLE_DRAW_DEBUG
+
+	UWorld* InWorld = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+
+	if (InWorld != nullptr)
+	{
+		// no debug line drawing on dedicated server
+		if (GEngine->GetNetMode(InWorld) != NM_DedicatedServer && Samples.Num() > 1)
+		{
+			bool bMirrorGesture = (MirroringHand != EVRGestureMirrorMode::GES_NoMirror && MirroringHand == MirrorMode);
+			FVector MirrorVector = FVector(1.f, -1.f, 1.f); // Only mirroring on Y axis to flip Left/Right
 
 															// this means foreground lines can't be persistent 
 			ULineBatchComponent* const LineBatcher = (InWorld ? ((DepthPriority == SDPG_Foreground) ? InWorld->ForegroundLineBatcher : ((bPersistentLines || (LifeTime > 0.f)) ? InWorld->PersistentLineBatcher : InWorld->LineBatcher)) : NULL);
@@ -488,17 +2069,19 @@ void UVRGestureComponent::DrawDebugGesture(UObject* WorldContextObject, FTransfo
 				float const LineLifeTime = (LifeTime > 0.f) ? LifeTime : LineBatcher->DefaultLifeTime;
 
 				TArray<FBatchedLine> Lines;
+				Lines.Reserve(Samples.Num() - 1);
+
 				FBatchedLine Line;
 				Line.Color = Color;
 				Line.Thickness = Thickness;
 				Line.RemainingLifeTime = LineLifeTime;
 				Line.DepthPriority = DepthPriority;
 
-				FVector FirstLoc = bMirrorGesture ? GestureToDraw.Samples[GestureToDraw.Samples.Num() - 1] * MirrorVector : GestureToDraw.Samples[GestureToDraw.Samples.Num() - 1];
+				FVector FirstLoc = bMirrorGesture ? Samples[Samples.Num() - 1] * MirrorVector : Samples[Samples.Num() - 1];
 
-				for (int i = GestureToDraw.Samples.Num() - 2; i >= 0; --i)
+				for (int i = Samples.Num() - 2; i >= 0; --i)
 				{
-					Line.Start = bMirrorGesture ? GestureToDraw.Samples[i] * MirrorVector : GestureToDraw.Samples[i];
+					Line.Start = bMirrorGesture ? Samples[i] * MirrorVector : Samples[i];
 
 					Line.End = FirstLoc;
 					FirstLoc = Line.Start;
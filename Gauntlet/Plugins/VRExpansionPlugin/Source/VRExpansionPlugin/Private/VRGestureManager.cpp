@@ -0,0 +1,269 @@
+#include "VRGestureManager.h"
+#include "VRGestureComponent.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "UObject/GCObject.h"
+
+DECLARE_CYCLE_STAT(TEXT("TickGesture ~ Manager Tick"), STAT_GestureManagerTick, STATGROUP_TickGesture);
+DECLARE_CYCLE_STAT(TEXT("TickGesture ~ Manager Batched Recognition"), STAT_GestureManagerRecognition, STATGROUP_TickGesture);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TickGesture ~ Manager Deferred Components"), STAT_GestureManagerDeferred, STATGROUP_TickGesture);
+
+// Managers by world, each is referenced from here until its world is cleaned up. The manager is outered to its world, so
+// holding on to it past that would keep the world alive.
+class FVRGestureManagerRegistry : public FGCObject
+{
+public:
+
+	TMap<UWorld *, UVRGestureManager *> Managers;
+
+	FVRGestureManagerRegistry()
+	{
+		FWorldDelegates::OnWorldCleanup.AddRaw(this, &FVRGestureManagerRegistry::OnWorldCleanup);
+	}
+
+	virtual ~FVRGestureManagerRegistry()
+	{
+		FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+	}
+
+	void OnWorldCleanup(UWorld * World, bool bSessionEnded, bool bCleanupResources)
+	{
+		Managers.Remove(World);
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector & Collector) override
+	{
+		// Only the managers, the worlds are the keys and must not be kept alive from here
+		for (TPair<UWorld *, UVRGestureManager *> & Pair : Managers)
+		{
+			Collector.AddReferencedObject(Pair.Value);
+		}
+	}
+
+	// Never destroyed, the garbage collector it registers with can be gone before static destruction
+	static FVRGestureManagerRegistry & Get()
+	{
+		static FVRGestureManagerRegistry * Registry = new FVRGestureManagerRegistry();
+		return *Registry;
+	}
+};
+
+UVRGestureManager::UVRGestureManager(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	UpdateRate = 65;
+	FrameBudgetMS = 0.0f;
+	MaxStepsPerFrame = 4;
+	NextGroupIndex = 0;
+	TimeAccumulator = 0.0f;
+}
+
+UVRGestureManager * UVRGestureManager::Get(UWorld * World, bool bCreateIfMissing)
+{
+	if (!World)
+		return nullptr;
+
+	FVRGestureManagerRegistry & Registry = FVRGestureManagerRegistry::Get();
+
+	if (UVRGestureManager ** Manager = Registry.Managers.Find(World))
+		return *Manager;
+
+	if (!bCreateIfMissing)
+		return nullptr;
+
+	UVRGestureManager * Manager = NewObject<UVRGestureManager>(World);
+	Registry.Managers.Add(World, Manager);
+	return Manager;
+}
+
+UVRGestureManager * UVRGestureManager::GetGestureManager(UObject * WorldContextObject)
+{
+	UWorld * World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return Get(World);
+}
+
+void UVRGestureManager::RegisterGestureComponent(UVRGestureComponent * Component)
+{
+	if (Component)
+		Components.AddUnique(Component);
+}
+
+void UVRGestureManager::UnregisterGestureComponent(UVRGestureComponent * Component)
+{
+	// Components can unregister from inside a detection broadcast while we are walking the list,
+	// so only clear the entry here and let the next step compact it
+	const int Index = Components.IndexOfByKey(Component);
+	if (Index != INDEX_NONE)
+		Components[Index].Reset();
+}
+
+bool UVRGestureManager::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && Components.Num() > 0;
+}
+
+TStatId UVRGestureManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVRGestureManager, STATGROUP_Tickables);
+}
+
+UWorld * UVRGestureManager::GetTickableGameObjectWorld() const
+{
+	return GetTypedOuter<UWorld>();
+}
+
+void UVRGestureManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GestureManagerTick);
+
+	const float Interval = GetUpdateInterval();
+	TimeAccumulator += DeltaTime;
+
+	int Steps = FMath::FloorToInt(TimeAccumulator / Interval);
+	if (Steps <= 0)
+		return;
+
+	TimeAccumulator -= Steps * Interval;
+
+	// Don't try to catch up on a long hitch, the samples would all land on the same location anyway
+	Steps = FMath::Min(Steps, FMath::Max(MaxStepsPerFrame, 1));
+
+	for (int i = 0; i < Steps; ++i)
+	{
+		StepComponents();
+	}
+
+	RunBatchedRecognition();
+}
+
+void UVRGestureManager::StepComponents()
+{
+	for (int i = Components.Num() - 1; i >= 0; --i)
+	{
+		UVRGestureComponent * Component = Components[i].Get();
+
+		if (!Component)
+		{
+			Components.RemoveAtSwap(i);
+			continue;
+		}
+
+		switch (Component->CurrentState)
+		{
+		case EVRGestureState::GES_Detecting:
+		{
+			Component->CaptureGestureFrame();
+
+			// These need every sample or already batch internally, so they keep running on their own
+			if (Component->bUseStreamingDetection || Component->bUseAsyncDetection || Component->bAsyncRecognitionInFlight || Component->bUseVectorizedDTW)
+				Component->RunGestureDetection();
+		}break;
+
+		case EVRGestureState::GES_Recording:
+		{
+			Component->CaptureGestureFrame();
+		}break;
+
+		case EVRGestureState::GES_None:
+		default: {}break;
+		}
+	}
+}
+
+void UVRGestureManager::RunBatchedRecognition()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GestureManagerRecognition);
+
+	PendingComponents.Reset();
+
+	for (const TWeakObjectPtr<UVRGestureComponent> & WeakComponent : Components)
+	{
+		UVRGestureComponent * Component = WeakComponent.Get();
+
+		if (!Component || Component->CurrentState != EVRGestureState::GES_Detecting || !Component->bGestureChanged || !Component->GesturesDB)
+			continue;
+
+		if (Component->bUseStreamingDetection || Component->bUseAsyncDetection || Component->bAsyncRecognitionInFlight || Component->bUseVectorizedDTW)
+			continue;
+
+		PendingComponents.Add(Component);
+	}
+
+	if (PendingComponents.Num() < 1)
+		return;
+
+	PendingComponents.Sort([](const UVRGestureComponent & A, const UVRGestureComponent & B)
+	{
+		return A.GesturesDB < B.GesturesDB;
+	});
+
+	// Find where each database group starts
+	TArray<int, TInlineAllocator<8>> GroupStarts;
+	for (int i = 0; i < PendingComponents.Num(); ++i)
+	{
+		if (i == 0 || PendingComponents[i]->GesturesDB != PendingComponents[i - 1]->GesturesDB)
+			GroupStarts.Add(i);
+	}
+
+	const int GroupCount = GroupStarts.Num();
+	const int FirstGroup = NextGroupIndex % GroupCount;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int n = 0; n < GroupCount; ++n)
+	{
+		const int GroupIndex = (FirstGroup + n) % GroupCount;
+
+		// Always score at least one group a frame, after that stop once over budget
+		if (n > 0 && FrameBudgetMS > 0.0f && (FPlatformTime::Seconds() - StartTime) * 1000.0 >= FrameBudgetMS)
+		{
+			// Left over components keep their changed flag and go first next frame
+			NextGroupIndex = GroupIndex;
+
+			for (int Remaining = n; Remaining < GroupCount; ++Remaining)
+			{
+				const int Skipped = (FirstGroup + Remaining) % GroupCount;
+				const int SkippedEnd = Skipped + 1 < GroupCount ? GroupStarts[Skipped + 1] : PendingComponents.Num();
+				INC_DWORD_STAT_BY(STAT_GestureManagerDeferred, SkippedEnd - GroupStarts[Skipped]);
+			}
+
+			return;
+		}
+
+		const int GroupStart = GroupStarts[GroupIndex];
+		const int GroupEnd = GroupIndex + 1 < GroupCount ? GroupStarts[GroupIndex + 1] : PendingComponents.Num();
+
+		RecognizeGroup(PendingComponents[GroupStart]->GesturesDB, TArrayView<UVRGestureComponent * const>(PendingComponents.GetData() + GroupStart, GroupEnd - GroupStart));
+	}
+
+	NextGroupIndex = (FirstGroup + 1) % GroupCount;
+}
+
+void UVRGestureManager::RecognizeGroup(UGesturesDatabase * GesturesDB, TArrayView<UVRGestureComponent * const> Group)
+{
+	// Scoring reads the envelopes and mirrored samples, they are built once here for the whole group
+	GesturesDB->UpdateGestureCache();
+
+	// Components that have nothing new to score drop out here
+	TArray<UVRGestureComponent *, TInlineAllocator<8>> Active;
+
+	for (UVRGestureComponent * Component : Group)
+	{
+		if (Component->BeginBatchedRecognition())
+			Active.Add(Component);
+	}
+
+	// Gesture outer, component inner, each database gesture is only brought into cache once per frame
+	for (int GestureIndex = 0; GestureIndex < GesturesDB->Gestures.Num(); ++GestureIndex)
+	{
+		for (UVRGestureComponent * Component : Active)
+		{
+			Component->ScoreBatchedGesture(GestureIndex);
+		}
+	}
+
+	// Broadcasts can clear recordings or change state, so they only happen after every component is scored
+	for (UVRGestureComponent * Component : Active)
+	{
+		Component->EndBatchedRecognition();
+	}
+}
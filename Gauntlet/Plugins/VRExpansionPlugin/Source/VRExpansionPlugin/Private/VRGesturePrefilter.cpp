@@ -0,0 +1,279 @@
+#include "VRGesturePrefilter.h"
+#include "VRGestureComponent.h"
+
+UVRGestureShapePrefilter::UVRGestureShapePrefilter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	MaxPathLengthRatio = 2.0f;
+	MaxAspectRatioDifference = 3.0f;
+	MaxDirectionHistogramDistance = 1.0f;
+	MinStartToEndDot = 0.0f;
+}
+
+FVector UVRGestureShapePrefilter::GetStartToEnd(const FVector & Newest, const FVector & Oldest, const FBox & Bounds)
+{
+	const FVector Delta = Newest - Oldest;
+
+	// Closed or nearly closed strokes don't have a stable direction
+	if (Delta.Size() < Bounds.GetSize().GetMax() * 0.25f)
+		return FVector::ZeroVector;
+
+	return Delta.GetSafeNormal();
+}
+
+float UVRGestureShapePrefilter::GetAspectRatio(const FBox & Bounds)
+{
+	const FVector Size = Bounds.GetSize();
+
+	// Padded so that straight lines don't end up with huge or zero ratios from a bit of jitter
+	const float Padding = FMath::Max(Size.GetMax() * 0.1f, KINDA_SMALL_NUMBER);
+	return (Size.Y + Padding) / (Size.Z + Padding);
+}
+
+int UVRGestureShapePrefilter::GetDirectionBin(const FVector & Segment, float & OutLength)
+{
+	OutLength = FMath::Sqrt(Segment.Y * Segment.Y + Segment.Z * Segment.Z);
+	const float Angle = FMath::Atan2(Segment.Z, Segment.Y);
+	return FMath::Clamp(FMath::FloorToInt((Angle + PI) / (2.f * PI) * VRGESTURE_DIRECTION_BINS), 0, VRGESTURE_DIRECTION_BINS - 1);
+}
+
+void UVRGestureShapePrefilter::BuildGestureFeatures(const UGesturesDatabase & Database)
+{
+	GestureFeatures.Reset();
+	GestureFeatures.AddDefaulted(Database.Gestures.Num());
+
+	for (int i = 0; i < Database.Gestures.Num(); ++i)
+	{
+		const TArrayView<const FVector> Samples = Database.GetGestureSamples(i, false);
+		FVRGestureShapeFeatures & Features = GestureFeatures[i];
+		Features.SampleCount = Samples.Num();
+
+		if (Samples.Num() < 2)
+			continue;
+
+		FBox Bounds(Samples.GetData(), Samples.Num());
+		Features.AspectRatio = GetAspectRatio(Bounds);
+		Features.StartToEnd = GetStartToEnd(Samples[0], Samples[Samples.Num() - 1], Bounds);
+
+		float HistogramTotal = 0.f;
+		float SegmentLength = 0.f;
+
+		// Samples are newest first, segments run forward in time
+		for (int j = 1; j < Samples.Num(); ++j)
+		{
+			const FVector Segment = Samples[j - 1] - Samples[j];
+			Features.PathLength += Segment.Size();
+
+			Features.DirectionHistogram[GetDirectionBin(Segment, SegmentLength)] += SegmentLength;
+			Features.MirroredDirectionHistogram[GetDirectionBin(FVector(Segment.X, -Segment.Y, Segment.Z), SegmentLength)] += SegmentLength;
+			HistogramTotal += SegmentLength;
+		}
+
+		if (HistogramTotal > KINDA_SMALL_NUMBER)
+		{
+			for (int Bin = 0; Bin < VRGESTURE_DIRECTION_BINS; ++Bin)
+			{
+				Features.DirectionHistogram[Bin] /= HistogramTotal;
+				Features.MirroredDirectionHistogram[Bin] /= HistogramTotal;
+			}
+		}
+	}
+
+	PathLengthBuckets.Reset();
+	PathLengthIndex.Reset();
+	UnindexedGestures.Reset();
+
+	for (int i = 0; i < GestureFeatures.Num(); ++i)
+	{
+		// Same cases that PassesPrefilter lets through without comparing the path length
+		if (GestureFeatures[i].SampleCount < 2 || GestureFeatures[i].PathLength <= KINDA_SMALL_NUMBER)
+			UnindexedGestures.Add(i);
+		else
+			PathLengthIndex.Add(i);
+	}
+
+	const TArray<FVRGesture> & Gestures = Database.Gestures;
+	PathLengthIndex.Sort([this, &Gestures](const int32 & A, const int32 & B)
+	{
+		const FVRGestureShapeFeatures & FeaturesA = GestureFeatures[A];
+		const FVRGestureShapeFeatures & FeaturesB = GestureFeatures[B];
+
+		if (FeaturesA.SampleCount != FeaturesB.SampleCount)
+			return FeaturesA.SampleCount < FeaturesB.SampleCount;
+
+		const bool bScalesA = Gestures[A].GestureSettings.bEnableScaling;
+		const bool bScalesB = Gestures[B].GestureSettings.bEnableScaling;
+
+		if (bScalesA != bScalesB)
+			return bScalesB;
+
+		return FeaturesA.PathLength < FeaturesB.PathLength;
+	});
+
+	for (int32 k = 0; k < PathLengthIndex.Num(); ++k)
+	{
+		const int32 SampleCount = GestureFeatures[PathLengthIndex[k]].SampleCount;
+		const bool bScales = Gestures[PathLengthIndex[k]].GestureSettings.bEnableScaling;
+
+		if (PathLengthBuckets.Num() == 0 || PathLengthBuckets.Last().SampleCount != SampleCount || PathLengthBuckets.Last().bScales != bScales)
+		{
+			FPathLengthBucket & Bucket = PathLengthBuckets[PathLengthBuckets.AddUninitialized()];
+			Bucket.SampleCount = SampleCount;
+			Bucket.bScales = bScales;
+			Bucket.First = k;
+			Bucket.Num = 0;
+		}
+
+		++PathLengthBuckets.Last().Num;
+	}
+}
+
+void UVRGestureShapePrefilter::BuildInputFeatures(const FVRGestureView & Input, FVRGestureInputFeatures & OutFeatures) const
+{
+	const int32 Count = Input.Samples.Num();
+
+	// Keeps the allocations, the input is at most the buffer size
+	OutFeatures.Reset();
+
+	if (Count < 1)
+		return;
+
+	OutFeatures.PathLength.AddUninitialized(Count);
+	OutFeatures.DirectionHistogram.AddZeroed(Count * VRGESTURE_DIRECTION_BINS);
+	OutFeatures.Bounds.AddUninitialized(Count);
+
+	OutFeatures.PathLength[0] = 0.f;
+	OutFeatures.Bounds[0] = FBox(Input.Samples[0], Input.Samples[0]);
+	float SegmentLength = 0.f;
+
+	for (int32 k = 1; k < Count; ++k)
+	{
+		const FVector Segment = Input.Samples[k - 1] - Input.Samples[k];
+
+		OutFeatures.PathLength[k] = OutFeatures.PathLength[k - 1] + Segment.Size();
+		OutFeatures.Bounds[k] = OutFeatures.Bounds[k - 1] + Input.Samples[k];
+
+		float * Histogram = OutFeatures.DirectionHistogram.GetData() + k * VRGESTURE_DIRECTION_BINS;
+		FMemory::Memcpy(Histogram, Histogram - VRGESTURE_DIRECTION_BINS, VRGESTURE_DIRECTION_BINS * sizeof(float));
+
+		const int Bin = GetDirectionBin(Segment, SegmentLength);
+		Histogram[Bin] += SegmentLength;
+	}
+}
+
+bool UVRGestureShapePrefilter::SelectCandidates(const FVRGestureInputFeatures & InputFeatures, float Scaler, TArray<int32> & OutCandidates) const
+{
+	// PassesPrefilter doesn't compare path lengths in either case, so the index can't rule anything out
+	if (MaxPathLengthRatio <= 0.f || InputFeatures.Num() < 2)
+		return false;
+
+	OutCandidates.Reset();
+	OutCandidates.Append(UnindexedGestures);
+
+	for (const FPathLengthBucket & Bucket : PathLengthBuckets)
+	{
+		// Every gesture in the bucket compares against the same newest part of the input, see PassesPrefilter
+		const int32 Last = FMath::Min(Bucket.SampleCount, InputFeatures.Num()) - 1;
+		const float InputLength = InputFeatures.PathLength[Last] * (Bucket.bScales ? Scaler : 1.f);
+		const int32 * Sorted = PathLengthIndex.GetData() + Bucket.First;
+
+		// Same comparisons as PassesPrefilter so that the two always agree, first the gestures that are too short for the input...
+		int32 Low = 0;
+		int32 High = Bucket.Num;
+		while (Low < High)
+		{
+			const int32 Mid = (Low + High) / 2;
+			if (InputLength > GestureFeatures[Sorted[Mid]].PathLength * MaxPathLengthRatio)
+				Low = Mid + 1;
+			else
+				High = Mid;
+		}
+
+		const int32 Begin = Low;
+
+		// ...then the ones that are too long
+		High = Bucket.Num;
+		while (Low < High)
+		{
+			const int32 Mid = (Low + High) / 2;
+			if (InputLength * MaxPathLengthRatio < GestureFeatures[Sorted[Mid]].PathLength)
+				High = Mid;
+			else
+				Low = Mid + 1;
+		}
+
+		OutCandidates.Append(Sorted + Begin, Low - Begin);
+	}
+
+	// Detection walks the candidates in index order, which decides ties between equal costs
+	OutCandidates.Sort();
+	return true;
+}
+
+bool UVRGestureShapePrefilter::PassesPrefilter(const FVRGestureView & Input, const FVRGestureInputFeatures & InputFeatures, float Scaler, int GestureIndex, bool bMirrorGesture) const
+{
+	if (!GestureFeatures.IsValidIndex(GestureIndex) || InputFeatures.Num() < 2)
+		return true;
+
+	const FVRGestureShapeFeatures & Features = GestureFeatures[GestureIndex];
+
+	if (Features.SampleCount < 2)
+		return true;
+
+	// Compare against as many of the newest input samples as the gesture has
+	const int32 Last = FMath::Min(Features.SampleCount, InputFeatures.Num()) - 1;
+
+	if (MaxPathLengthRatio > 0.f && Features.PathLength > KINDA_SMALL_NUMBER)
+	{
+		const float InputLength = InputFeatures.PathLength[Last] * Scaler;
+
+		if (InputLength * MaxPathLengthRatio < Features.PathLength || InputLength > Features.PathLength * MaxPathLengthRatio)
+			return false;
+	}
+
+	const FBox & InputBounds = InputFeatures.Bounds[Last];
+
+	// Mirroring on Y doesn't change the aspect ratio
+	if (MaxAspectRatioDifference > 0.f)
+	{
+		const float AspectRatio = GetAspectRatio(InputBounds) / Features.AspectRatio;
+
+		if (AspectRatio > MaxAspectRatioDifference || AspectRatio * MaxAspectRatioDifference < 1.f)
+			return false;
+	}
+
+	if (MinStartToEndDot > -1.f && !Features.StartToEnd.IsZero())
+	{
+		const FVector InputStartToEnd = GetStartToEnd(Input.Samples[0], Input.Samples[Last], InputBounds);
+		const FVector GestureStartToEnd = bMirrorGesture ? FVector(Features.StartToEnd.X, -Features.StartToEnd.Y, Features.StartToEnd.Z) : Features.StartToEnd;
+
+		if (!InputStartToEnd.IsZero() && FVector::DotProduct(InputStartToEnd, GestureStartToEnd) < MinStartToEndDot)
+			return false;
+	}
+
+	if (MaxDirectionHistogramDistance > 0.f)
+	{
+		const float * InputHistogram = InputFeatures.DirectionHistogram.GetData() + Last * VRGESTURE_DIRECTION_BINS;
+		const float * GestureHistogram = bMirrorGesture ? Features.MirroredDirectionHistogram : Features.DirectionHistogram;
+
+		float InputTotal = 0.f;
+		for (int Bin = 0; Bin < VRGESTURE_DIRECTION_BINS; ++Bin)
+		{
+			InputTotal += InputHistogram[Bin];
+		}
+
+		if (InputTotal > KINDA_SMALL_NUMBER)
+		{
+			float Distance = 0.f;
+			for (int Bin = 0; Bin < VRGESTURE_DIRECTION_BINS; ++Bin)
+			{
+				Distance += FMath::Abs(InputHistogram[Bin] / InputTotal - GestureHistogram[Bin]);
+			}
+
+			if (Distance > MaxDirectionHistogramDistance)
+				return false;
+		}
+	}
+
+	return true;
+}
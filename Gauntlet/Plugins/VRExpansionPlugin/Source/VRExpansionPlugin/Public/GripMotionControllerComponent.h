@@ -15,6 +15,7 @@
 #include "VRGlobalSettings.h"
 #include "GripScripts/VRGripScriptBase.h"
 #include "XRMotionControllerBase.h" // for GetHandEnumForSourceName()
+#include "WorldCollision.h"
 #include "GripMotionControllerComponent.generated.h"
 
 class AVRBaseCharacter;
@@ -27,6 +28,9 @@ DECLARE_LOG_CATEGORY_EXTERN(LogVRMotionController, Log, All);
 //For UE4 Profiler ~ Stat Group
 DECLARE_STATS_GROUP(TEXT("TICKGrip"), STATGROUP_TickGrip, STATCAT_Advanced);
 
+// Grip index slots at or above this are in LocallyGrippedObjects
+#define VRGRIP_LOCAL_GRIP_SLOT 0x10000
+
 /** Delegate for notification when the controller grips a new object. */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FVRGripControllerOnGripSignature, const FBPActorGripInformation &, GripInformation);
 
@@ -75,9 +79,37 @@ public:
 		FPrimitiveSceneInfo*	SceneInfo;
 	};
 
+	/*
+	*  Flattened component hierarchy under a late updated root. Walking the attachment tree every frame is expensive for
+	*  props with many child components, so the walk is only redone when the cheap per frame check finds that a
+	*  component in it was destroyed, re-parented or had its attach children change.
+	*/
+	struct FLateUpdateHierarchy
+	{
+		struct FNode
+		{
+			TWeakObjectPtr<USceneComponent> Component;
+			const USceneComponent* AttachParent;
+			int32 NumAttachChildren;
+		};
+
+		TWeakObjectPtr<USceneComponent> Root;
+		TArray<FNode> Nodes;
+		uint32 LastUsedSetup;
+	};
+
 	/** A utility method that calls CacheSceneInfo on ParentComponent and all of its descendants */
 	void GatherLateUpdatePrimitives(USceneComponent* ParentComponent);
-	void ProcessGripArrayLateUpdatePrimitives(UGripMotionControllerComponent* MotionController, TArray<FBPActorGripInformation> & GripArray);
+	void ProcessGripArrayLateUpdatePrimitives(UGripMotionControllerComponent* MotionController, const TArray<FBPActorGripInformation> & GripArray);
+
+	/** Cached version of GatherLateUpdatePrimitives, falls back to it when the cache is disabled */
+	void GatherCachedLateUpdatePrimitives(USceneComponent* ParentComponent);
+	void GatherCachedLateUpdatePrimitives(FLateUpdateHierarchy & Hierarchy);
+
+	/** Returns the index of the cached hierarchy of RootComponent and marks it as used by this setup, adding an unbuilt one if needed */
+	int32 FindOrAddHierarchy(USceneComponent* RootComponent);
+	static void BuildHierarchy(FLateUpdateHierarchy & Hierarchy);
+	static bool IsHierarchyValid(const FLateUpdateHierarchy & Hierarchy);
 
 	/** Generates a LateUpdatePrimitiveInfo for the given component if it has a SceneProxy and appends it to the current LateUpdatePrimitives array */
 	void CacheSceneInfo(USceneComponent* Component);
@@ -92,6 +124,10 @@ public:
 	int32 LateUpdateGameWriteIndex;
 	int32 LateUpdateRenderReadIndex;
 
+	/** Game thread only, hierarchies that weren't used by the latest setup are dropped at the end of it */
+	TArray<FLateUpdateHierarchy> CachedHierarchies;
+	uint32 SetupCount;
+	bool bUseHierarchyCache;
 };
 
 /**
@@ -149,6 +185,7 @@ public:
 
 	// Custom version of the component sweep function to remove that aggravating warning epic is throwing about skeletal mesh components.
 	void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+	virtual void PostInitProperties() override;
 	virtual void InitializeComponent() override;
 	virtual void OnUnregister() override;
 	virtual void PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker) override;
@@ -223,12 +260,46 @@ public:
 	}
 
 	// When possible I suggest that you use GetAllGrips/GetGrippedObjects instead of directly referencing this
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "GripMotionController", ReplicatedUsing = OnRep_GrippedObjects)
-	TArray<FBPActorGripInformation> GrippedObjects;
+	// Replicated as a fast array, call MarkGripDirty after changing a replicated value of a grip in it
+	// This used to be a TArray. C++ can still index, iterate and search it the same way, Blueprints that read the array have to
+	// switch to GetGripArray (the property is now a struct with the array in Items)
+	UPROPERTY(BlueprintReadOnly, Replicated, Category = "GripMotionController")
+	FBPGripArray GrippedObjects;
 
 	// When possible I suggest that you use GetAllGrips/GetGrippedObjects instead of directly referencing this
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "GripMotionController", ReplicatedUsing = OnRep_LocallyGrippedObjects)
-	TArray<FBPActorGripInformation> LocallyGrippedObjects;
+	// Same as GrippedObjects, Blueprints read it with GetLocalGripArray
+	UPROPERTY(BlueprintReadOnly, Replicated, Category = "GripMotionController")
+	FBPGripArray LocallyGrippedObjects;
+
+	// Grips in GrippedObjects, the array that Blueprints used to read from the property directly
+	UFUNCTION(BlueprintPure, Category = "GripMotionController")
+	TArray<FBPActorGripInformation> GetGripArray() const
+	{
+		return GrippedObjects.Items;
+	}
+
+	// Grips in LocallyGrippedObjects, the array that Blueprints used to read from the property directly
+	UFUNCTION(BlueprintPure, Category = "GripMotionController")
+	TArray<FBPActorGripInformation> GetLocalGripArray() const
+	{
+		return LocallyGrippedObjects.Items;
+	}
+
+	// Flags a grip in GrippedObjects or LocallyGrippedObjects as changed so that it goes out with the next delta of its array
+	void MarkGripDirty(FBPActorGripInformation & Grip);
+
+	// Finds the grip of an object (actor or component) in GrippedObjects, then LocallyGrippedObjects, through the grip index instead of a scan
+	// The pointer is into the grip arrays and is only valid until they change
+	FBPActorGripInformation * FindGripByObject(const UObject * ObjectToFind);
+
+	// Same as FindGripByObject for a grip ID
+	FBPActorGripInformation * FindGripByID(uint8 GripIDToFind);
+
+	// Call after adding or removing grips in GrippedObjects or LocallyGrippedObjects so that the grip index is rebuilt before the next lookup
+	void MarkGripIndexDirty()
+	{
+		bGripIndexDirty = true;
+	}
 
 	// Locally Gripped Array functions
 
@@ -263,6 +334,16 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController")
 	bool bAlwaysSendTickGrip;
 
+	// Runs the collision sweeps of the swept and interactive grip types as async scene queries instead of blocking on them in the tick.
+	// Results are consumed on the next tick so the colliding state of a grip lags one frame behind. Only the shape of a shape component
+	// root or an oriented box of its local bounds for other roots is swept, and SweepWithPhysics grips get their blocking hit events a frame late and not for child components.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Collision")
+	bool bUseAsyncGripSweeps;
+
+	// Most async grip sweeps this controller queues in a frame, grips past it keep their last colliding state. 0 or less is no limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Collision", meta = (EditCondition = "bUseAsyncGripSweeps"))
+	int32 MaxAsyncGripSweepsPerFrame;
+
 	// Clean up a grip that is "bad", object is being destroyed or was a bad destructible mesh
 	void CleanUpBadGrip(TArray<FBPActorGripInformation> &GrippedObjectsArray, int GripIndex, bool bReplicatedArray);
 	void CleanUpBadPhysicsHandles();
@@ -282,30 +363,11 @@ public:
 		NotifyGrip(GripInfo, true);
 	}
 
-	UFUNCTION()
-	virtual void OnRep_GrippedObjects(/*TArray<FBPActorGripInformation> OriginalArrayState*/) // Original array state is useless without full serialize, it just hold last delta
-	{
-		// Need to think about how best to handle the simulating flag here, don't handle for now
-		// Check for removed gripped actors
-		// This might actually be better left as an RPC multicast
-
-		for (int i = GrippedObjects.Num() - 1; i >= 0; --i)
-		{
-			HandleGripReplication(GrippedObjects[i]);
-		}
-	}
-
-	UFUNCTION()
-	virtual void OnRep_LocallyGrippedObjects()
-	{
-		for (int i = LocallyGrippedObjects.Num() - 1; i >= 0; --i)
-		{
-			HandleGripReplication(LocallyGrippedObjects[i]);
-		}
-	}
-
 	// Handles variable state changes and specific actions on a grip replication
-	inline bool HandleGripReplication(FBPActorGripInformation & Grip);
+	bool HandleGripReplication(FBPActorGripInformation & Grip);
+
+	// Called by the grip arrays when a grip is removed through replication, drops the grip if the NotifyDrop multicast didn't already
+	void HandleGripRemovalReplication(const FBPActorGripInformation & Grip);
 
 	UPROPERTY(BlueprintReadWrite, Category = "GripMotionController")
 	TArray<UPrimitiveComponent *> AdditionalLateUpdateComponents;
@@ -322,6 +384,12 @@ public:
 	bool bLerpingPosition;
 	bool bReppedOnce;
 
+	// Velocity estimate and blend state for the Extrapolate smoothing mode
+	FVRReplicatedMotionExtrapolator MotionExtrapolator;
+
+	// Feeds a replicated transform into the extrapolator, snapping to it if it is the first or too far off
+	void AddReplicatedMotionSample();
+
 	UFUNCTION()
 	virtual void OnRep_ReplicatedControllerTransform()
 	{
@@ -329,7 +397,11 @@ public:
 
 		if (bSmoothReplicatedMotion)
 		{
-			if (bReppedOnce)
+			if (ReplicatedMotionSmoothing == EVRReplicatedMotionSmoothing::Extrapolate)
+			{
+				AddReplicatedMotionSample();
+			}
+			else if (bReppedOnce)
 			{
 				bLerpingPosition = true;
 				ControllerNetUpdateCount = 0.0f;
@@ -357,6 +429,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "GripMotionController|Networking")
 		bool bSmoothReplicatedMotion;
 
+	// How remote controllers are smoothed when bSmoothReplicatedMotion is on, Extrapolate keeps moving past late or lost updates instead of hitching
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking")
+		EVRReplicatedMotionSmoothing ReplicatedMotionSmoothing;
+
+	// Longest time in seconds to extrapolate past the last update before settling back onto it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float MaxExtrapolationTime;
+
+	// Position error in cm on a new update over which extrapolation snaps instead of blending, 0 to never snap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float ExtrapolationSnapDistance;
+
+	// Rotation error in degrees on a new update over which extrapolation snaps instead of blending, 0 to never snap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GripMotionController|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float ExtrapolationSnapAngle;
+
 	// Whether to replicate even if no tracking (FPS or test characters)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "GripMotionController|Networking")
 		bool bReplicateWithoutTracking;
@@ -673,6 +761,14 @@ public:
 	// Splitting logic into separate function
 	void HandleGripArray(TArray<FBPActorGripInformation> &GrippedObjectsArray, const FTransform & ParentTransform, float DeltaTime, bool bReplicatedArray = false);
 
+	// Captures the interface answers and grip scripts of the gripped object into the grips interface cache
+	void CacheGripInterface(FBPActorGripInformation & Grip, UPrimitiveComponent * root, AActor * actor);
+
+	// Has the grips re-capture their cached interface answers on their next tick, call after changing the grip settings or grip scripts of a held object at runtime
+	// If ObjectToRefresh is null then every grip on this controller is refreshed
+	UFUNCTION(BlueprintCallable, Category = "GripMotionController")
+	void InvalidateGripInterfaceCache(UObject * ObjectToRefresh = nullptr);
+
 	// Gets the world transform of a grip, modified by secondary grips, returns if it has a valid transform, if not then this tick will be skipped for the object
 	bool GetGripWorldTransform(TArray<UVRGripScriptBase*>& GripScripts, float DeltaTime,FTransform & WorldTransform, const FTransform &ParentTransform, FBPActorGripInformation &Grip, AActor * actor, UPrimitiveComponent * root, bool bRootHasInterface, bool bActorHasInterface, bool bIsForTeleport, bool &bForceADrop);
 
@@ -703,7 +799,7 @@ public:
 		if (!ObjectToCheck)
 			return false;
 
-		return (GrippedObjects.FindByKey(ObjectToCheck) || LocallyGrippedObjects.FindByKey(ObjectToCheck));
+		return FindGripByObject(ObjectToCheck) != nullptr;
 	}
 
 	// Gets if the given actor is held by this controller
@@ -713,7 +809,7 @@ public:
 		if (!ActorToCheck)
 			return false;
 
-		return (GrippedObjects.FindByKey(ActorToCheck) || LocallyGrippedObjects.FindByKey(ActorToCheck));
+		return FindGripByObject(ActorToCheck) != nullptr;
 	}
 
 	// Gets if the given component is held by this controller
@@ -723,9 +819,7 @@ public:
 		if (!ComponentToCheck)
 			return false;
 
-		return (GrippedObjects.FindByKey(ComponentToCheck) || LocallyGrippedObjects.FindByKey(ComponentToCheck));
-
-		return false;
+		return FindGripByObject(ComponentToCheck) != nullptr;
 	}
 
 	// Gets if the given Component is a secondary attach point to a gripped actor
@@ -735,20 +829,20 @@ public:
 		if (!ComponentToCheck)
 			return false;
 
-		for (int i = 0; i < GrippedObjects.Num(); ++i)
+		for (int i = 0; i < GrippedObjects.Items.Num(); ++i)
 		{
-			if(GrippedObjects[i].SecondaryGripInfo.bHasSecondaryAttachment && GrippedObjects[i].SecondaryGripInfo.SecondaryAttachment == ComponentToCheck)
+			if(GrippedObjects.Items[i].SecondaryGripInfo.bHasSecondaryAttachment && GrippedObjects.Items[i].SecondaryGripInfo.SecondaryAttachment == ComponentToCheck)
 			{
-				Grip = GrippedObjects[i];
+				Grip = GrippedObjects.Items[i];
 				return true;
 			}
 		}
 
-		for (int i = 0; i < LocallyGrippedObjects.Num(); ++i)
+		for (int i = 0; i < LocallyGrippedObjects.Items.Num(); ++i)
 		{
-			if (LocallyGrippedObjects[i].SecondaryGripInfo.bHasSecondaryAttachment && LocallyGrippedObjects[i].SecondaryGripInfo.SecondaryAttachment == ComponentToCheck)
+			if (LocallyGrippedObjects.Items[i].SecondaryGripInfo.bHasSecondaryAttachment && LocallyGrippedObjects.Items[i].SecondaryGripInfo.SecondaryAttachment == ComponentToCheck)
 			{
-				Grip = LocallyGrippedObjects[i];
+				Grip = LocallyGrippedObjects.Items[i];
 				return true;
 			}
 		}
@@ -760,7 +854,7 @@ public:
 	UFUNCTION(BlueprintPure, Category = "GripMotionController")
 	bool HasGrippedObjects()
 	{
-		return GrippedObjects.Num() > 0 || LocallyGrippedObjects.Num() > 0;
+		return GrippedObjects.Items.Num() > 0 || LocallyGrippedObjects.Items.Num() > 0;
 	}
 
 	// Get list of all gripped objects grip info structures (local and normal both)
@@ -825,6 +919,9 @@ public:
 	bool bUseWithoutTracking;
 
 	bool CheckComponentWithSweep(UPrimitiveComponent * ComponentToCheck, FVector Move, FRotator newOrientation, bool bSkipSimulatingComponents/*, bool & bHadBlockingHitOut*/);
+
+	// Sweeps a gripped root towards its new transform and returns if it is blocked, through the async queue when bUseAsyncGripSweeps is on
+	bool SweepGripForCollision(FBPActorGripInformation & Grip, UPrimitiveComponent * root, const FTransform & WorldTransform, const FComponentQueryParams & Params, FHitResult * OutBlockingHit = nullptr);
 	
 	// For physics handle operations
 	bool SetUpPhysicsHandle(const FBPActorGripInformation &NewGrip);
@@ -918,6 +1015,21 @@ public:
 	bool bHasAuthority;
 
 private:
+
+	// Slot of each gripped object and grip ID in the grip arrays, slots of local grips are offset by VRGRIP_LOCAL_GRIP_SLOT.
+	// Rebuilt lazily once the arrays change, hits are checked against the arrays so a missed MarkGripIndexDirty only costs a rebuild
+	TMap<const UObject *, int32> GripSlotsByObject;
+	TMap<uint8, int32> GripSlotsByID;
+	bool bGripIndexDirty;
+
+	void RebuildGripIndex();
+	FBPActorGripInformation * GetGripInSlot(int32 Slot);
+
+	// Async grip sweeps by grip ID, queued this tick and the ones from the last tick that are being consumed
+	TMap<uint8, FTraceHandle> QueuedGripSweeps;
+	TMap<uint8, FTraceHandle> LastGripSweeps;
+	int32 AsyncGripSweepsThisFrame;
+
 	/** Whether or not this component is currently on the network server*/
 	//bool bIsServer;
 
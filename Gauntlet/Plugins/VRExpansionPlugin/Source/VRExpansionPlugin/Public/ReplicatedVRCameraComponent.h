@@ -57,13 +57,39 @@ public:
 	// Whether to smooth (lerp) between ticks for the replicated motion, DOES NOTHING if update rate is larger than FPS!
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "ReplicatedCamera|Networking")
 		bool bSmoothReplicatedMotion;
+
+	// How remote cameras are smoothed when bSmoothReplicatedMotion is on, Extrapolate keeps moving past late or lost updates instead of hitching
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReplicatedCamera|Networking")
+		EVRReplicatedMotionSmoothing ReplicatedMotionSmoothing;
+
+	// Longest time in seconds to extrapolate past the last update before settling back onto it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReplicatedCamera|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float MaxExtrapolationTime;
+
+	// Position error in cm on a new update over which extrapolation snaps instead of blending, 0 to never snap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReplicatedCamera|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float ExtrapolationSnapDistance;
+
+	// Rotation error in degrees on a new update over which extrapolation snaps instead of blending, 0 to never snap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ReplicatedCamera|Networking", meta = (ClampMin = "0", UIMin = "0"))
+		float ExtrapolationSnapAngle;
+
+	// Velocity estimate and blend state for the Extrapolate smoothing mode
+	FVRReplicatedMotionExtrapolator MotionExtrapolator;
+
+	// Feeds a replicated transform into the extrapolator, snapping to it if it is the first or too far off
+	void AddReplicatedMotionSample();
 	
 	UFUNCTION()
 	virtual void OnRep_ReplicatedCameraTransform()
 	{
 		if (bSmoothReplicatedMotion)
 		{
-			if (bReppedOnce)
+			if (ReplicatedMotionSmoothing == EVRReplicatedMotionSmoothing::Extrapolate)
+			{
+				AddReplicatedMotionSample();
+			}
+			else if (bReppedOnce)
 			{
 				bLerpingPosition = true;
 				NetUpdateCount = 0.0f;
@@ -5,6 +5,7 @@
 //#include "EngineMinimal.h"
 
 #include "PhysicsPublic.h"
+#include "Engine/NetSerialization.h"
 #if WITH_PHYSX
 #include "PhysXPublic.h"
 #include "PhysXSupport.h"
@@ -465,6 +466,70 @@ struct TStructOpsTypeTraits< FBPVRComponentPosRep > : public TStructOpsTypeTrait
 	};
 };
 
+UENUM(BlueprintType)
+enum class EVRReplicatedMotionSmoothing : uint8
+{
+	/** Lerps from the current position to each update over one update interval, then holds until the next one arrives. */
+	Lerp,
+	/** Estimates velocity from recent updates and keeps moving past the last one, blending corrections in on a hermite curve. */
+	Extrapolate
+};
+
+/**
+*	Receiving side state for extrapolating a replicated component transform (FBPVRComponentPosRep).
+*	Shared by the motion controllers and the replicated camera, all values are in the components relative space.
+*/
+struct VREXPANSIONPLUGIN_API FVRReplicatedMotionExtrapolator
+{
+	FVector SamplePosition;
+	FQuat SampleRotation;
+	float SampleTime;
+
+	// Smoothed over the recent updates, angular velocity is axis * radians per second
+	FVector LinearVelocity;
+	FVector AngularVelocity;
+
+	// Where the displayed transform was when the last update came in, corrections blend from here
+	FVector BlendStartPosition;
+	FVector BlendStartVelocity;
+	FQuat BlendStartRotation;
+	float BlendDuration;
+
+	bool bHasSample;
+
+	FVRReplicatedMotionExtrapolator()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		SamplePosition = FVector::ZeroVector;
+		SampleRotation = FQuat::Identity;
+		SampleTime = 0.0f;
+		LinearVelocity = FVector::ZeroVector;
+		AngularVelocity = FVector::ZeroVector;
+		BlendStartPosition = FVector::ZeroVector;
+		BlendStartVelocity = FVector::ZeroVector;
+		BlendStartRotation = FQuat::Identity;
+		BlendDuration = 0.0f;
+		bHasSample = false;
+	}
+
+	// Adds a received update, returns true if the caller should snap straight to it (first update or error over the snap limits)
+	// Snap limits of 0 disable that check, MaxExtrapolationTime should match the one passed to Evaluate
+	bool AddSample(const FBPVRComponentPosRep & Update, const FVector & CurrentPosition, const FRotator & CurrentRotation, float CurrentTime, float UpdateInterval, float MaxExtrapolationTime, float SnapDistance, float SnapAngle);
+
+	// Gets the transform to display at CurrentTime, returns false once it has settled on the last update and no longer needs evaluating
+	bool Evaluate(float CurrentTime, float MaxExtrapolationTime, FVector & OutPosition, FRotator & OutRotation) const;
+
+	static FQuat ExtrapolateRotation(const FQuat & Rotation, const FVector & AngularVelocity, float Time)
+	{
+		const float Angle = AngularVelocity.Size() * Time;
+		return Angle > KINDA_SMALL_NUMBER ? FQuat(AngularVelocity.GetUnsafeNormal(), Angle) * Rotation : Rotation;
+	}
+};
+
 UENUM(Blueprintable)
 enum class EGripCollisionType : uint8
 {
@@ -1095,7 +1160,7 @@ public:
 #define INVALID_VRGRIP_ID 0
 
 USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
-struct VREXPANSIONPLUGIN_API FBPActorGripInformation
+struct VREXPANSIONPLUGIN_API FBPActorGripInformation : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 public:
@@ -1180,6 +1245,7 @@ public:
 		FBPAdvGripPhysicsSettings CachedPhysicsSettings;
 		FName CachedBoneName;
 		uint8 CachedGripID;
+		bool bWasDropped;
 
 		FGripValueCache() :
 			bWasInitiallyRepped(false),
@@ -1190,14 +1256,40 @@ public:
 			CachedStiffness(1500.0f),
 			CachedDamping(200.0f),
 			CachedBoneName(NAME_None),
-			CachedGripID(INVALID_VRGRIP_ID)
+			CachedGripID(INVALID_VRGRIP_ID),
+			bWasDropped(false)
 		{}
 
 	}ValueCache;
 
+	// Interface answers of the gripped object, captured on the first tick of the grip so that ticking it doesn't go through
+	// the interface dispatch every frame. Goes stale if the object changes its grip settings, see InvalidateGripInterfaceCache on the controller
+	struct FGripInterfaceCache
+	{
+		bool bIsValid;
+		TWeakObjectPtr<UPrimitiveComponent> CachedRoot;
+		bool bRootHasInterface;
+		bool bActorHasInterface;
+		bool bSimulateOnDrop;
+		float GripBreakDistance;
+		ESecondaryGripType SecondaryGripType;
+		TArray<TWeakObjectPtr<UVRGripScriptBase>> GripScripts;
+
+		FGripInterfaceCache() :
+			bIsValid(false),
+			bRootHasInterface(false),
+			bActorHasInterface(false),
+			bSimulateOnDrop(true),
+			GripBreakDistance(0.0f),
+			SecondaryGripType(ESecondaryGripType::SG_None)
+		{}
+
+	}InterfaceCache;
+
 	void ClearNonReppingItems()
 	{
 		ValueCache = FGripValueCache();
+		InterfaceCache = FGripInterfaceCache();
 		bColliding = false;
 		bIsLocked = false;
 		LastLockedRotation = FQuat::Identity;
@@ -1314,6 +1406,68 @@ public:
 	{
 	}	
 
+	// Fast array callbacks, forwarded to the owning controller on clients
+	void PreReplicatedRemove(const struct FBPGripArray & InArraySerializer);
+	void PostReplicatedAdd(const struct FBPGripArray & InArraySerializer);
+	void PostReplicatedChange(const struct FBPGripArray & InArraySerializer);
+};
+
+// Grips of a motion controller, replicated as a fast array so that only the added, removed or changed grips are sent
+USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
+struct VREXPANSIONPLUGIN_API FBPGripArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Settings")
+		TArray<FBPActorGripInformation> Items;
+
+	// Receives the replication callbacks of the items, set by the controller after its properties are initialized
+	// so that it isn't copied over from the archetype
+	UGripMotionControllerComponent * OwningController;
+
+	FBPGripArray() :
+		OwningController(nullptr)
+	{
+	}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms);
+
+	// Read side of the TArray interface that the grip arrays had before they were fast arrays, so that code indexing, iterating or
+	// searching them keeps compiling. Adding or removing grips goes through the controller, changing one needs MarkGripDirty.
+	operator const TArray<FBPActorGripInformation> & () const { return Items; }
+
+	int32 Num() const { return Items.Num(); }
+	bool IsValidIndex(int32 Index) const { return Items.IsValidIndex(Index); }
+
+	FBPActorGripInformation & operator[](int32 Index) { return Items[Index]; }
+	const FBPActorGripInformation & operator[](int32 Index) const { return Items[Index]; }
+
+	FBPActorGripInformation * begin() { return Items.GetData(); }
+	FBPActorGripInformation * end() { return Items.GetData() + Items.Num(); }
+	const FBPActorGripInformation * begin() const { return Items.GetData(); }
+	const FBPActorGripInformation * end() const { return Items.GetData() + Items.Num(); }
+
+	template <typename KeyType>
+	FBPActorGripInformation * FindByKey(const KeyType & Key) { return Items.FindByKey(Key); }
+
+	template <typename KeyType>
+	const FBPActorGripInformation * FindByKey(const KeyType & Key) const { return Items.FindByKey(Key); }
+
+	template <typename KeyType>
+	int32 IndexOfByKey(const KeyType & Key) const { return Items.IndexOfByKey(Key); }
+
+	template <typename KeyType>
+	bool Contains(const KeyType & Key) const { return Items.Contains(Key); }
+};
+
+template<>
+struct TStructOpsTypeTraits< FBPGripArray > : public TStructOpsTypeTraitsBase2<FBPGripArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
 };
 
 USTRUCT(BlueprintType, Category = "VRExpansionLibrary")
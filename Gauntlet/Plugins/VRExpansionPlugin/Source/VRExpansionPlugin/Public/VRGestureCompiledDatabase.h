@@ -0,0 +1,294 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Guid.h"
+
+struct FVRGesture;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Custom serialization version for the gestures database
+struct VREXPANSIONPLUGIN_API FVRGestureDatabaseVersion
+{
+	enum Type
+	{
+		// Before any version changes were made
+		BeforeCustomVersionWasAdded = 0,
+
+		// Cooked databases carry a compiled gesture blob after their properties
+		AddedCompiledGestureData,
+
+		// Cooked databases with a compiled blob leave the gesture samples out of their properties
+		StrippedCookedGestureSamples,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	// The GUID for this custom version number
+	const static FGuid GUID;
+
+private:
+	FVRGestureDatabaseVersion() {}
+};
+
+// Number of gestures scored together by the vectorized DTW kernel, one per vector register lane
+#define VRGESTURE_SIMD_LANES 4
+
+// Magic and version written at the start of every compiled gesture blob
+#define VRGESTURE_COMPILED_MAGIC 0x56524753 // 'VRGS'
+#define VRGESTURE_COMPILED_VERSION 2
+
+// Structure of arrays copy of up to four database gestures, laid out so that one vector register holds the same sample index of each gesture
+// Gestures shorter than the longest in the batch are padded with zeros, their result is read from their own last column
+struct VREXPANSIONPLUGIN_API FVRGestureSIMDBatch
+{
+	// Database index of the gesture in each lane, INDEX_NONE if the lane is unused
+	int32 GestureIndices[VRGESTURE_SIMD_LANES];
+
+	// Sample count of the gesture in each lane
+	int32 Lengths[VRGESTURE_SIMD_LANES];
+
+	// Longest gesture in the batch
+	int32 MaxLength;
+
+	// Offset of the batch in the packed sample data, X then Y then Z blocks indexed as [SampleIndex * VRGESTURE_SIMD_LANES + Lane]
+	int32 DataOffset;
+
+	FVRGestureSIMDBatch()
+	{
+		for (int i = 0; i < VRGESTURE_SIMD_LANES; ++i)
+		{
+			GestureIndices[i] = INDEX_NONE;
+			Lengths[i] = 0;
+		}
+
+		MaxLength = 0;
+		DataOffset = 0;
+	}
+
+	const float * GetX(const float * PackedData) const { return PackedData + DataOffset; }
+	const float * GetY(const float * PackedData) const { return PackedData + DataOffset + MaxLength * VRGESTURE_SIMD_LANES; }
+	const float * GetZ(const float * PackedData) const { return PackedData + DataOffset + MaxLength * VRGESTURE_SIMD_LANES * 2; }
+};
+
+// Quantized units that TargetGestureScale maps to, samples can reach twice this before clamping
+// Kept to 13 bits (plus headroom) so that the squared distance of three axes always fits in an int32
+#define VRGESTURE_QUANTIZED_UNITS 4095
+#define VRGESTURE_QUANTIZED_LIMIT 8191
+
+// 16 bit fixed point gesture sample, a third of the size of an FVector
+// Only valid for samples that were scaled to the database, the scale is VRGESTURE_QUANTIZED_UNITS / TargetGestureScale
+struct VREXPANSIONPLUGIN_API FVRGestureQuantizedSample
+{
+	int16 X;
+	int16 Y;
+	int16 Z;
+
+	FVRGestureQuantizedSample() :
+		X(0),
+		Y(0),
+		Z(0)
+	{}
+
+	FVRGestureQuantizedSample(const FVector & Sample, float QuantizeScale)
+	{
+		X = (int16)FMath::Clamp(FMath::RoundToInt(Sample.X * QuantizeScale), -VRGESTURE_QUANTIZED_LIMIT, VRGESTURE_QUANTIZED_LIMIT);
+		Y = (int16)FMath::Clamp(FMath::RoundToInt(Sample.Y * QuantizeScale), -VRGESTURE_QUANTIZED_LIMIT, VRGESTURE_QUANTIZED_LIMIT);
+		Z = (int16)FMath::Clamp(FMath::RoundToInt(Sample.Z * QuantizeScale), -VRGESTURE_QUANTIZED_LIMIT, VRGESTURE_QUANTIZED_LIMIT);
+	}
+
+	// Squared distance in quantized units
+	FORCEINLINE int32 DistSquared(const FVRGestureQuantizedSample & Other) const
+	{
+		const int32 DeltaX = (int32)X - Other.X;
+		const int32 DeltaY = (int32)Y - Other.Y;
+		const int32 DeltaZ = (int32)Z - Other.Z;
+		return DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ;
+	}
+};
+
+// Bounding envelope of a database gesture, used to lower bound its DTW cost before running the full table
+struct VREXPANSIONPLUGIN_API FVRGestureEnvelope
+{
+	// Bounds of the gesture samples
+	FBox Bounds;
+
+	// Bounds of the gesture samples mirrored on the Y axis
+	FBox MirroredBounds;
+
+	FVRGestureEnvelope() :
+		Bounds(ForceInit),
+		MirroredBounds(ForceInit)
+	{}
+
+	void Build(const TArray<FVector> & Samples)
+	{
+		Bounds.Init();
+		MirroredBounds.Init();
+
+		for (const FVector & Sample : Samples)
+		{
+			Bounds += Sample;
+			MirroredBounds += FVector(Sample.X, -Sample.Y, Sample.Z);
+		}
+	}
+
+	// Squared distance between two boxes, zero if they overlap
+	static float BoxDistSquared(const FBox & A, const FBox & B)
+	{
+		const float DeltaX = FMath::Max3(0.f, A.Min.X - B.Max.X, B.Min.X - A.Max.X);
+		const float DeltaY = FMath::Max3(0.f, A.Min.Y - B.Max.Y, B.Min.Y - A.Max.Y);
+		const float DeltaZ = FMath::Max3(0.f, A.Min.Z - B.Max.Z, B.Min.Z - A.Max.Z);
+		return DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ;
+	}
+};
+
+// Header at the start of a compiled gesture blob, offsets in the blob are in elements from the start of their section
+struct FVRCompiledGestureHeader
+{
+	uint32 Magic;
+	uint32 Version;
+
+	// Number of gesture records, matches the database gesture count it was compiled from
+	int32 GestureCount;
+
+	// Number of FVector samples in the sample section, including mirrored copies
+	int32 SampleCount;
+
+	// Number of structure of arrays batches and the float count of their section
+	int32 SIMDBatchCount;
+	int32 SIMDFloatCount;
+
+	// Scale that the database was compiled at
+	float TargetGestureScale;
+
+	// Hash of the samples at the database scale, used to detect a blob that is out of date with its database
+	uint32 SourceHash;
+};
+
+// Per gesture record in a compiled gesture blob
+struct FVRCompiledGestureRecord
+{
+	// Offset and count in the sample section, samples are newest first like FVRGesture::Samples
+	// Gestures that scale are stored at TargetGestureScale
+	int32 SampleOffset;
+	int32 SampleCount;
+
+	// Offset of the Y mirrored copy of the samples, INDEX_NONE if the gesture never mirrors
+	int32 MirroredSampleOffset;
+
+	// Bounds of the normal and mirrored samples
+	FVRGestureEnvelope Envelope;
+};
+
+/**
+* Compiled, contiguous copy of a gesture database laid out for detection.
+* The blob is a single block of memory, either owned (bulk serialized with a cooked database) or a read only memory mapped file,
+* everything in it is read through views so loading it costs no per gesture allocation.
+*
+* Layout: Header | Records[GestureCount] | SIMDBatches[SIMDBatchCount] | Samples[SampleCount] | SIMDData[SIMDFloatCount]
+* The blob is in native byte order, it is compiled when cooking for the target that loads it.
+*/
+class VREXPANSIONPLUGIN_API FVRCompiledGestureDatabase
+{
+public:
+
+	FVRCompiledGestureDatabase();
+	~FVRCompiledGestureDatabase();
+
+	// Owns a mapping, so no copying
+	FVRCompiledGestureDatabase(const FVRCompiledGestureDatabase &) = delete;
+	FVRCompiledGestureDatabase & operator=(const FVRCompiledGestureDatabase &) = delete;
+
+	// Builds the blob from the given gestures, the samples of gestures that scale are brought to TargetGestureScale first
+	void Compile(const TArray<FVRGesture> & Gestures, float TargetGestureScale);
+
+	// Scales samples so that their largest extent is TargetGestureScale, returns false if they were already at that scale or have no extent
+	static bool ScaleSamplesToDatabase(TArray<FVector> & Samples, float TargetGestureScale);
+
+	// Packs gestures into structure of arrays batches, similar lengths are grouped together to keep padding low
+	static void PackSIMDBatches(const TArray<FVRGesture> & Gestures, TArray<FVRGestureSIMDBatch> & OutBatches, TArray<float> & OutPackedData);
+
+	// Hashes the sample data (as it would be compiled at TargetGestureScale) and mirror modes of a set of gestures,
+	// used to check if a blob still matches its source
+	static uint32 HashGestures(const TArray<FVRGesture> & Gestures, float TargetGestureScale);
+
+	// Bulk serializes the blob, only one allocation is made when loading
+	void Serialize(FArchive & Ar);
+
+	// Memory maps a blob written with WriteToFile, returns false if the file is missing or invalid
+	bool MapFile(const FString & Filename);
+
+	// Writes the blob to a file so that it can be memory mapped later
+	bool WriteToFile(const FString & Filename) const;
+
+	// Releases the blob and any mapping
+	void Reset();
+
+	// Returns true if there is a blob and its header is valid for this version
+	bool IsValid() const;
+
+	// Hashes the sample counts, mirror modes and scaling of a set of gestures, cheap enough to check every time cached data is about to be read
+	static uint32 HashGestureLayout(const TArray<FVRGesture> & Gestures);
+
+	// Returns true if the blob is valid and was compiled from exactly these gestures at this scale
+	bool Matches(const TArray<FVRGesture> & Gestures, float TargetGestureScale) const;
+
+	const FVRCompiledGestureHeader * GetHeader() const
+	{
+		return (const FVRCompiledGestureHeader *)GetData();
+	}
+
+	const FVRCompiledGestureRecord * GetRecords() const
+	{
+		return (const FVRCompiledGestureRecord *)(GetData() + sizeof(FVRCompiledGestureHeader));
+	}
+
+	const FVRGestureSIMDBatch * GetSIMDBatches() const
+	{
+		return (const FVRGestureSIMDBatch *)(GetRecords() + GetHeader()->GestureCount);
+	}
+
+	const FVector * GetSamples() const
+	{
+		return (const FVector *)(GetSIMDBatches() + GetHeader()->SIMDBatchCount);
+	}
+
+	const float * GetSIMDData() const
+	{
+		return (const float *)(GetSamples() + GetHeader()->SampleCount);
+	}
+
+	// Samples of a single gesture, optionally the mirrored copy (falls back to the normal samples if it wasn't compiled with one)
+	TArrayView<const FVector> GetGestureSamples(int GestureIndex, bool bMirrored = false) const
+	{
+		const FVRCompiledGestureRecord & Record = GetRecords()[GestureIndex];
+		const int32 Offset = (bMirrored && Record.MirroredSampleOffset != INDEX_NONE) ? Record.MirroredSampleOffset : Record.SampleOffset;
+		return TArrayView<const FVector>(GetSamples() + Offset, Record.SampleCount);
+	}
+
+	const uint8 * GetData() const
+	{
+		return MappedRegion ? MappedData : Blob.GetData();
+	}
+
+	int64 GetDataSize() const
+	{
+		return MappedRegion ? MappedDataSize : Blob.Num();
+	}
+
+private:
+
+	static int64 GetExpectedSize(const FVRCompiledGestureHeader & Header);
+
+	// Owned blob when bulk serialized or compiled
+	TArray<uint8> Blob;
+
+	// Mapping when loaded from a file
+	IMappedFileHandle * MappedHandle;
+	IMappedFileRegion * MappedRegion;
+	const uint8 * MappedData;
+	int64 MappedDataSize;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "VRBPDatatypes.h"
+#include "VRGestureCompiledDatabase.h"
+#include "VRGesturePrefilter.h"
 #include "Algo/Reverse.h"
 #include "Components/SplineMeshComponent.h"
 #include "Components/SplineComponent.h"
@@ -14,9 +16,11 @@
 #include "Engine/EngineTypes.h"
 #include "Engine/EngineBaseTypes.h"
 #include "TimerManager.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "VRGestureComponent.generated.h"
 
 DECLARE_STATS_GROUP(TEXT("TICKGesture"), STATGROUP_TickGesture, STATCAT_Advanced);
+DECLARE_LOG_CATEGORY_EXTERN(LogVRGestureComponent, Log, All);
 
 
 UENUM(Blueprintable)
@@ -37,6 +41,17 @@ enum class EVRGestureMirrorMode : uint8
 	GES_MirrorBoth
 };
 
+UENUM(Blueprintable)
+enum class EVRGestureWarpingWindow : uint8
+{
+	// Full DTW table, only limited by the max slope
+	GES_NoWindow,
+	// Band of WindowRadius samples around the diagonal
+	GES_SakoeChiba,
+	// Parallelogram with sides of WindowSlope and 1 / WindowSlope, anchored on the newest sample
+	GES_Itakura
+};
+
 USTRUCT(BlueprintType, Category = "VRGestures")
 struct VREXPANSIONPLUGIN_API FVRGestureSettings
 {
@@ -68,6 +83,19 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture|Advanced")
 		bool bEnableScaling;
 
+	// Limits how far the input can warp against this gesture, cells outside of the window are never evaluated
+	// Rejects pathological warps so the FullThreshold can generally be lowered, not used by streaming detection
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture|Advanced")
+		EVRGestureWarpingWindow WarpingWindow;
+
+	// Sakoe-Chiba radius in samples around the diagonal
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture|Advanced", meta = (ClampMin = "0", EditCondition = "WarpingWindow == EVRGestureWarpingWindow::GES_SakoeChiba"))
+		int WindowRadius;
+
+	// Itakura maximum slope, 2.0 allows the input to be drawn between half and double the speed of the gesture
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture|Advanced", meta = (ClampMin = "1.0", EditCondition = "WarpingWindow == EVRGestureWarpingWindow::GES_Itakura"))
+		float WindowSlope;
+
 	FVRGestureSettings()
 	{
 		Minimum_Gesture_Length = 1;
@@ -76,6 +104,59 @@ public:
 		MirrorMode = EVRGestureMirrorMode::GES_NoMirror;
 		bEnabled = true;
 		bEnableScaling = true;
+		WarpingWindow = EVRGestureWarpingWindow::GES_NoWindow;
+		WindowRadius = 5;
+		WindowSlope = 2.0f;
+	}
+
+	// Last input row that can still end a path inside of the window
+	int GetWindowLastRow(int InputLength, int GestureLength) const
+	{
+		switch (WarpingWindow)
+		{
+		case EVRGestureWarpingWindow::GES_SakoeChiba: return FMath::Min(InputLength, GestureLength + FMath::Max(WindowRadius, 0)); break;
+		case EVRGestureWarpingWindow::GES_Itakura: return FMath::Min(InputLength, FMath::FloorToInt(GestureLength * FMath::Max(WindowSlope, 1.f) + KINDA_SMALL_NUMBER)); break;
+		case EVRGestureWarpingWindow::GES_NoWindow:
+		default: return InputLength; break;
+		}
+	}
+
+	// Gets the range of gesture columns (1 based like the DTW table) that are inside of the window on the given input row
+	// Returns false if the row has no cells inside of the window
+	bool GetWindowRange(int Row, int InputLength, int GestureLength, int & OutLow, int & OutHigh) const
+	{
+		OutLow = 1;
+		OutHigh = GestureLength;
+
+		switch (WarpingWindow)
+		{
+		case EVRGestureWarpingWindow::GES_SakoeChiba:
+		{
+			const int Radius = FMath::Max(WindowRadius, 0);
+			OutLow = FMath::Max(OutLow, Row - Radius);
+			OutHigh = FMath::Min(OutHigh, Row + Radius);
+		}break;
+
+		case EVRGestureWarpingWindow::GES_Itakura:
+		{
+			const float Slope = FMath::Max(WindowSlope, 1.f);
+			const int LastRow = GetWindowLastRow(InputLength, GestureLength);
+			const int FirstRow = FMath::Max(1, FMath::CeilToInt(GestureLength / Slope - KINDA_SMALL_NUMBER));
+
+			// Reachable from the start
+			OutLow = FMath::Max(OutLow, FMath::CeilToInt(Row / Slope - KINDA_SMALL_NUMBER));
+			OutHigh = FMath::Min(OutHigh, FMath::FloorToInt(Row * Slope + KINDA_SMALL_NUMBER));
+
+			// Can still reach the last gesture sample on a valid end row
+			OutLow = FMath::Max(OutLow, FMath::CeilToInt(GestureLength - (LastRow - Row) * Slope - KINDA_SMALL_NUMBER));
+			OutHigh = FMath::Min(OutHigh, FMath::FloorToInt(GestureLength - (FirstRow - Row) / Slope + KINDA_SMALL_NUMBER));
+		}break;
+
+		case EVRGestureWarpingWindow::GES_NoWindow:
+		default:break;
+		}
+
+		return OutLow <= OutHigh;
 	}
 };
 
@@ -140,6 +221,241 @@ public:
 	}
 };
 
+// Read only view of a gestures samples (newest first) and size, lets detection run on the live sample window without copying it
+struct VREXPANSIONPLUGIN_API FVRGestureView
+{
+	TArrayView<const FVector> Samples;
+	FBox GestureSize;
+
+	FVRGestureView() :
+		GestureSize(ForceInit)
+	{}
+
+	FVRGestureView(const FVRGesture & Gesture) :
+		Samples(Gesture.Samples),
+		GestureSize(Gesture.GestureSize)
+	{}
+
+	FVRGestureView(TArrayView<const FVector> InSamples, const FBox & InGestureSize) :
+		Samples(InSamples),
+		GestureSize(InGestureSize)
+	{}
+};
+
+// Monotonic queue over a sliding window of values, keeps the minimum (or maximum) of the window in amortized O(1) per push
+struct VREXPANSIONPLUGIN_API FVRSlidingWindowExtreme
+{
+	struct FEntry
+	{
+		float Value;
+		int32 Sequence;
+	};
+
+	// Fixed size ring of entries, values are in increasing (decreasing for the max) order from front to back
+	TArray<FEntry> Entries;
+	int32 Front;
+	int32 Count;
+	bool bMax;
+
+	FVRSlidingWindowExtreme() :
+		Front(0),
+		Count(0),
+		bMax(false)
+	{}
+
+	void Init(int32 WindowSize, bool bInMax)
+	{
+		Entries.SetNumUninitialized(WindowSize + 1, false);
+		bMax = bInMax;
+		Reset();
+	}
+
+	void Reset()
+	{
+		Front = 0;
+		Count = 0;
+	}
+
+	// Adds the newest value, entries with a sequence before OldestSequence have left the window
+	void Push(float Value, int32 Sequence, int32 OldestSequence)
+	{
+		const int32 Capacity = Entries.Num();
+
+		// Anything that the new value beats can never be the extreme again
+		while (Count > 0)
+		{
+			const FEntry & Back = Entries[(Front + Count - 1) % Capacity];
+			if (bMax ? Back.Value > Value : Back.Value < Value)
+				break;
+
+			Count--;
+		}
+
+		while (Count > 0 && Entries[Front].Sequence < OldestSequence)
+		{
+			Front = (Front + 1) % Capacity;
+			Count--;
+		}
+
+		FEntry & NewEntry = Entries[(Front + Count) % Capacity];
+		NewEntry.Value = Value;
+		NewEntry.Sequence = Sequence;
+		Count++;
+	}
+
+	float Get() const
+	{
+		return Entries[Front].Value;
+	}
+};
+
+// Fixed capacity window of the newest gesture samples with an exact bounding box of the samples in it
+// Samples are kept contiguous and newest first in a buffer twice the capacity, the window is only moved when it runs out of room at the front,
+// so pushing is amortized O(1) and the samples can be read through a view without copying them.
+struct VREXPANSIONPLUGIN_API FVRGestureSampleWindow
+{
+	TArray<FVector> Buffer;
+	int32 Head;
+	int32 Count;
+	int32 Capacity;
+	int32 Sequence;
+
+	// Min and max per axis
+	FVRSlidingWindowExtreme Mins[3];
+	FVRSlidingWindowExtreme Maxs[3];
+
+	FVRGestureSampleWindow() :
+		Head(0),
+		Count(0),
+		Capacity(0),
+		Sequence(0)
+	{}
+
+	// Sizes the window, only allocates if the capacity changed
+	void Init(int32 InCapacity)
+	{
+		InCapacity = FMath::Max(InCapacity, 1);
+
+		if (InCapacity != Capacity)
+		{
+			Capacity = InCapacity;
+			Buffer.SetNumUninitialized(Capacity * 2, false);
+
+			for (int Axis = 0; Axis < 3; ++Axis)
+			{
+				Mins[Axis].Init(Capacity, false);
+				Maxs[Axis].Init(Capacity, true);
+			}
+		}
+
+		Reset();
+	}
+
+	void Reset()
+	{
+		Head = Buffer.Num();
+		Count = 0;
+		Sequence = 0;
+
+		for (int Axis = 0; Axis < 3; ++Axis)
+		{
+			Mins[Axis].Reset();
+			Maxs[Axis].Reset();
+		}
+	}
+
+	// Adds the newest sample, dropping the oldest if the window is full
+	void Push(const FVector & Sample)
+	{
+		if (Capacity < 1)
+			return;
+
+		if (Count == Capacity)
+			Count--;
+
+		// Out of room at the front, move the window to the back half of the buffer
+		if (Head == 0)
+		{
+			FMemory::Memmove(Buffer.GetData() + Capacity, Buffer.GetData(), Count * sizeof(FVector));
+			Head = Capacity;
+		}
+
+		Head--;
+		Buffer[Head] = Sample;
+		Count++;
+
+		const int32 OldestSequence = Sequence - Count + 1;
+		for (int Axis = 0; Axis < 3; ++Axis)
+		{
+			Mins[Axis].Push(Sample[Axis], Sequence, OldestSequence);
+			Maxs[Axis].Push(Sample[Axis], Sequence, OldestSequence);
+		}
+
+		Sequence++;
+	}
+
+	int32 Num() const
+	{
+		return Count;
+	}
+
+	// Newest sample, the window must not be empty
+	const FVector & GetNewest() const
+	{
+		return Buffer[Head];
+	}
+
+	// Samples in the window, newest first like FVRGesture::Samples
+	TArrayView<const FVector> GetSamples() const
+	{
+		return TArrayView<const FVector>(Buffer.GetData() + Head, Count);
+	}
+
+	// Exact bounds of the samples currently in the window
+	FBox GetBounds() const
+	{
+		if (Count < 1)
+			return FBox(ForceInit);
+
+		return FBox(FVector(Mins[0].Get(), Mins[1].Get(), Mins[2].Get()), FVector(Maxs[0].Get(), Maxs[1].Get(), Maxs[2].Get()));
+	}
+
+	FVRGestureView GetView() const
+	{
+		return FVRGestureView(GetSamples(), GetBounds());
+	}
+
+	// Copies the window into a gesture
+	void CopyTo(FVRGesture & OutGesture) const
+	{
+		OutGesture.Samples.Reset();
+		OutGesture.Samples.Append(Buffer.GetData() + Head, Count);
+		OutGesture.GestureSize = GetBounds();
+	}
+};
+
+// Resamples and simplifies gesture samples, keeps its scratch buffers around so that processing the live window doesn't allocate
+// Sample order is kept as is and the first and last samples are always kept
+struct VREXPANSIONPLUGIN_API FVRGestureSampleProcessor
+{
+	TArray<FVector> Scratch;
+	TArray<int32> Stack;
+	TArray<bool> Keep;
+
+	// Places samples evenly along the path of the input, Spacing apart
+	static void ResampleByArcLength(TArrayView<const FVector> InSamples, float Spacing, TArray<FVector> & OutSamples);
+
+	// Drops samples that are within Tolerance of the simplified path (Douglas-Peucker)
+	void Simplify(TArrayView<const FVector> InSamples, float Tolerance, TArray<FVector> & OutSamples);
+
+	// Rotates the samples around the forward (X) axis about the oldest sample so that the principal axis of the stroke lies along +Y,
+	// oriented from the oldest towards the newest sample. Removes the roll of a stroke so that slightly rotated versions line up.
+	static void AlignToPrincipalAxis(TArray<FVector> & Samples);
+
+	// Simplifies then resamples, then optionally aligns, a Spacing or Tolerance of 0 skips that step, InSamples and OutSamples must not be the same array
+	void Process(TArrayView<const FVector> InSamples, float Spacing, float Tolerance, bool bAlignToPrincipalAxis, TArray<FVector> & OutSamples);
+};
+
 /**
 * Items Database DataAsset, here we can save all of our game items
 */
@@ -150,25 +466,356 @@ class VREXPANSIONPLUGIN_API UGesturesDatabase : public UDataAsset
 public:
 
 	// Gestures in this database
+	// If bStripCookedSamples is set cooked databases load without their samples, detection reads them from the compiled copy.
+	// Call RestoreGestureSamples before reading the samples from here directly, the functions that modify the gestures restore them on their own.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 	TArray <FVRGesture> Gestures;
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 		float TargetGestureScale;
 
+	// If larger than 0 gestures are resampled to points this far apart along their path when saved or imported, in database scale
+	// Detection resamples the live samples to the same spacing (scaled to the live gesture) before comparing them
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Sampling")
+		float ResampleSpacing;
+
+	// If larger than 0 samples within this distance of the simplified path are dropped when saved, imported or detected, in database scale
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Sampling")
+		float SimplifyTolerance;
+
+	// If true gestures are rotated to a canonical orientation (principal axis of the stroke along +Y) when saved, imported or detected,
+	// so strokes drawn with a bit of roll still match. Gestures that only differ by their roll can no longer be told apart.
+	// Streaming detection compares the raw samples as they come in and ignores this.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Sampling")
+		bool bAlignToPrincipalAxis;
+
+	// If true gestures that scale to the database are also kept as 16 bit fixed point samples and the full table DTW compares them with
+	// integer distances. A third of the memory traffic of the float samples, costs are within the quantization step (TargetGestureScale / 4095).
+	// Windowed, streaming and vectorized detection keep using the float samples.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Sampling")
+		bool bUseQuantizedSamples;
+
+	// If true cooked builds leave the gesture samples out of the Gestures property and only load the compiled copy, saving the
+	// allocation per gesture. Anything reading FVRGesture::Samples directly (DrawDebugGesture, FillSplineWithGesture, Blueprints)
+	// sees empty samples until RestoreGestureSamples is called, which brings them back at the database scale.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "VRGestures|Cooking")
+		bool bStripCookedSamples;
+
+	// Optional filter that rejects gestures on cheap shape features before the DTW runs, used by the scalar, vectorized and batched detection
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Instanced, Category = "VRGestures|Prefilter")
+		UVRGesturePrefilter * Prefilter;
+
 	UGesturesDatabase()
 	{
 		TargetGestureScale = 100.0f;
+		ResampleSpacing = 0.0f;
+		SimplifyTolerance = 0.0f;
+		bAlignToPrincipalAxis = false;
+		bUseQuantizedSamples = false;
+		bStripCookedSamples = false;
+		Prefilter = nullptr;
+		bGestureCacheDirty = true;
+		bUseCompiledGestures = false;
+		bSamplesStripped = false;
+		CachedGestureCount = 0;
+		CachedGestureLayout = 0;
 	}
 
+	// Data derived from the gestures for detection, rebuilt on demand when the gestures change
+	bool bGestureCacheDirty;
+	int CachedGestureCount;
+
+	// Hash of the sample counts, mirror modes and scaling the cache was built with, a gesture that changed any of them without
+	// MarkGesturesDirty being called would otherwise be read with a stale length, mirroring or prefilter index
+	uint32 CachedGestureLayout;
+
+	// Compiled copy of the gestures, built when cooking and bulk loaded with the asset
+	FVRCompiledGestureDatabase CompiledGestures;
+
+	// True if the compiled copy matches the gestures and the cached data is read from it
+	bool bUseCompiledGestures;
+
+	// True if this was cooked without the gesture samples, they are only in the compiled copy until RestoreGestureSamples is called
+	bool bSamplesStripped;
+
+	// Structure of arrays copies of the gestures for the vectorized DTW, unused when reading from the compiled copy
+	TArray<FVRGestureSIMDBatch> SIMDBatches;
+	TArray<float> SIMDSampleData;
+
+	// Bounding envelope of each gesture for the lower bound pruning, same indices as Gestures, unused when reading from the compiled copy
+	TArray<FVRGestureEnvelope> GestureEnvelopes;
+
+	// Y mirrored copies of the gestures that can mirror, so the DTW never has to mirror per cell, unused when reading from the compiled copy
+	TArray<FVector> MirroredSampleData;
+
+	// Offset of each gestures mirrored copy in MirroredSampleData, INDEX_NONE if the gesture never mirrors
+	TArray<int32> MirroredSampleOffsets;
+
+	// Sample count of each gesture when the cache was built, the length of both its normal and mirrored views
+	TArray<int32> GestureSampleCounts;
+
+	// Fixed point copies of the scaling gestures when using quantized samples, both the normal and mirrored copies live here
+	TArray<FVRGestureQuantizedSample> QuantizedSampleData;
+
+	// Offsets in QuantizedSampleData, two per gesture (normal then mirrored), INDEX_NONE if the gesture has no copy
+	TArray<int32> QuantizedSampleOffsets;
+
+	// Background recognitions that are reading the gestures and cached data, they are waited on before either is changed
+	TArray<FGraphEventRef> AsyncReaders;
+
+	// Registers a background recognition task that reads from this database
+	void AddAsyncReader(const FGraphEventRef & Task)
+	{
+		AsyncReaders.RemoveAll([](const FGraphEventRef & Reader) { return !Reader.IsValid() || Reader->IsComplete(); });
+		AsyncReaders.Add(Task);
+	}
+
+	// Blocks until a background recognition is done. The game thread only processes its local queue while waiting, so the
+	// recognition completion callbacks (queued on the main game thread queue) can't run in the middle of whatever is about to modify the data
+	static void WaitForAsyncReader(const FGraphEventRef & Task)
+	{
+		if (Task.IsValid() && !Task->IsComplete())
+		{
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task, IsInGameThread() ? ENamedThreads::GameThread_Local : ENamedThreads::AnyThread);
+		}
+	}
+
+	// Blocks until every background recognition reading from this database is done, call before modifying the gestures
+	void WaitForAsyncReaders()
+	{
+		for (const FGraphEventRef & Reader : AsyncReaders)
+		{
+			WaitForAsyncReader(Reader);
+		}
+
+		AsyncReaders.Reset();
+	}
+
+	// Copies the samples of a cooked database back out of the compiled copy so that they can be read or modified
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+	void RestoreGestureSamples();
+
+	// Waits on background readers and restores stripped samples, call before modifying the gestures
+	void PrepareToModifyGestures()
+	{
+		WaitForAsyncReaders();
+		RestoreGestureSamples();
+	}
+
+	// Rebuilds the cached data if the gestures changed since it was built
+	void UpdateGestureCache()
+	{
+		const uint32 GestureLayout = FVRCompiledGestureDatabase::HashGestureLayout(Gestures);
+
+		if (bGestureCacheDirty || CachedGestureCount != Gestures.Num() || CachedGestureLayout != GestureLayout)
+		{
+			WaitForAsyncReaders();
+
+			// The stripped samples were compiled at cook time, so there is nothing to hash them against. If gestures were added to the
+			// array directly since then, the compiled copy no longer lines up and the samples have to come back
+			if (bSamplesStripped && !(CompiledGestures.IsValid() && CompiledGestures.GetHeader()->GestureCount == Gestures.Num()))
+				RestoreGestureSamples();
+
+			bUseCompiledGestures = bSamplesStripped || CompiledGestures.Matches(Gestures, TargetGestureScale);
+
+			if (bUseCompiledGestures)
+			{
+				SIMDBatches.Empty();
+				SIMDSampleData.Empty();
+				GestureEnvelopes.Empty();
+				MirroredSampleData.Empty();
+				MirroredSampleOffsets.Empty();
+				GestureSampleCounts.Empty();
+			}
+			else
+			{
+				CompiledGestures.Reset();
+				FVRCompiledGestureDatabase::PackSIMDBatches(Gestures, SIMDBatches, SIMDSampleData);
+				BuildGestureEnvelopes();
+				BuildMirroredSamples();
+			}
+
+			BuildQuantizedSamples();
+
+			if (Prefilter)
+				Prefilter->BuildGestureFeatures(*this);
+
+			bGestureCacheDirty = false;
+			CachedGestureCount = Gestures.Num();
+			CachedGestureLayout = GestureLayout;
+		}
+	}
+
+	// Returns the packed gesture batches, rebuilding them if the gestures changed
+	TArrayView<const FVRGestureSIMDBatch> GetSIMDBatches()
+	{
+		UpdateGestureCache();
+
+		if (bUseCompiledGestures)
+			return TArrayView<const FVRGestureSIMDBatch>(CompiledGestures.GetSIMDBatches(), CompiledGestures.GetHeader()->SIMDBatchCount);
+
+		return SIMDBatches;
+	}
+
+	// Returns the sample data that the batch offsets index into, call GetSIMDBatches first
+	const float * GetSIMDSampleData() const
+	{
+		return bUseCompiledGestures ? CompiledGestures.GetSIMDData() : SIMDSampleData.GetData();
+	}
+
+	// Returns the envelope of a gesture, call UpdateGestureCache first
+	const FVRGestureEnvelope & GetGestureEnvelope(int GestureIndex) const
+	{
+		return bUseCompiledGestures ? CompiledGestures.GetRecords()[GestureIndex].Envelope : GestureEnvelopes[GestureIndex];
+	}
+
+	// Calculates the normal and mirrored bounds of each gesture
+	void BuildGestureEnvelopes();
+
+	// Generates the mirrored copy of every gesture that can mirror and records the sample counts
+	void BuildMirroredSamples();
+
+	// Returns the samples of a gesture to compare against, the mirrored copy if requested, call UpdateGestureCache first
+	TArrayView<const FVector> GetGestureSamples(int GestureIndex, bool bMirrored) const
+	{
+		if (bUseCompiledGestures)
+			return CompiledGestures.GetGestureSamples(GestureIndex, bMirrored);
+
+		const int32 MirroredOffset = bMirrored ? MirroredSampleOffsets[GestureIndex] : INDEX_NONE;
+
+		if (MirroredOffset != INDEX_NONE)
+			return TArrayView<const FVector>(MirroredSampleData.GetData() + MirroredOffset, GestureSampleCounts[GestureIndex]);
+
+		return TArrayView<const FVector>(Gestures[GestureIndex].Samples.GetData(), GestureSampleCounts[GestureIndex]);
+	}
+
+	// Returns the sample count of a gesture, call UpdateGestureCache first
+	int GetGestureSampleCount(int GestureIndex) const
+	{
+		return bUseCompiledGestures ? CompiledGestures.GetRecords()[GestureIndex].SampleCount : GestureSampleCounts[GestureIndex];
+	}
+
+	// Generates the fixed point copies of the gestures if using quantized samples, otherwise releases them
+	void BuildQuantizedSamples();
+
+	// Scale from database units to quantized units
+	float GetQuantizeScale() const
+	{
+		return VRGESTURE_QUANTIZED_UNITS / TargetGestureScale;
+	}
+
+	// Converts a squared distance in quantized units back to database units
+	float GetQuantizedDistanceScale() const
+	{
+		return FMath::Square(TargetGestureScale / VRGESTURE_QUANTIZED_UNITS);
+	}
+
+	// Returns true if the gesture has a fixed point copy to compare against, call UpdateGestureCache first
+	bool HasQuantizedSamples(int GestureIndex) const
+	{
+		return QuantizedSampleOffsets.Num() > GestureIndex * 2 && QuantizedSampleOffsets[GestureIndex * 2] != INDEX_NONE;
+	}
+
+	// Returns the fixed point samples of a gesture, the gesture must have them
+	TArrayView<const FVRGestureQuantizedSample> GetQuantizedGestureSamples(int GestureIndex, bool bMirrored) const
+	{
+		const int32 MirroredOffset = bMirrored ? QuantizedSampleOffsets[GestureIndex * 2 + 1] : INDEX_NONE;
+		const int32 Offset = MirroredOffset != INDEX_NONE ? MirroredOffset : QuantizedSampleOffsets[GestureIndex * 2];
+		return TArrayView<const FVRGestureQuantizedSample>(QuantizedSampleData.GetData() + Offset, GetGestureSampleCount(GestureIndex));
+	}
+
+	// Returns true if gestures and live samples are resampled, simplified or aligned for this database
+	bool ShouldProcessSamples() const
+	{
+		return ResampleSpacing > 0.0f || SimplifyTolerance > 0.0f || bAlignToPrincipalAxis;
+	}
+
+	// Resamples and simplifies a gesture with the database settings and recalculates its size, the gesture should already be at database scale
+	void ProcessGestureSamples(FVRGesture & Gesture)
+	{
+		if (!ShouldProcessSamples() || Gesture.Samples.Num() < 3)
+			return;
+
+		FVRGestureSampleProcessor Processor;
+		TArray<FVector> ProcessedSamples;
+		Processor.Process(Gesture.Samples, ResampleSpacing, SimplifyTolerance, bAlignToPrincipalAxis, ProcessedSamples);
+		Gesture.Samples = MoveTemp(ProcessedSamples);
+
+		// Rotating changes the extents, so aligned gestures are brought back to the database scale
+		Gesture.GestureSize = FBox(ForceInit);
+		Gesture.CalculateSizeOfGesture(bAlignToPrincipalAxis && Gesture.GestureSettings.bEnableScaling, TargetGestureScale);
+	}
+
+	// Applies the current ResampleSpacing, SimplifyTolerance and bAlignToPrincipalAxis to every gesture in the database
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+	void ProcessAllGestureSamples()
+	{
+		PrepareToModifyGestures();
+
+		for (FVRGesture & Gesture : Gestures)
+		{
+			ProcessGestureSamples(Gesture);
+		}
+
+		MarkGesturesDirty();
+	}
+
+	// Compiles the gestures into a single contiguous blob that detection reads from, done automatically when cooking
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+	void CompileGestures();
+
+	// Memory maps a compiled copy written with FVRCompiledGestureDatabase::WriteToFile, it is only used if it matches the gestures
+	bool MapCompiledGestures(const FString & Filename)
+	{
+		PrepareToModifyGestures();
+		const bool bMapped = CompiledGestures.MapFile(Filename);
+		MarkGesturesDirty();
+		return bMapped;
+	}
+
+	// Call after changing gesture samples or mirror modes directly so that any cached data built from them is regenerated
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+	void MarkGesturesDirty()
+	{
+		bGestureCacheDirty = true;
+	}
+
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+
+	virtual void BeginDestroy() override
+	{
+		// Recognitions hold on to the database they were started with, even if their component has moved on to another one since
+		WaitForAsyncReaders();
+		Super::BeginDestroy();
+	}
+
+#if WITH_EDITOR
+	virtual void PreEditChange(UProperty* PropertyAboutToChange) override
+	{
+		PrepareToModifyGestures();
+		Super::PreEditChange(PropertyAboutToChange);
+	}
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override
+	{
+		Super::PostEditChangeProperty(PropertyChangedEvent);
+		MarkGesturesDirty();
+	}
+#endif
+
 	// Recalculate size of gestures and re-scale them to the TargetGestureScale (if bScaleToDatabase is true)
 	UFUNCTION(BlueprintCallable, Category = "VRGestures")
 	void RecalculateGestures(bool bScaleToDatabase = true)
 	{
+		PrepareToModifyGestures();
+
 		for (int i = 0; i < Gestures.Num(); ++i)
 		{
 			Gestures[i].CalculateSizeOfGesture(bScaleToDatabase, TargetGestureScale);
 		}
+
+		MarkGesturesDirty();
 	}
 
 	// Fills a spline component with a gesture, optionally also generates spline mesh components for it (uses ones already attached if possible)
@@ -265,7 +912,10 @@ public:
 		}
 
 		NewGesture.CalculateSizeOfGesture(bScaleToDatabase, this->TargetGestureScale);
+		ProcessGestureSamples(NewGesture);
+		PrepareToModifyGestures();
 		Gestures.Add(NewGesture);
+		MarkGesturesDirty();
 		return true;
 	}
 };
@@ -277,33 +927,30 @@ struct VREXPANSIONPLUGIN_API FVRGestureSplineDraw
 	GENERATED_BODY()
 public:
 
-	UPROPERTY()
-	USplineComponent* SplineComponent;
-
+	// Fixed ring of spline mesh segments, created and registered in Init so that drawing never creates components
 	UPROPERTY()
 	TArray<USplineMeshComponent*> SplineMeshes;
 
-	int LastIndexSet;
-	int NextIndexCleared;
+	// Ring slot that the next segment is drawn into
+	int NextSegment;
 
-	// Marches through the array and clears the last point
-	void ClearLastPoint()
-	{
-		SplineComponent->RemoveSplinePoint(0, false);
+	// Number of segments drawn since the last reset, capped at the ring size
+	int ActiveSegments;
 
-		if (SplineMeshes.Num() < NextIndexCleared + 1)
-			NextIndexCleared = 0;
+	// Last two points added, newest first, used to calculate the tangents
+	FVector LastPoints[2];
+	int PointCount;
 
-		SplineMeshes[NextIndexCleared]->SetVisibility(false);
-		NextIndexCleared++;
-	}
+	// Sizes the ring for a recording and places the segments at the start of it, only creates or registers components if the ring has to grow
+	void Init(USceneComponent * Owner, int SegmentCount, UStaticMesh * Mesh, UMaterialInterface * Material, USceneComponent * AttachParent, const FTransform & StartTransform);
+
+	// Draws the segment between the last point and this one, only the newest segment and the end tangent of the one before it are updated
+	// Once the ring is full the oldest segment is re-used
+	void AddPoint(const FVector & Point, bool bCurved);
 
-	// Hides all spline meshes and re-inits the spline component
+	// Hides all spline meshes and restarts the ring
 	void Reset()
 	{
-		if(SplineComponent != nullptr)
-			SplineComponent->ClearSplinePoints(true);
-
 		for (int i = SplineMeshes.Num() - 1; i >= 0; --i)
 		{
 			if (SplineMeshes[i] != nullptr)
@@ -312,8 +959,9 @@ public:
 				SplineMeshes.RemoveAt(i);
 		}
 
-		LastIndexSet = 0;
-		NextIndexCleared = 0;
+		NextSegment = 0;
+		ActiveSegments = 0;
+		PointCount = 0;
 	}
 
 	void Clear()
@@ -328,21 +976,16 @@ public:
 		}
 		SplineMeshes.Empty();
 
-		if (SplineComponent != nullptr)
-		{
-			SplineComponent->DestroyComponent();
-			SplineComponent = nullptr;
-		}
-
-		LastIndexSet = 0;
-		NextIndexCleared = 0;
+		NextSegment = 0;
+		ActiveSegments = 0;
+		PointCount = 0;
 	}
 
 	FVRGestureSplineDraw()
 	{
-		SplineComponent = nullptr;
-		NextIndexCleared = 0;
-		LastIndexSet = 0;
+		NextSegment = 0;
+		ActiveSegments = 0;
+		PointCount = 0;
 	}
 
 	~FVRGestureSplineDraw()
@@ -351,9 +994,233 @@ public:
 	}
 };
 
+USTRUCT(BlueprintType, Category = "VRGestures")
+struct VREXPANSIONPLUGIN_API FVRGestureLineDraw
+{
+	GENERATED_BODY()
+public:
+
+	// Line batch owned by the gesture component, only holds the segments of the current recording so changing them doesn't
+	// rebuild the worlds shared debug line batches
+	UPROPERTY()
+	ULineBatchComponent * LineBatch;
+
+	// Transform from sample space to world space
+	FTransform DrawTransform;
+
+	// Ring slot in the batched lines that the next segment is drawn into
+	int NextSegment;
+	int MaxSegments;
+
+	FVector LastPoint;
+	bool bHasPoint;
+
+	// Creates the line batch if needed and sizes it for a recording, does nothing on dedicated servers or without debug drawing
+	void Init(USceneComponent * Owner, int SegmentCount, const FTransform & InDrawTransform);
+
+	// Adds the segment from the last point to this one, once the ring is full the oldest segment is replaced
+	void AddPoint(const FVector & Point);
+
+	// Removes all segments and restarts the ring
+	void Reset()
+	{
+		if (LineBatch != nullptr && LineBatch->BatchedLines.Num() > 0)
+			LineBatch->Flush();
+
+		NextSegment = 0;
+		bHasPoint = false;
+	}
+
+	void Clear()
+	{
+		if (LineBatch != nullptr && !LineBatch->IsBeingDestroyed())
+			LineBatch->DestroyComponent();
+
+		LineBatch = nullptr;
+		NextSegment = 0;
+		bHasPoint = false;
+	}
+
+	FVRGestureLineDraw() :
+		LineBatch(nullptr),
+		NextSegment(0),
+		MaxSegments(0),
+		LastPoint(FVector::ZeroVector),
+		bHasPoint(false)
+	{}
+};
+
+// A database gesture that passed the lower bounds and still needs a full dtw()
+struct FVRGestureCandidate
+{
+	float LowerBound;
+	int GestureIndex;
+	float Scaler;
+	bool bMirrorGesture;
+
+	FVRGestureCandidate(float InLowerBound, int InGestureIndex, float InScaler, bool bInMirrorGesture) :
+		LowerBound(InLowerBound),
+		GestureIndex(InGestureIndex),
+		Scaler(InScaler),
+		bMirrorGesture(bInMirrorGesture)
+	{}
+
+	bool operator<(const FVRGestureCandidate & Other) const
+	{
+		return LowerBound < Other.LowerBound || (LowerBound == Other.LowerBound && GestureIndex < Other.GestureIndex);
+	}
+};
+
+// Scratch lookup tables for the full table dtw(), sized once and re-used between recognitions so detection doesn't hit the allocator
+class VREXPANSIONPLUGIN_API FVRGestureDTWWorkspace
+{
+public:
+
+	TArray<float> LookupTable;
+	TArray<int> SlopeI;
+	TArray<int> SlopeJ;
+
+	// Previous and current row of cost, SlopeI and SlopeJ for the vectorized kernel, one register wide per column
+	TArray<float> BatchRows;
+
+	// Gestures that passed the lower bounds, sorted by bound so the most likely matches run first
+	TArray<FVRGestureCandidate> Candidates;
+
+	// Makes sure that a table of RowCount * ColumnCount fits without re-allocating
+	void Reserve(int RowCount, int ColumnCount)
+	{
+		const int CellCount = RowCount * ColumnCount;
+		if (CellCount > LookupTable.Max())
+		{
+			LookupTable.Reserve(CellCount);
+			SlopeI.Reserve(CellCount);
+			SlopeJ.Reserve(CellCount);
+		}
+
+		BatchRows.Reserve(GetBatchRowsSize(ColumnCount));
+	}
+
+	void ReserveCandidates(int GestureCount)
+	{
+		Candidates.Reserve(GestureCount * 2);
+	}
+
+	static int GetBatchRowsSize(int ColumnCount)
+	{
+		return 6 * ColumnCount * VRGESTURE_SIMD_LANES;
+	}
+
+	// Sets the batch row size, returns true if it had to allocate
+	bool SetBatchRowSize(int ColumnCount)
+	{
+		const int RowsSize = GetBatchRowsSize(ColumnCount);
+		const bool bAllocated = RowsSize > BatchRows.Max();
+
+		BatchRows.SetNumUninitialized(RowsSize, false);
+
+		return bAllocated;
+	}
+
+	// Sets the table size, only allocates if the table is larger than anything seen before
+	// Returns true if it had to allocate
+	bool SetTableSize(int RowCount, int ColumnCount)
+	{
+		const int CellCount = RowCount * ColumnCount;
+		const bool bAllocated = CellCount > LookupTable.Max();
+
+		LookupTable.SetNumUninitialized(CellCount, false);
+		SlopeI.SetNumUninitialized(CellCount, false);
+		SlopeJ.SetNumUninitialized(CellCount, false);
+
+		return bAllocated;
+	}
+};
+
+// Running DTW state for a single database gesture, used by the streaming detection mode.
+// Only the newest row of the lookup table is kept, the table is walked in sample order (oldest to newest) with a free
+// starting column so that the gesture can begin on any sample, adding a new sample only costs O(M) instead of rebuilding the full table.
+// Uses the same step choice, slope limits and window as dtw(), but the costs are not identical to it: dtw() walks newest to oldest so the
+// greedy steps resolve differently, and each sample is scaled with the bounds at the time it was captured instead of the current ones.
+// The benchmark commandlet's -CompareStreaming mode reports how far apart the two are on a corpus.
+class VREXPANSIONPLUGIN_API FVRGestureStreamingState
+{
+public:
+
+	FVRGestureStreamingState() :
+		GestureIndex(INDEX_NONE),
+		bMirrorGesture(false),
+		LastMatchCost(MAX_FLT),
+		LastMatchStart(0),
+		PrefixLength(0)
+	{}
+
+	// Index of the gesture in the database that this state is tracking
+	int GestureIndex;
+
+	// If true the state is matched against the mirrored copy of the database gesture
+	bool bMirrorGesture;
+
+	// Cost of matching the full gesture ending on the last added sample
+	float LastMatchCost;
+
+	// Sample index that the warping path of the last match started on
+	int LastMatchStart;
+
+	// Lookup table row, one entry per gesture sample plus the free starting column at index 0
+	TArray<float> LookupRow;
+	TArray<int> SlopeI;
+	TArray<int> SlopeJ;
+
+	// Input sample index that the warping path of each cell started on
+	TArray<int> PathStart;
+
+	// Longest prefix of the gesture (in samples) that the last added sample ends a match of within the prefix threshold
+	int PrefixLength;
+
+	void Init(int InGestureIndex, int GestureLength, bool bInMirrorGesture)
+	{
+		GestureIndex = InGestureIndex;
+		bMirrorGesture = bInMirrorGesture;
+
+		LookupRow.SetNumUninitialized(GestureLength + 1);
+		SlopeI.SetNumUninitialized(GestureLength + 1);
+		SlopeJ.SetNumUninitialized(GestureLength + 1);
+		PathStart.SetNumUninitialized(GestureLength + 1);
+		Reset();
+	}
+
+	// Clears the running row back to the state before any samples were added
+	void Reset()
+	{
+		for (int j = 0; j < LookupRow.Num(); ++j)
+		{
+			LookupRow[j] = MAX_FLT;
+			SlopeI[j] = 0;
+			SlopeJ[j] = 0;
+			PathStart[j] = 0;
+		}
+
+		if (LookupRow.Num() > 0)
+			LookupRow[0] = 0.f;
+
+		LastMatchCost = MAX_FLT;
+		LastMatchStart = 0;
+		PrefixLength = 0;
+	}
+
+	// Adds the next row to the table for the given (already scaled) sample
+	// Gesture samples are stored newest first, so they are walked in reverse here
+	// Paths that started more than WindowSize samples ago are dropped, the same samples that dtw() no longer sees
+	// PrefixThreshold is the squared per sample cost that a prefix has to stay under to count towards PrefixLength
+	void AddSample(const FVector & Sample, TArrayView<const FVector> GestureSamples, int SampleIndex, int WindowSize, int MaxSlope, float PrefixThreshold);
+};
+
 /** Delegate for notification when the lever state changes. */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FVRGestureDetectedSignature, uint8, GestureType, FString, DetectedGestureName, int, DetectedGestureIndex, UGesturesDatabase *, GestureDataBase);
 
+/** Delegate for notification when a gesture is partially drawn past the progress threshold. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FVRGestureProgressSignature, uint8, GestureType, FString, GestureName, int, GestureIndex, float, Progress, UGesturesDatabase *, GestureDataBase);
+
 /**
 * A scene component that can sample its positions to record / track VR gestures
 * Core code is from https://social.msdn.microsoft.com/Forums/en-US/4a428391-82df-445a-a867-557f284bd4b1/dynamic-time-warping-to-recognize-gestures?forum=kinectsdk
@@ -382,6 +1249,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "VRGestures")
 		FVRGestureDetectedSignature OnGestureDetected_Bind;
 
+	// Called when a gestures progress rises past GestureProgressThreshold, fires again only after the progress drops back under it
+	UPROPERTY(BlueprintAssignable, Category = "VRGestures")
+		FVRGestureProgressSignature OnGestureProgress_Bind;
+
 	// Known sequences
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 	UGesturesDatabase *GesturesDB;
@@ -400,6 +1271,9 @@ public:
 
 	FVRGestureSplineDraw RecordingGestureDraw;
 
+	// Debug line trail used when drawing the recording without splines
+	FVRGestureLineDraw RecordingLineDraw;
+
 	// Should we draw splines curved or straight
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 		bool bDrawSplinesCurved;
@@ -438,10 +1312,94 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "VRGestures")
 	EVRGestureState CurrentState;
 
-	// Currently recording gesture
+	// Last recorded gesture, filled in from the sample window when recording ends (or with GetCurrentGestureLog while recording)
 	UPROPERTY(BlueprintReadOnly, Category = "VRGestures")
 	FVRGesture GestureLog;
 
+	// Window of the newest samples while recording, newest first, detection reads it through a view
+	FVRGestureSampleWindow SampleWindow;
+
+	// Copies the samples that are currently being recorded into GestureLog and returns it
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+	FVRGesture GetCurrentGestureLog()
+	{
+		SampleWindow.CopyTo(GestureLog);
+		return GestureLog;
+	}
+
+	// If true detection keeps a running DTW row per database gesture and only adds the newest sample to it when one is captured,
+	// instead of rebuilding the full lookup table against the whole sample buffer every tick.
+	// Samples are scaled with the gesture size at the time that they were captured and the table is walked in the other direction,
+	// so results can differ slightly from the full table, see FVRGestureStreamingState.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseStreamingDetection;
+
+	// Running DTW states for the streaming detection, one per gesture (two for gestures that check both mirrored and normal)
+	TArray<FVRGestureStreamingState> StreamingStates;
+
+	// Database and gesture count that the streaming states were built for
+	UGesturesDatabase * StreamingStatesDB;
+	int StreamingStatesGestureCount;
+
+	// Number of samples added to the streaming states since the last reset
+	int StreamingSampleCount;
+
+	// Rebuilds the streaming states for the current database
+	void InitStreamingStates();
+
+	// Clears the streaming states without re-allocating them
+	void ResetStreamingStates()
+	{
+		for (FVRGestureStreamingState & State : StreamingStates)
+		{
+			State.Reset();
+		}
+
+		for (float & Progress : GestureProgress)
+		{
+			Progress = 0.f;
+		}
+
+		StreamingSampleCount = 0;
+	}
+
+	// Adds the newest captured sample to every streaming state
+	void UpdateStreamingStates(const FVector & NewSample);
+
+	// Streaming states are kept up to date for streaming detection and for the gesture progress
+	bool ShouldUpdateStreamingStates() const
+	{
+		return bUseStreamingDetection || bTrackGestureProgress;
+	}
+
+	// If true the fraction of each database gesture that the newest samples match is tracked while detecting, read from the streaming DTW rows
+	// (which are kept for this even when not using streaming detection). Lets effects start before the gesture is finished.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Progress")
+		bool bTrackGestureProgress;
+
+	// Progress (0 - 1) that a gesture has to reach before OnGestureProgress_Bind is called for it
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Progress", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+		float GestureProgressThreshold;
+
+	// Completion estimate (0 - 1) of each database gesture, same indices as the database, only filled in while tracking progress
+	UPROPERTY(BlueprintReadOnly, Category = "VRGestures|Progress")
+		TArray<float> GestureProgress;
+
+	// Reads the progress of every gesture out of the streaming states and fires the progress events
+	void UpdateGestureProgress();
+
+	// Scale from input bounds to the database, 1 while the input has no extent yet (a single sample right after a reset)
+	static inline float GetDatabaseScaler(const UGesturesDatabase * Database, const FBox & InputBounds)
+	{
+		const float MaxSize = InputBounds.GetSize().GetMax();
+		return MaxSize > 0.0f ? Database->TargetGestureScale / MaxSize : 1.0f;
+	}
+
+	inline float GetDatabaseScaler(const FBox & InputBounds) const
+	{
+		return GetDatabaseScaler(GesturesDB, InputBounds);
+	}
+
 	inline float GetGestureDistance(FVector Seq1, FVector Seq2, bool bMirrorGesture = false)
 	{
 		if (bMirrorGesture)
@@ -454,8 +1412,16 @@ public:
 
 	void BeginDestroy() override
 	{
+		// The recognition task reads from this component, it has to finish before we go away
+		WaitForAsyncRecognition();
+		AsyncRecognitionTask = nullptr;
+
 		Super::BeginDestroy();
+
 		RecordingGestureDraw.Clear();
+		RecordingLineDraw.Clear();
+		UnregisterFromGestureManager();
+
 		if (TickGestureTimer_Handle.IsValid())
 		{
 			GetWorld()->GetTimerManager().ClearTimer(TickGestureTimer_Handle);
@@ -474,7 +1440,10 @@ public:
 
 	// Draw a gesture with a debug line batch
 	UFUNCTION(BlueprintCallable, Category = "VRGestures", meta = (WorldContext = "WorldContextObject"))
-		void DrawDebugGesture(UObject* WorldContextObject, UPARAM(ref)FTransform& StartTransform, FVRGesture GestureToDraw, FColor const& Color, bool bPersistentLines = false, uint8 DepthPriority = 0, float LifeTime = -1.f, float Thickness = 0.f);
+		void DrawDebugGesture(UObject* WorldContextObject, UPARAM(ref)FTransform& StartTransform, const FVRGesture & GestureToDraw, FColor const& Color, bool bPersistentLines = false, uint8 DepthPriority = 0, float LifeTime = -1.f, float Thickness = 0.f);
+
+	// Draws samples (newest first) with a debug line batch, used by DrawDebugGesture
+	void DrawDebugGestureSamples(UObject* WorldContextObject, const FTransform &StartTransform, TArrayView<const FVector> Samples, EVRGestureMirrorMode MirrorMode, FColor const& Color, bool bPersistentLines = false, uint8 DepthPriority = 0, float LifeTime = -1.f, float Thickness = 0.f);
 
 	FVector StartVector;
 	FTransform OriginatingTransform;
@@ -502,12 +1471,20 @@ public:
 			GetWorld()->GetTimerManager().ClearTimer(TickGestureTimer_Handle);
 		}
 
+		UnregisterFromGestureManager();
+
 		this->SetComponentTickEnabled(false);
 		CurrentState = EVRGestureState::GES_None;
 
+		// Throw out any recognition still in flight, it has to be done reading the database before the caller saves to it
+		WaitForAsyncRecognition();
+		RecognitionSequence++;
+
 		// Reset the recording gesture
 		RecordingGestureDraw.Reset();
+		RecordingLineDraw.Reset();
 
+		SampleWindow.CopyTo(GestureLog);
 		return GestureLog;
 	}
 
@@ -515,7 +1492,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VRGestures")
 	void ClearRecording()
 	{
-		GestureLog.Samples.Reset(RecordingBufferSize);
+		WaitForAsyncRecognition();
+		SampleWindow.Reset();
+		GestureLog.Samples.Reset();
+		ResetStreamingStates();
+		RecordingLineDraw.Reset();
+
+		// Results from before the clear are stale now
+		RecognitionSequence++;
 	}
 
 	// Saves a VRGesture to the database, if Scale To Database is true then it will scale the data
@@ -525,25 +1509,180 @@ public:
 		if (GesturesDB)
 		{
 			Recording.CalculateSizeOfGesture(bScaleRecordingToDatabase, GesturesDB->TargetGestureScale);
+			GesturesDB->ProcessGestureSamples(Recording);
 			Recording.Name = RecordingName;
+			GesturesDB->PrepareToModifyGestures();
 			GesturesDB->Gestures.Add(Recording);
+			GesturesDB->MarkGesturesDirty();
 		}
 	}
 
 	void CaptureGestureFrame();
 
+	// Adds a sample (relative to the start of the recording) to the gesture log, CaptureGestureFrame calls this with the components location
+	void AddGestureSample(const FVector & NewSample);
+
+	// Clears the gesture log and sets up the detection state for a new recording, does not start the capture timer
+	void ResetRecordingState(bool bRunDetection);
+
+	// Runs the configured detection against the current gesture log, called after each captured frame while detecting
+	void RunGestureDetection();
+
+	// Live samples after the database resampling / simplification, re-used between ticks
+	FVRGesture ProcessedGestureLog;
+	FVRGestureSampleProcessor SampleProcessor;
+
+	// Fills OutGesture with the gesture log, resampled and simplified if the database asks for it
+	void GetDetectionSamples(FVRGesture & OutGesture);
+
 	// Ticks the logic from the gameplay timer.
 	void TickGesture();
 
+	// If true recording is driven by the worlds UVRGestureManager instead of a timer on this component. The manager captures every registered
+	// component at its own rate and scores components that share a database together, SamplingHTZ is ignored in this mode.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseGestureManager;
+
+	// Manager that this component is registered with while recording
+	TWeakObjectPtr<class UVRGestureManager> RegisteredManager;
+
+	void UnregisterFromGestureManager();
+
+	// Checks if the newest samples are within a database gestures first threshold, picking the scaler and mirroring for it
+	bool CheckFirstThreshold(const UGesturesDatabase * Database, const FVRGestureView & inputGesture, int GestureIndex, float Scaler, float & OutScaler, bool & bOutMirrorGesture, float & OutFirstDistance);
+
+	// Batched recognition driven by the gesture manager, the manager walks each database gesture once for every component that shares the database.
+	// Begin returns false if there is nothing new to recognize, results are the same as the scalar FindBestGesture
+	// The caller updates the database gesture cache before Begin, every component in the batch reads from it
+	bool BeginBatchedRecognition();
+	void ScoreBatchedGesture(int GestureIndex);
+	void EndBatchedRecognition();
+
+	// Input and best match of the batched recognition in progress
+	FVRGestureView BatchedInput;
+	float BatchedScaler;
+	float BatchedMinDist;
+	int BatchedGestureIndex;
+
+
+	// If true detection scores four database gestures at a time with the vectorized DTW kernel, results are identical to the scalar dtw()
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseVectorizedDTW;
+
+	// If true cheap lower bounds of the DTW cost (end points, then the gesture against the input bounds) are checked first
+	// and the full dtw() is only ran for gestures that could still beat the best match and their FullThreshold, results are unchanged
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseLowerBoundPruning;
+
+	// Returns false if the DTW cost of the gesture is guaranteed to be over CostLimit (un-normalized), OutBound receives the tightest bound found
+	// InputBounds must contain every (scaled) input sample, FirstDistance is the distance between the newest samples that the first threshold checks
+	// GestureSamples are already mirrored if they need to be, bMirrorGesture only picks the envelope
+	bool PassesLowerBounds(const FBox & InputBounds, const FVRGestureEnvelope & Envelope, TArrayView<const FVector> GestureSamples, bool bMirrorGesture, float FirstDistance, float CostLimit, float & OutBound);
+
+	// If true the sample window is snapshotted and recognition runs on a background task, the detection events are fired on the game thread
+	// when the result lands (generally the next frame). Only one recognition is in flight at a time, samples captured during it are picked up by the next one.
+	// Database changes made through its functions wait on the task first, don't edit the gestures array directly while detecting in this mode.
+	// Not used by streaming detection.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseAsyncDetection;
+
+	// Incremented whenever the recording is cleared, results from an older sequence are discarded
+	int RecognitionSequence;
+
+	// Snapshot of the gesture log that the in flight recognition is reading from
+	FVRGesture AsyncRecognitionSnapshot;
+
+	// Currently running recognition task
+	FGraphEventRef AsyncRecognitionTask;
+
+	bool bAsyncRecognitionInFlight;
+	bool bAsyncRecognitionPending;
+
+	// Snapshots the gesture log and starts a background recognition if one isn't already running
+	void DispatchAsyncRecognition();
+
+	// Blocks until the background recognition is done with the DTW workspace and database, its result is still discarded by sequence
+	void WaitForAsyncRecognition()
+	{
+		UGesturesDatabase::WaitForAsyncReader(AsyncRecognitionTask);
+	}
+
+	// Game thread side of the background recognition, TaskDB is the database the task ran against (null if it was destroyed since)
+	void OnAsyncRecognitionComplete(int Sequence, UGesturesDatabase * TaskDB, int GestureIndex);
 
 	// Recognize gesture in the given sequence.
 	// It will always assume that the gesture ends on the last observation of that sequence.
 	// If the distance between the last observations of each sequence is too great, or if the overall DTW distance between the two sequences is too great, no gesture will be recognized.
-	void RecognizeGesture(FVRGesture inputGesture);
+	void RecognizeGesture(const FVRGestureView & inputGesture);
+
+	// Finds the best matching database gesture with the scalar dtw(), this is the reference implementation
+	// Returns the gesture index or INDEX_NONE. Database is passed in rather than read from GesturesDB so that async recognition
+	// keeps using the database it was started with
+	int FindBestGesture(UGesturesDatabase * Database, const FVRGestureView & inputGesture, float & OutDistance);
+
+	// Finds the best matching database gesture with the vectorized DTW kernel
+	int FindBestGestureVectorized(UGesturesDatabase * Database, const FVRGestureView & inputGesture, float & OutDistance);
+
+	// Fires the detection events for a gesture and clears the recording
+	void BroadcastGestureDetected(int GestureIndex);
+
+	// Recognize gesture from the streaming states, same thresholds as RecognizeGesture but the DTW cost was already computed
+	// when the newest sample was captured.
+	void RecognizeGestureStreaming();
 
 
 	// Compute the min DTW distance between seq2 and all possible endings of seq1.
-	float dtw(FVRGesture seq1, FVRGesture seq2, bool bMirrorGesture = false, float Scaler = 1.f);
+	// seq2 is already mirrored if it needs to be, see UGesturesDatabase::GetGestureSamples
+	float dtw(const FVRGestureView & seq1, TArrayView<const FVector> seq2, float Scaler = 1.f);
+
+	// Same as dtw() but only evaluates the cells inside of the warping window from Settings, keeping two rows instead of the full table
+	float dtwWindowed(const FVRGestureView & seq1, TArrayView<const FVector> seq2, const FVRGestureSettings & Settings, float Scaler = 1.f);
+
+	// Same as dtw() on fixed point samples, DistanceScale converts the squared quantized distances back to database units
+	float dtwQuantized(TArrayView<const FVRGestureQuantizedSample> seq1, TArrayView<const FVRGestureQuantizedSample> seq2, float DistanceScale);
+
+	// Runs dtw(), dtwQuantized() or dtwWindowed() against a database gesture depending on its settings
+	// Call UpdateGestureCache on the database and QuantizeInput with the scaler of this input first
+	float GetGestureCost(const UGesturesDatabase * Database, const FVRGestureView & seq1, int GestureIndex, bool bMirrorGesture, float Scaler)
+	{
+		const FVRGestureSettings & Settings = Database->Gestures[GestureIndex].GestureSettings;
+
+		if (Settings.WarpingWindow != EVRGestureWarpingWindow::GES_NoWindow)
+			return dtwWindowed(seq1, Database->GetGestureSamples(GestureIndex, bMirrorGesture), Settings, Scaler);
+
+		// Only scaling gestures are quantized, so the input was quantized with the same scaler
+		if (bQuantizedInputValid && Database->HasQuantizedSamples(GestureIndex))
+			return dtwQuantized(QuantizedInput, Database->GetQuantizedGestureSamples(GestureIndex, bMirrorGesture), Database->GetQuantizedDistanceScale());
+
+		return dtw(seq1, Database->GetGestureSamples(GestureIndex, bMirrorGesture), Scaler);
+	}
+
+	// Fixed point copy of the input being recognized, scaled to the database
+	TArray<FVRGestureQuantizedSample> QuantizedInput;
+	bool bQuantizedInputValid;
+
+	// Quantizes the input for the scaling gestures if the database uses quantized samples
+	void QuantizeInput(const UGesturesDatabase * Database, const FVRGestureView & seq1, float Scaler);
+
+	// Prefilter features of the input being recognized
+	FVRGestureInputFeatures PrefilterInput;
+	bool bPrefilterInputValid;
+
+	// Builds the quantized input and prefilter features, call before scoring an input
+	void PrepareRecognitionInput(const UGesturesDatabase * Database, const FVRGestureView & seq1, float Scaler);
+
+	// Runs the database prefilter on a gesture that passed the first threshold, true if there is no prefilter
+	bool PassesPrefilter(const UGesturesDatabase * Database, const FVRGestureView & seq1, int GestureIndex, bool bMirrorGesture, float Scaler);
+
+	// Computes dtw() for every lane of a gesture batch at once, OutBestMatch receives the un-normalized result for each lane
+	// Scalers and YSigns are per lane, a YSign of -1 mirrors that lanes gesture
+	void dtwBatch(const FVRGestureView & seq1, const FVRGestureSIMDBatch & Batch, const float * PackedData, const float * Scalers, const float * YSigns, float * OutBestMatch);
+
+	// Scratch tables for dtw(), re-used between calls so that detection doesn't allocate
+	FVRGestureDTWWorkspace DTWWorkspace;
+
+	// Sizes the DTW workspace for the current buffer size and the longest gesture in the database
+	void SizeDTWWorkspace();
 
 };
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Tickable.h"
+#include "VRGestureManager.generated.h"
+
+class UVRGestureComponent;
+class UGesturesDatabase;
+
+/**
+*	Per world driver for gesture components that have bUseGestureManager set.
+*
+*	Instead of a looping timer per component, every registered component is captured from a single fixed rate accumulator
+*	and scalar recognition is run once per frame. Components that share a database are scored together, each database
+*	gesture is walked once for all of them, so the gesture data stays in cache across components.
+*
+*	Recognition can be given a per frame time budget, components that don't fit keep their new samples and are picked up
+*	first on the next frame. Streaming, async and vectorized components run their own detection right after each capture.
+*
+*	There is one manager per world, it is created on first use and kept alive until the world is cleaned up.
+*/
+UCLASS(BlueprintType, Category = "VRGestures")
+class VREXPANSIONPLUGIN_API UVRGestureManager : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVRGestureManager(const FObjectInitializer& ObjectInitializer);
+
+	// Returns the manager for a world, creating it if requested and it doesn't exist yet
+	static UVRGestureManager * Get(UWorld * World, bool bCreateIfMissing = true);
+
+	// Returns the gesture manager of the world that the context object is in
+	UFUNCTION(BlueprintCallable, Category = "VRGestures", meta = (WorldContext = "WorldContextObject"))
+	static UVRGestureManager * GetGestureManager(UObject * WorldContextObject);
+
+	// Rate in HTZ that registered components are captured at
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		int UpdateRate;
+
+	// Max milliseconds per frame to spend on batched recognition, 0 is unlimited
+	// At least one database group is always scored each frame so that detection can't be starved
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		float FrameBudgetMS;
+
+	// Max capture steps to run in a single frame when catching up after a hitch, older steps are dropped
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		int MaxStepsPerFrame;
+
+	// Seconds between capture steps
+	float GetUpdateInterval() const
+	{
+		return 1.0f / FMath::Max(UpdateRate, 1);
+	}
+
+	void RegisterGestureComponent(UVRGestureComponent * Component);
+	void UnregisterGestureComponent(UVRGestureComponent * Component);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld * GetTickableGameObjectWorld() const override;
+	// End FTickableGameObject
+
+private:
+
+	// Captures every registered component once
+	void StepComponents();
+
+	// Scores the scalar components that have new samples, grouped by database and within the frame budget
+	void RunBatchedRecognition();
+
+	// Scores every component in a group against their shared database
+	void RecognizeGroup(UGesturesDatabase * GesturesDB, TArrayView<UVRGestureComponent * const> Group);
+
+	TArray<TWeakObjectPtr<UVRGestureComponent>> Components;
+
+	// Scalar components waiting on recognition, sorted by database each frame, kept around to avoid reallocating
+	TArray<UVRGestureComponent *> PendingComponents;
+
+	// Group to start from next frame, rotated so that a tight budget doesn't always skip the same databases
+	int NextGroupIndex;
+
+	float TimeAccumulator;
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "VRGesturePrefilter.generated.h"
+
+struct FVRGestureView;
+class UGesturesDatabase;
+
+// Number of direction bins in the drawing plane (Y/Z) used by the shape descriptors
+#define VRGESTURE_DIRECTION_BINS 8
+
+// Per recognition data of the input built once by the prefilter, owned by the component doing the recognition so that
+// components sharing a database (and its prefilter) can run at the same time.
+// Everything is stored as running totals over the newest first samples so the descriptors of any newest part of the input
+// can be read in constant time.
+struct VREXPANSIONPLUGIN_API FVRGestureInputFeatures
+{
+	// Path length from the newest sample to each sample
+	TArray<float> PathLength;
+
+	// Length weighted direction histogram from the newest sample to each sample, VRGESTURE_DIRECTION_BINS entries per sample
+	TArray<float> DirectionHistogram;
+
+	// Bounds of the newest samples up to each sample
+	TArray<FBox> Bounds;
+
+	// Gestures the prefilter index picked for this input in ascending index order, and the same set as a mask over the gesture indices.
+	// Only valid if bHasCandidates, otherwise every gesture has to be tested.
+	TArray<int32> Candidates;
+	TBitArray<> CandidateMask;
+	bool bHasCandidates;
+
+	FVRGestureInputFeatures() :
+		bHasCandidates(false)
+	{}
+
+	void Reset()
+	{
+		PathLength.Reset();
+		DirectionHistogram.Reset();
+		Bounds.Reset();
+		Candidates.Reset();
+		bHasCandidates = false;
+	}
+
+	// Returns true if the gesture can pass the prefilter, false if the index already ruled it out
+	bool IsCandidate(int GestureIndex) const
+	{
+		return !bHasCandidates || CandidateMask[GestureIndex];
+	}
+
+	// Allocated size of the arrays, for counting workspace growth
+	int32 GetCapacity() const
+	{
+		return PathLength.Max() + DirectionHistogram.Max() + Bounds.Max() + Candidates.Max() + CandidateMask.GetAllocatedSize();
+	}
+
+	int32 Num() const
+	{
+		return PathLength.Num();
+	}
+};
+
+/**
+*	Cheap filter that runs ahead of the DTW and rejects database gestures that can't match the input.
+*	Instanced on a gestures database, every component using the database runs it after the first threshold check.
+*
+*	Prefilters are native only, recognition can run on a background task. Anything cached per gesture has to be built in
+*	BuildGestureFeatures and only read after that.
+*/
+UCLASS(NotBlueprintable, BlueprintType, EditInlineNew, DefaultToInstanced, Abstract, ClassGroup = (VRExpansionPlugin))
+class VREXPANSIONPLUGIN_API UVRGesturePrefilter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Called on the game thread when the database gestures change, read the samples through UGesturesDatabase::GetGestureSamples
+	virtual void BuildGestureFeatures(const UGesturesDatabase & Database) {}
+
+	// Called once per recognition before any gesture is tested
+	virtual void BuildInputFeatures(const FVRGestureView & Input, FVRGestureInputFeatures & OutFeatures) const {}
+
+	// Optional index lookup, called once per recognition after BuildInputFeatures. Returns false if there is no index for this input,
+	// otherwise fills OutCandidates (ascending) with every gesture that could pass PassesPrefilter without looking at the others.
+	// Scaler is the scale from the input to the database, gestures that don't scale use 1.
+	virtual bool SelectCandidates(const FVRGestureInputFeatures & InputFeatures, float Scaler, TArray<int32> & OutCandidates) const
+	{
+		return false;
+	}
+
+	// Runs the index lookup into the input features, the gestures it skipped are counted as tested and rejected
+	void GatherCandidates(FVRGestureInputFeatures & InputFeatures, float Scaler, int32 GestureCount) const
+	{
+		InputFeatures.bHasCandidates = SelectCandidates(InputFeatures, Scaler, InputFeatures.Candidates);
+
+		if (!InputFeatures.bHasCandidates)
+			return;
+
+		InputFeatures.CandidateMask.Init(false, GestureCount);
+		for (int32 GestureIndex : InputFeatures.Candidates)
+		{
+			InputFeatures.CandidateMask[GestureIndex] = true;
+		}
+
+		const int32 Skipped = GestureCount - InputFeatures.Candidates.Num();
+		TestedCount.Add(Skipped);
+		RejectedCount.Add(Skipped);
+	}
+
+	// Returns false if the gesture can't match the input and should be skipped, Scaler is the scale applied to the input for this gesture
+	virtual bool PassesPrefilter(const FVRGestureView & Input, const FVRGestureInputFeatures & InputFeatures, float Scaler, int GestureIndex, bool bMirrorGesture) const
+	{
+		return true;
+	}
+
+	// Tests the gesture and counts the result
+	bool TestGesture(const FVRGestureView & Input, const FVRGestureInputFeatures & InputFeatures, float Scaler, int GestureIndex, bool bMirrorGesture) const
+	{
+		TestedCount.Increment();
+
+		if (PassesPrefilter(Input, InputFeatures, Scaler, GestureIndex, bMirrorGesture))
+			return true;
+
+		RejectedCount.Increment();
+		return false;
+	}
+
+	// Fraction of the tested gestures that were rejected since the last ResetStats
+	UFUNCTION(BlueprintCallable, Category = "VRGestures|Prefilter")
+	float GetRejectionRate() const
+	{
+		const int32 Tested = TestedCount.GetValue();
+		return Tested > 0 ? (float)RejectedCount.GetValue() / Tested : 0.f;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "VRGestures|Prefilter")
+	void ResetStats()
+	{
+		TestedCount.Reset();
+		RejectedCount.Reset();
+	}
+
+private:
+
+	// Can be counted from several recognition tasks at once
+	mutable FThreadSafeCounter TestedCount;
+	mutable FThreadSafeCounter RejectedCount;
+};
+
+// Shape descriptors of a database gesture, see UVRGestureShapePrefilter
+struct VREXPANSIONPLUGIN_API FVRGestureShapeFeatures
+{
+	int32 SampleCount;
+	float PathLength;
+	float AspectRatio;
+
+	// Normalized vector from the oldest to the newest sample, zero if the gesture ends close to where it started
+	FVector StartToEnd;
+
+	// Length weighted direction histogram, normalized to sum to 1, and its Y mirrored counterpart
+	float DirectionHistogram[VRGESTURE_DIRECTION_BINS];
+	float MirroredDirectionHistogram[VRGESTURE_DIRECTION_BINS];
+
+	FVRGestureShapeFeatures() :
+		SampleCount(0),
+		PathLength(0.f),
+		AspectRatio(1.f),
+		StartToEnd(FVector::ZeroVector)
+	{
+		for (int i = 0; i < VRGESTURE_DIRECTION_BINS; ++i)
+		{
+			DirectionHistogram[i] = 0.f;
+			MirroredDirectionHistogram[i] = 0.f;
+		}
+	}
+};
+
+/**
+*	Prefilter on a few shape descriptors: path length, bounding box aspect ratio, start to end direction and a direction histogram.
+*	The input descriptors are taken from as many of the newest input samples as the gesture has, the part that the DTW would
+*	mostly line up with it. This is an approximation since the DTW can warp, so the tolerances should stay loose.
+*	Setting one of the Max tolerances to 0 disables that descriptor, MinStartToEndDot is disabled at -1 instead (0 is active).
+*/
+UCLASS(BlueprintType, EditInlineNew, DefaultToInstanced, ClassGroup = (VRExpansionPlugin))
+class VREXPANSIONPLUGIN_API UVRGestureShapePrefilter : public UVRGesturePrefilter
+{
+	GENERATED_BODY()
+
+public:
+
+	UVRGestureShapePrefilter(const FObjectInitializer& ObjectInitializer);
+
+	// Max ratio between the (scaled) input and gesture path lengths, either way around
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Prefilter")
+		float MaxPathLengthRatio;
+
+	// Max ratio between the input and gesture Y / Z aspect ratios, either way around
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Prefilter")
+		float MaxAspectRatioDifference;
+
+	// Max distance between the direction histograms (L1, 0 - 2)
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Prefilter")
+		float MaxDirectionHistogramDistance;
+
+	// Min dot product between the input and gesture start to end directions, -1 disables it
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures|Prefilter")
+		float MinStartToEndDot;
+
+	virtual void BuildGestureFeatures(const UGesturesDatabase & Database) override;
+	virtual void BuildInputFeatures(const FVRGestureView & Input, FVRGestureInputFeatures & OutFeatures) const override;
+	virtual bool SelectCandidates(const FVRGestureInputFeatures & InputFeatures, float Scaler, TArray<int32> & OutCandidates) const override;
+	virtual bool PassesPrefilter(const FVRGestureView & Input, const FVRGestureInputFeatures & InputFeatures, float Scaler, int GestureIndex, bool bMirrorGesture) const override;
+
+	// Returns the start to end direction of a run of samples, zero if it ends too close to its start to have one
+	static FVector GetStartToEnd(const FVector & Newest, const FVector & Oldest, const FBox & Bounds);
+
+	// Returns the Y / Z aspect ratio of a box
+	static float GetAspectRatio(const FBox & Bounds);
+
+	// Returns the direction bin of a segment in the drawing plane and its length in that plane
+	static int GetDirectionBin(const FVector & Segment, float & OutLength);
+
+private:
+
+	// Same indices as the database gestures
+	TArray<FVRGestureShapeFeatures> GestureFeatures;
+
+	// Gestures with the same sample count and scaling, they compare against the same input path length
+	struct FPathLengthBucket
+	{
+		int32 SampleCount;
+		bool bScales;
+
+		// Range in PathLengthIndex
+		int32 First;
+		int32 Num;
+	};
+
+	// Path length index, gesture indices sorted by path length within each bucket so that the path length test is a binary search
+	// per bucket instead of a test per gesture. Lookups are sublinear as long as the database has fewer distinct sample counts than
+	// gestures, which resampling with a fixed spacing tends to give.
+	TArray<FPathLengthBucket> PathLengthBuckets;
+	TArray<int32> PathLengthIndex;
+
+	// Gestures that always pass the path length test (too short to have one), always candidates
+	TArray<int32> UnindexedGestures;
+};
@@ -3,4 +3,6 @@
 #include "Gauntlet.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogGauntlet);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Gauntlet, "Gauntlet" );
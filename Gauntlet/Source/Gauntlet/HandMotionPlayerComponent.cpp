@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HandMotionPlayerComponent.h"
+#include "Gauntlet.h"
+#include "HandMotionRecorderComponent.h"
+#include "GameFramework/Actor.h"
+#include "Components/PoseableMeshComponent.h"
+#include "GripMotionControllerComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("HandMotion ~ Playback Frame"), STAT_HandMotionPlaybackFrame, STATGROUP_Game);
+
+UHandMotionPlayerComponent::UHandMotionPlayerComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+
+	PlaybackRate = 1.f;
+	bLoop = false;
+	PreviousFrameTime = 0.f;
+	NextFrameTime = 0.f;
+	PlaybackTime = 0.f;
+}
+
+bool UHandMotionPlayerComponent::StartPlayback(FString FileName)
+{
+	StopPlayback();
+
+	const FString Path = UHandMotionRecorderComponent::GetRecordingPath(FileName);
+
+	if (!Reader.Open(Path))
+	{
+		UE_LOG(LogGauntlet, Warning, TEXT("Failed to open hand motion recording %s"), *Path);
+		return false;
+	}
+
+	BindTracks();
+	SetPlaybackTime(0.f);
+	SetComponentTickEnabled(true);
+	return true;
+}
+
+void UHandMotionPlayerComponent::StopPlayback()
+{
+	ReleaseTracks();
+	Reader.Close();
+	SetComponentTickEnabled(false);
+}
+
+void UHandMotionPlayerComponent::BindTracks()
+{
+	ReleaseTracks();
+
+	TArray<USceneComponent*> Components;
+	if (AActor * Owner = GetOwner())
+		Owner->GetComponents(Components);
+
+	const TArray<FHandMotionTrackInfo> & TrackInfos = Reader.GetTracks();
+
+	for (int32 TrackIndex = 0; TrackIndex < TrackInfos.Num(); ++TrackIndex)
+	{
+		const FHandMotionTrackInfo & Info = TrackInfos[TrackIndex];
+
+		// Every recorded bone can be read back, even ones that have no mesh to pose on this actor
+		if (Info.Type == EHandMotionTrackType::Bone)
+			BoneTrackLookup.Add(FHandMotionBoneKey(Info.ComponentName, Info.BoneName), TrackIndex);
+
+		FPlaybackTrack & Track = Tracks[Tracks.AddDefaulted()];
+		Track.TrackIndex = TrackIndex;
+		Track.BoneIndex = INDEX_NONE;
+		Track.bRestoreTracking = false;
+
+		USceneComponent ** Found = Components.FindByPredicate([&Info](const USceneComponent * Component)
+		{
+			return Component && Component->GetFName() == Info.ComponentName;
+		});
+
+		if (!Found)
+			continue;
+
+		USceneComponent * Component = *Found;
+
+		if (Info.Type == EHandMotionTrackType::Bone)
+		{
+			USkinnedMeshComponent * Mesh = Cast<USkinnedMeshComponent>(Component);
+			if (!Mesh)
+				continue;
+
+			Track.BoneIndex = Mesh->GetBoneIndex(Info.BoneName);
+			if (Track.BoneIndex == INDEX_NONE)
+				continue;
+		}
+		else if (UGripMotionControllerComponent * Controller = Cast<UGripMotionControllerComponent>(Component))
+		{
+			// Untracked controllers keep whatever transform they are given but still run their grip logic
+			Track.bRestoreTracking = !Controller->bUseWithoutTracking;
+			Controller->bUseWithoutTracking = true;
+			Controller->AddTickPrerequisiteComponent(this);
+		}
+
+		Track.Component = Component;
+	}
+
+	// The reference skeleton stores parents before their children, ordering on the bone index
+	// poses the parents first whatever order the recording has. Component tracks go first.
+	Tracks.StableSort([](const FPlaybackTrack & A, const FPlaybackTrack & B)
+	{
+		return A.BoneIndex < B.BoneIndex;
+	});
+}
+
+void UHandMotionPlayerComponent::ReleaseTracks()
+{
+	for (const FPlaybackTrack & Track : Tracks)
+	{
+		if (UGripMotionControllerComponent * Controller = Cast<UGripMotionControllerComponent>(Track.Component.Get()))
+		{
+			if (Track.bRestoreTracking)
+				Controller->bUseWithoutTracking = false;
+
+			Controller->RemoveTickPrerequisiteComponent(this);
+		}
+	}
+
+	Tracks.Reset();
+	BoneTrackLookup.Reset();
+}
+
+void UHandMotionPlayerComponent::SetPlaybackTime(float Time)
+{
+	if (!Reader.IsOpen())
+		return;
+
+	PlaybackTime = FMath::Clamp(Time, 0.f, Reader.GetDuration());
+
+	// Decode forward from the closest keyframe
+	Reader.Seek(PlaybackTime);
+
+	if (!Reader.ReadFrame(NextFrameTime, NextFrame))
+		return;
+
+	PreviousFrame = NextFrame;
+	PreviousFrameTime = NextFrameTime;
+
+	AdvanceTo(PlaybackTime);
+	ApplyFrame();
+}
+
+bool UHandMotionPlayerComponent::AdvanceTo(float Time)
+{
+	while (NextFrameTime < Time)
+	{
+		Swap(PreviousFrame, NextFrame);
+		PreviousFrameTime = NextFrameTime;
+
+		if (!Reader.ReadFrame(NextFrameTime, NextFrame))
+		{
+			NextFrame = PreviousFrame;
+			NextFrameTime = PreviousFrameTime;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UHandMotionPlayerComponent::ApplyFrame()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HandMotionPlaybackFrame);
+
+	const TArray<FHandMotionTrackInfo> & TrackInfos = Reader.GetTracks();
+
+	if (NextFrame.Num() != TrackInfos.Num() || PreviousFrame.Num() != TrackInfos.Num())
+		return;
+
+	const float FrameLength = NextFrameTime - PreviousFrameTime;
+	const float Alpha = FrameLength > KINDA_SMALL_NUMBER ? FMath::Clamp((PlaybackTime - PreviousFrameTime) / FrameLength, 0.f, 1.f) : 1.f;
+
+	BlendedFrame.SetNum(TrackInfos.Num(), false);
+
+	for (int32 i = 0; i < TrackInfos.Num(); ++i)
+	{
+		const FQuat Rotation = FQuat::Slerp(PreviousFrame[i].GetRotation(), NextFrame[i].GetRotation(), Alpha);
+		const FVector Location = FMath::Lerp(PreviousFrame[i].GetLocation(), NextFrame[i].GetLocation(), Alpha);
+		BlendedFrame[i] = FTransform(Rotation, Location);
+	}
+
+	for (const FPlaybackTrack & Track : Tracks)
+	{
+		USceneComponent * Component = Track.Component.Get();
+		if (!Component || !TrackInfos.IsValidIndex(Track.TrackIndex))
+			continue;
+
+		const FHandMotionTrackInfo & Info = TrackInfos[Track.TrackIndex];
+		const FTransform & Blended = BlendedFrame[Track.TrackIndex];
+
+		if (Info.Type == EHandMotionTrackType::Component)
+		{
+			Component->SetRelativeLocationAndRotation(Blended.GetLocation(), Blended.GetRotation());
+		}
+		else if (UPoseableMeshComponent * Poseable = Cast<UPoseableMeshComponent>(Component))
+		{
+			// Recorded relative to the parent, the tracks are sorted so the parent is already posed
+			const FName ParentBoneName = Poseable->GetParentBone(Info.BoneName);
+			const FQuat ParentRotation = ParentBoneName != NAME_None ? Poseable->GetBoneRotationByName(ParentBoneName, EBoneSpaces::ComponentSpace).Quaternion() : FQuat::Identity;
+
+			Poseable->SetBoneRotationByName(Info.BoneName, (ParentRotation * Blended.GetRotation()).Rotator(), EBoneSpaces::ComponentSpace);
+		}
+	}
+}
+
+bool UHandMotionPlayerComponent::GetBoneRotation(FName ComponentName, FName BoneName, FRotator & OutRotation) const
+{
+	const int32 * TrackIndex = BoneTrackLookup.Find(FHandMotionBoneKey(ComponentName, BoneName));
+
+	if (!TrackIndex || !BlendedFrame.IsValidIndex(*TrackIndex))
+	{
+		OutRotation = FRotator::ZeroRotator;
+		return false;
+	}
+
+	OutRotation = BlendedFrame[*TrackIndex].Rotator();
+	return true;
+}
+
+void UHandMotionPlayerComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!Reader.IsOpen())
+		return;
+
+	PlaybackTime += DeltaTime * FMath::Max(0.f, PlaybackRate);
+
+	if (AdvanceTo(PlaybackTime))
+	{
+		ApplyFrame();
+		return;
+	}
+
+	const float Duration = Reader.GetDuration();
+
+	if (bLoop && Duration > 0.f)
+	{
+		SetPlaybackTime(FMath::Fmod(PlaybackTime, Duration));
+		return;
+	}
+
+	PlaybackTime = Duration;
+	ApplyFrame();
+	StopPlayback();
+	OnPlaybackFinished.Broadcast();
+}
+
+void UHandMotionPlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopPlayback();
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HandMotionRecording.h"
+
+#include "HandMotionPlayerComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FHandMotionPlaybackFinishedSignature);
+
+/**
+ * Plays a hand motion recording back onto the components of its owner, matched by name.
+ * Motion controllers are switched to untracked while playing so they keep the recorded transforms, finger bones are
+ * applied to poseable meshes directly. Skeletal meshes are posed by their animation blueprint, which overwrites anything
+ * set on the component, so the animation blueprint has to read the recorded bones with GetBoneRotation.
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class GAUNTLET_API UHandMotionPlayerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UHandMotionPlayerComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Playback speed, 1 is real time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	float PlaybackRate;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	bool bLoop;
+
+	UPROPERTY(BlueprintAssignable, Category = "HandMotion")
+	FHandMotionPlaybackFinishedSignature OnPlaybackFinished;
+
+	// Opens a recording and starts playing it, relative file names are looked up in Saved/HandMotion
+	UFUNCTION(BlueprintCallable, Category = "HandMotion")
+	bool StartPlayback(FString FileName);
+
+	UFUNCTION(BlueprintCallable, Category = "HandMotion")
+	void StopPlayback();
+
+	UFUNCTION(BlueprintCallable, Category = "HandMotion")
+	void SetPlaybackTime(float Time);
+
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	bool IsPlaying() const
+	{
+		return Reader.IsOpen();
+	}
+
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	float GetPlaybackTime() const
+	{
+		return PlaybackTime;
+	}
+
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	float GetDuration() const
+	{
+		return Reader.GetDuration();
+	}
+
+	// Parent relative rotation of a recorded bone at the current playback time, ComponentName is the mesh it was recorded from
+	// since both hands usually share their bone names
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	bool GetBoneRotation(FName ComponentName, FName BoneName, FRotator & OutRotation) const;
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	struct FPlaybackTrack
+	{
+		TWeakObjectPtr<USceneComponent> Component;
+
+		// Index of the track in the recording and its frames
+		int32 TrackIndex;
+		int32 BoneIndex;
+		bool bRestoreTracking;
+	};
+
+	void BindTracks();
+	void ReleaseTracks();
+
+	// Reads frames until the playback time is between the previous and next frame, false at the end of the recording
+	bool AdvanceTo(float Time);
+	void ApplyFrame();
+
+	FHandMotionReader Reader;
+
+	// Sorted so that parent bones are applied before their children
+	TArray<FPlaybackTrack> Tracks;
+
+	// Recording track of each bone by component and bone name, for GetBoneRotation
+	typedef TPair<FName, FName> FHandMotionBoneKey;
+	TMap<FHandMotionBoneKey, int32> BoneTrackLookup;
+
+	TArray<FTransform> PreviousFrame;
+	TArray<FTransform> NextFrame;
+	TArray<FTransform> BlendedFrame;
+	float PreviousFrameTime;
+	float NextFrameTime;
+
+	float PlaybackTime;
+};
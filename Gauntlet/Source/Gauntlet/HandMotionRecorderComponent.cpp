@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HandMotionRecorderComponent.h"
+#include "Gauntlet.h"
+#include "GameFramework/Actor.h"
+#include "Camera/CameraComponent.h"
+#include "Misc/Paths.h"
+#include "GripMotionControllerComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("HandMotion ~ Record Frame"), STAT_HandMotionRecordFrame, STATGROUP_Game);
+
+UHandMotionRecorderComponent::UHandMotionRecorderComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// After the controllers and the glove driven animation have updated
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+
+	SampleRate = 90.f;
+	KeyframeInterval = 90;
+	RecordingTime = 0.f;
+	NextSampleTime = 0.f;
+}
+
+FString UHandMotionRecorderComponent::GetRecordingPath(const FString & FileName)
+{
+	FString Path = FPaths::IsRelative(FileName) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("HandMotion"), FileName) : FileName;
+
+	if (FPaths::GetExtension(Path).IsEmpty())
+		Path += TEXT(".hmr");
+
+	return Path;
+}
+
+bool UHandMotionRecorderComponent::StartRecording(FString FileName)
+{
+	StopRecording();
+
+	AActor * Owner = GetOwner();
+	if (!Owner)
+		return false;
+
+	TArray<USceneComponent*> Components = RecordedComponents;
+	if (Components.Num() < 1)
+	{
+		TArray<UGripMotionControllerComponent*> Controllers;
+		Owner->GetComponents(Controllers);
+		Components.Append(Controllers);
+
+		TArray<UCameraComponent*> Cameras;
+		Owner->GetComponents(Cameras);
+		Components.Append(Cameras);
+	}
+
+	TArray<USkinnedMeshComponent*> Meshes = RecordedMeshes;
+	if (Meshes.Num() < 1)
+	{
+		Owner->GetComponents(Meshes);
+	}
+
+	TArray<FHandMotionTrackInfo> TrackInfos;
+	Tracks.Reset();
+
+	for (USceneComponent * Component : Components)
+	{
+		if (!Component)
+			continue;
+
+		FRecordedTrack Track;
+		Track.Component = Component;
+		Track.BoneName = NAME_None;
+		Track.ParentBoneName = NAME_None;
+		Tracks.Add(Track);
+
+		TrackInfos.Add(FHandMotionTrackInfo(EHandMotionTrackType::Component, Component->GetFName()));
+	}
+
+	for (USkinnedMeshComponent * Mesh : Meshes)
+	{
+		if (!Mesh || !Mesh->SkeletalMesh)
+			continue;
+
+		const int32 BoneCount = RecordedBones.Num() > 0 ? RecordedBones.Num() : Mesh->GetNumBones();
+
+		for (int32 i = 0; i < BoneCount; ++i)
+		{
+			const FName BoneName = RecordedBones.Num() > 0 ? RecordedBones[i] : Mesh->GetBoneName(i);
+
+			if (Mesh->GetBoneIndex(BoneName) == INDEX_NONE)
+				continue;
+
+			FRecordedTrack Track;
+			Track.Component = Mesh;
+			Track.BoneName = BoneName;
+			Track.ParentBoneName = Mesh->GetParentBone(BoneName);
+			Tracks.Add(Track);
+
+			TrackInfos.Add(FHandMotionTrackInfo(EHandMotionTrackType::Bone, Mesh->GetFName(), BoneName));
+		}
+	}
+
+	const FString Path = GetRecordingPath(FileName);
+
+	if (!Writer.Open(Path, TrackInfos, KeyframeInterval))
+	{
+		UE_LOG(LogGauntlet, Warning, TEXT("Failed to start hand motion recording %s with %d tracks"), *Path, TrackInfos.Num());
+		Tracks.Reset();
+		return false;
+	}
+
+	FrameTransforms.Reset();
+	FrameTransforms.AddDefaulted(Tracks.Num());
+
+	RecordingTime = 0.f;
+	NextSampleTime = SampleRate > 0.f ? 1.f / SampleRate : 0.f;
+	CaptureFrame();
+
+	SetComponentTickEnabled(true);
+	return true;
+}
+
+void UHandMotionRecorderComponent::StopRecording()
+{
+	if (Writer.IsOpen())
+		Writer.Close();
+
+	Tracks.Reset();
+	SetComponentTickEnabled(false);
+}
+
+void UHandMotionRecorderComponent::CaptureFrame()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HandMotionRecordFrame);
+
+	for (int32 i = 0; i < Tracks.Num(); ++i)
+	{
+		const FRecordedTrack & Track = Tracks[i];
+		USceneComponent * Component = Track.Component.Get();
+
+		// A destroyed component keeps its last transform
+		if (!Component)
+			continue;
+
+		if (Track.BoneName == NAME_None)
+		{
+			FrameTransforms[i] = Component->GetRelativeTransform();
+			continue;
+		}
+
+		const USkinnedMeshComponent * Mesh = CastChecked<USkinnedMeshComponent>(Component);
+		const FQuat BoneRotation = Mesh->GetBoneQuaternion(Track.BoneName, EBoneSpaces::ComponentSpace);
+		const FQuat ParentRotation = Track.ParentBoneName != NAME_None ? Mesh->GetBoneQuaternion(Track.ParentBoneName, EBoneSpaces::ComponentSpace) : FQuat::Identity;
+
+		FrameTransforms[i] = FTransform(ParentRotation.Inverse() * BoneRotation);
+	}
+
+	Writer.WriteFrame(RecordingTime, FrameTransforms);
+}
+
+void UHandMotionRecorderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!Writer.IsOpen())
+		return;
+
+	RecordingTime += DeltaTime;
+
+	if (SampleRate > 0.f)
+	{
+		if (RecordingTime < NextSampleTime)
+			return;
+
+		// Don't try to catch up on missed samples after a hitch
+		NextSampleTime = FMath::Max(NextSampleTime + 1.f / SampleRate, RecordingTime);
+	}
+
+	CaptureFrame();
+}
+
+void UHandMotionRecorderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopRecording();
+	Super::EndPlay(EndPlayReason);
+}
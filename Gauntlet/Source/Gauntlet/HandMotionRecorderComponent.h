@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "HandMotionRecording.h"
+
+#include "HandMotionRecorderComponent.generated.h"
+
+/**
+ * Records the motion controllers, camera and glove driven finger bones of its owner to a hand motion file.
+ * Used to build gesture corpora and to capture sessions that can be replayed without a headset.
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class GAUNTLET_API UHandMotionRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UHandMotionRecorderComponent(const FObjectInitializer& ObjectInitializer);
+
+	// Components to record the relative transform of, if empty every motion controller and camera on the owner is recorded
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	TArray<USceneComponent *> RecordedComponents;
+
+	// Meshes to record bone rotations from, if empty the skinned meshes on the owner are used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	TArray<USkinnedMeshComponent *> RecordedMeshes;
+
+	// Bones to record on each mesh, if empty every bone is recorded. Missing bones are skipped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	TArray<FName> RecordedBones;
+
+	// Samples per second, 0 records every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	float SampleRate;
+
+	// Frames between full keyframes, lower seeks faster and recovers more of a truncated file at the cost of size
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandMotion")
+	int32 KeyframeInterval;
+
+	// Starts a new recording, relative file names go into Saved/HandMotion
+	UFUNCTION(BlueprintCallable, Category = "HandMotion")
+	bool StartRecording(FString FileName);
+
+	UFUNCTION(BlueprintCallable, Category = "HandMotion")
+	void StopRecording();
+
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	bool IsRecording() const
+	{
+		return Writer.IsOpen();
+	}
+
+	// Size of the current recording in kilobytes
+	UFUNCTION(BlueprintPure, Category = "HandMotion")
+	int32 GetRecordingSizeKB() const
+	{
+		return (int32)(Writer.GetBytesWritten() / 1024);
+	}
+
+	static FString GetRecordingPath(const FString & FileName);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	struct FRecordedTrack
+	{
+		TWeakObjectPtr<USceneComponent> Component;
+		FName BoneName;
+		FName ParentBoneName;
+	};
+
+	void CaptureFrame();
+
+	FHandMotionWriter Writer;
+	TArray<FRecordedTrack> Tracks;
+
+	// Re-used for each frame so recording doesn't allocate
+	TArray<FTransform> FrameTransforms;
+
+	float RecordingTime;
+	float NextSampleTime;
+};
@@ -0,0 +1,617 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HandMotionRecording.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+
+namespace HandMotionFormat
+{
+	// 'GHMR' and 'HINX'
+	static const uint32 FileMagic = 0x524D4847;
+	static const uint32 FooterMagic = 0x584E4948;
+	static const uint16 Version = 1;
+
+	// Per cm, per quaternion component and per second
+	static const float PositionUnits = 100.f;
+	static const float RotationUnits = 32767.f;
+	static const float TicksPerSecond = 10000.f;
+
+	static const uint8 KeyframeFlag = 0x01;
+
+	// LastTicks, IndexOffset and FooterMagic
+	static const int64 FooterTailSize = sizeof(uint32) + sizeof(int64) + sizeof(uint32);
+
+	// Bones only store the rotation values
+	FORCEINLINE int32 GetFirstValue(EHandMotionTrackType Type)
+	{
+		return Type == EHandMotionTrackType::Bone ? 3 : 0;
+	}
+
+	FORCEINLINE uint32 TimeToTicks(float Time)
+	{
+		return (uint32)FMath::Max(0, FMath::RoundToInt(Time * TicksPerSecond));
+	}
+
+	template<typename T>
+	FORCEINLINE void WriteRaw(TArray<uint8> & Out, T Value)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	FORCEINLINE void WriteVarUInt(TArray<uint8> & Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add((uint8)(Value | 0x80));
+			Value >>= 7;
+		}
+
+		Out.Add((uint8)Value);
+	}
+
+	// Zigzag so that small negative deltas stay small
+	FORCEINLINE void WriteVarInt(TArray<uint8> & Out, int32 Value)
+	{
+		WriteVarUInt(Out, ((uint32)Value << 1) ^ (uint32)(Value >> 31));
+	}
+
+	template<typename T>
+	FORCEINLINE bool ReadRaw(const uint8 * Data, int64 End, int64 & Pos, T & OutValue)
+	{
+		if (Pos + (int64)sizeof(T) > End)
+			return false;
+
+		FMemory::Memcpy(&OutValue, Data + Pos, sizeof(T));
+		Pos += sizeof(T);
+		return true;
+	}
+
+	FORCEINLINE bool ReadVarUInt(const uint8 * Data, int64 End, int64 & Pos, uint32 & OutValue)
+	{
+		OutValue = 0;
+
+		for (int32 Shift = 0; Shift < 35; Shift += 7)
+		{
+			if (Pos >= End)
+				return false;
+
+			const uint8 Byte = Data[Pos++];
+			OutValue |= (uint32)(Byte & 0x7F) << Shift;
+
+			if (!(Byte & 0x80))
+				return true;
+		}
+
+		return false;
+	}
+
+	FORCEINLINE bool ReadVarInt(const uint8 * Data, int64 End, int64 & Pos, int32 & OutValue)
+	{
+		uint32 Value;
+		if (!ReadVarUInt(Data, End, Pos, Value))
+			return false;
+
+		OutValue = (int32)(Value >> 1) ^ -(int32)(Value & 1);
+		return true;
+	}
+
+	static void WriteName(TArray<uint8> & Out, FName Name)
+	{
+		FTCHARToUTF8 Converted(*Name.ToString());
+		const int32 Length = FMath::Min(Converted.Length(), 255);
+
+		Out.Add((uint8)Length);
+		Out.Append(reinterpret_cast<const uint8*>(Converted.Get()), Length);
+	}
+
+	static bool ReadName(const uint8 * Data, int64 End, int64 & Pos, FName & OutName)
+	{
+		uint8 Length;
+		if (!ReadRaw(Data, End, Pos, Length) || Pos + Length > End)
+			return false;
+
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data + Pos), Length);
+		OutName = FName(*FString(Converted.Length(), Converted.Get()));
+		Pos += Length;
+		return true;
+	}
+
+	static void Quantize(const FTransform & Transform, FHandMotionQuantizedTrack & Out)
+	{
+		const FVector Location = Transform.GetLocation() * PositionUnits;
+		Out.Values[0] = FMath::RoundToInt(Location.X);
+		Out.Values[1] = FMath::RoundToInt(Location.Y);
+		Out.Values[2] = FMath::RoundToInt(Location.Z);
+
+		// Keep W positive so that it can be rebuilt from the other three
+		FQuat Rotation = Transform.GetRotation().GetNormalized();
+		if (Rotation.W < 0.f)
+			Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+
+		Out.Values[3] = FMath::RoundToInt(Rotation.X * RotationUnits);
+		Out.Values[4] = FMath::RoundToInt(Rotation.Y * RotationUnits);
+		Out.Values[5] = FMath::RoundToInt(Rotation.Z * RotationUnits);
+	}
+
+	static FTransform Dequantize(const FHandMotionQuantizedTrack & Track, EHandMotionTrackType Type)
+	{
+		const float X = Track.Values[3] / RotationUnits;
+		const float Y = Track.Values[4] / RotationUnits;
+		const float Z = Track.Values[5] / RotationUnits;
+		const float W = FMath::Sqrt(FMath::Max(0.f, 1.f - (X * X + Y * Y + Z * Z)));
+
+		FQuat Rotation(X, Y, Z, W);
+		Rotation.Normalize();
+
+		if (Type == EHandMotionTrackType::Bone)
+			return FTransform(Rotation);
+
+		return FTransform(Rotation, FVector(Track.Values[0], Track.Values[1], Track.Values[2]) / PositionUnits);
+	}
+}
+
+FHandMotionWriter::FHandMotionWriter() :
+	KeyframeInterval(90),
+	FramesSinceKeyframe(0),
+	FrameCount(0),
+	PreviousTicks(0)
+{
+}
+
+FHandMotionWriter::~FHandMotionWriter()
+{
+	Close();
+}
+
+bool FHandMotionWriter::Open(const FString & FileName, const TArray<FHandMotionTrackInfo> & InTracks, int32 InKeyframeInterval)
+{
+	using namespace HandMotionFormat;
+
+	Close();
+
+	if (InTracks.Num() < 1 || InTracks.Num() > MAX_uint16)
+		return false;
+
+	Archive = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*FileName));
+
+	if (!Archive.IsValid())
+		return false;
+
+	Tracks = InTracks;
+	KeyframeInterval = FMath::Max(1, InKeyframeInterval);
+	FramesSinceKeyframe = 0;
+	FrameCount = 0;
+	PreviousTicks = 0;
+	Keyframes.Reset();
+
+	Previous.SetNumZeroed(Tracks.Num());
+	Current.SetNumZeroed(Tracks.Num());
+
+	FrameBuffer.Reset();
+	WriteRaw<uint32>(FrameBuffer, FileMagic);
+	WriteRaw<uint16>(FrameBuffer, Version);
+	WriteRaw<uint16>(FrameBuffer, (uint16)Tracks.Num());
+
+	for (const FHandMotionTrackInfo & Track : Tracks)
+	{
+		WriteRaw<uint8>(FrameBuffer, (uint8)Track.Type);
+		WriteName(FrameBuffer, Track.ComponentName);
+		WriteName(FrameBuffer, Track.BoneName);
+	}
+
+	Archive->Serialize(FrameBuffer.GetData(), FrameBuffer.Num());
+	return true;
+}
+
+void FHandMotionWriter::WriteFrame(float Time, TArrayView<const FTransform> Transforms)
+{
+	using namespace HandMotionFormat;
+
+	if (!Archive.IsValid() || Transforms.Num() != Tracks.Num())
+		return;
+
+	const uint32 FrameTicks = FMath::Max(TimeToTicks(Time), PreviousTicks);
+	const bool bKeyframe = FrameCount == 0 || FramesSinceKeyframe >= KeyframeInterval;
+
+	for (int32 i = 0; i < Tracks.Num(); ++i)
+	{
+		Quantize(Transforms[i], Current[i]);
+	}
+
+	FrameBuffer.Reset();
+	FrameBuffer.Add(bKeyframe ? KeyframeFlag : 0);
+
+	if (bKeyframe)
+	{
+		FKeyframeEntry Entry;
+		Entry.Ticks = FrameTicks;
+		Entry.Offset = Archive->Tell();
+		Keyframes.Add(Entry);
+
+		WriteVarUInt(FrameBuffer, FrameTicks);
+
+		for (int32 i = 0; i < Tracks.Num(); ++i)
+		{
+			for (int32 Value = GetFirstValue(Tracks[i].Type); Value < 6; ++Value)
+			{
+				WriteVarInt(FrameBuffer, Current[i].Values[Value]);
+			}
+		}
+
+		FramesSinceKeyframe = 0;
+	}
+	else
+	{
+		WriteVarUInt(FrameBuffer, FrameTicks - PreviousTicks);
+
+		// One bit per track that changed since the last frame, unchanged tracks are skipped entirely
+		const int32 MaskStart = FrameBuffer.AddZeroed((Tracks.Num() + 7) / 8);
+
+		for (int32 i = 0; i < Tracks.Num(); ++i)
+		{
+			const int32 FirstValue = GetFirstValue(Tracks[i].Type);
+
+			if (FMemory::Memcmp(&Current[i].Values[FirstValue], &Previous[i].Values[FirstValue], (6 - FirstValue) * sizeof(int32)) == 0)
+				continue;
+
+			FrameBuffer[MaskStart + i / 8] |= (uint8)(1 << (i % 8));
+
+			for (int32 Value = FirstValue; Value < 6; ++Value)
+			{
+				WriteVarInt(FrameBuffer, Current[i].Values[Value] - Previous[i].Values[Value]);
+			}
+		}
+
+		++FramesSinceKeyframe;
+	}
+
+	Archive->Serialize(FrameBuffer.GetData(), FrameBuffer.Num());
+
+	Swap(Previous, Current);
+	PreviousTicks = FrameTicks;
+	++FrameCount;
+}
+
+int64 FHandMotionWriter::GetBytesWritten() const
+{
+	return Archive.IsValid() ? Archive->Tell() : 0;
+}
+
+void FHandMotionWriter::Close()
+{
+	using namespace HandMotionFormat;
+
+	if (!Archive.IsValid())
+		return;
+
+	const int64 IndexOffset = Archive->Tell();
+
+	FrameBuffer.Reset();
+	WriteRaw<uint32>(FrameBuffer, (uint32)Keyframes.Num());
+
+	for (const FKeyframeEntry & Entry : Keyframes)
+	{
+		WriteRaw<uint32>(FrameBuffer, Entry.Ticks);
+		WriteRaw<int64>(FrameBuffer, Entry.Offset);
+	}
+
+	WriteRaw<uint32>(FrameBuffer, PreviousTicks);
+	WriteRaw<int64>(FrameBuffer, IndexOffset);
+	WriteRaw<uint32>(FrameBuffer, FooterMagic);
+
+	Archive->Serialize(FrameBuffer.GetData(), FrameBuffer.Num());
+	Archive->Close();
+	Archive.Reset();
+
+	FrameBuffer.Empty();
+	Keyframes.Empty();
+}
+
+FHandMotionReader::FHandMotionReader() :
+	Data(nullptr),
+	DataSize(0),
+	FramesStart(0),
+	FramesEnd(0),
+	LastTicks(0),
+	Position(0),
+	Ticks(0),
+	bHasKeyframe(false)
+{
+}
+
+FHandMotionReader::~FHandMotionReader()
+{
+	Close();
+}
+
+bool FHandMotionReader::Open(const FString & FileName)
+{
+	Close();
+
+	IPlatformFile & PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedHandle.Reset(PlatformFile.OpenMapped(*FileName));
+
+	if (MappedHandle.IsValid())
+		MappedRegion.Reset(MappedHandle->MapRegion());
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Not every platform file can map, fall back to reading the whole file
+		MappedHandle.Reset();
+
+		if (!FFileHelper::LoadFileToArray(LoadedData, *FileName))
+			return false;
+
+		Data = LoadedData.GetData();
+		DataSize = LoadedData.Num();
+	}
+
+	if (!Data || !ReadHeader() || !ReadIndex())
+	{
+		Close();
+		return false;
+	}
+
+	Rewind();
+	return true;
+}
+
+void FHandMotionReader::Close()
+{
+	// Regions have to go before their file handle
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	LoadedData.Empty();
+
+	Data = nullptr;
+	DataSize = 0;
+	FramesStart = 0;
+	FramesEnd = 0;
+	LastTicks = 0;
+	Position = 0;
+	Ticks = 0;
+	bHasKeyframe = false;
+
+	Tracks.Reset();
+	State.Reset();
+	Keyframes.Reset();
+}
+
+bool FHandMotionReader::ReadHeader()
+{
+	using namespace HandMotionFormat;
+
+	int64 Pos = 0;
+	uint32 Magic;
+	uint16 FileVersion;
+	uint16 TrackCount;
+
+	if (!ReadRaw(Data, DataSize, Pos, Magic) || Magic != FileMagic)
+		return false;
+
+	if (!ReadRaw(Data, DataSize, Pos, FileVersion) || FileVersion != Version)
+		return false;
+
+	if (!ReadRaw(Data, DataSize, Pos, TrackCount) || TrackCount < 1)
+		return false;
+
+	Tracks.SetNum(TrackCount);
+
+	for (FHandMotionTrackInfo & Track : Tracks)
+	{
+		uint8 Type;
+		if (!ReadRaw(Data, DataSize, Pos, Type) || Type > (uint8)EHandMotionTrackType::Bone)
+			return false;
+
+		Track.Type = (EHandMotionTrackType)Type;
+
+		if (!ReadName(Data, DataSize, Pos, Track.ComponentName) || !ReadName(Data, DataSize, Pos, Track.BoneName))
+			return false;
+	}
+
+	State.SetNumZeroed(Tracks.Num());
+	FramesStart = Pos;
+	return true;
+}
+
+bool FHandMotionReader::ReadIndex()
+{
+	using namespace HandMotionFormat;
+
+	Keyframes.Reset();
+
+	if (DataSize - FramesStart >= FooterTailSize)
+	{
+		int64 Pos = DataSize - FooterTailSize;
+		uint32 FooterLastTicks;
+		int64 IndexOffset;
+		uint32 Magic;
+
+		ReadRaw(Data, DataSize, Pos, FooterLastTicks);
+		ReadRaw(Data, DataSize, Pos, IndexOffset);
+		ReadRaw(Data, DataSize, Pos, Magic);
+
+		if (Magic == FooterMagic && IndexOffset >= FramesStart && IndexOffset <= DataSize - FooterTailSize)
+		{
+			const int64 IndexEnd = DataSize - FooterTailSize;
+			Pos = IndexOffset;
+
+			uint32 Count;
+			if (!ReadRaw(Data, IndexEnd, Pos, Count) || Pos + (int64)Count * (sizeof(uint32) + sizeof(int64)) > IndexEnd)
+				return false;
+
+			Keyframes.SetNum(Count);
+
+			for (FKeyframeEntry & Entry : Keyframes)
+			{
+				ReadRaw(Data, IndexEnd, Pos, Entry.Ticks);
+				ReadRaw(Data, IndexEnd, Pos, Entry.Offset);
+
+				if (Entry.Offset < FramesStart || Entry.Offset >= IndexOffset)
+					return false;
+			}
+
+			FramesEnd = IndexOffset;
+			LastTicks = FooterLastTicks;
+			return true;
+		}
+	}
+
+	// The recording was never closed (crash or killed session), rebuild the index and drop a truncated last frame
+	FramesEnd = DataSize;
+	bHasKeyframe = false;
+
+	int64 Pos = FramesStart;
+	int64 LastGoodPos = FramesStart;
+	uint32 ScanTicks = 0;
+	bool bKeyframe = false;
+
+	while (Pos < FramesEnd)
+	{
+		const int64 FrameStart = Pos;
+
+		if (!DecodeFrame(Pos, ScanTicks, bKeyframe))
+			break;
+
+		if (bKeyframe)
+		{
+			FKeyframeEntry Entry;
+			Entry.Ticks = ScanTicks;
+			Entry.Offset = FrameStart;
+			Keyframes.Add(Entry);
+		}
+
+		LastGoodPos = Pos;
+		LastTicks = ScanTicks;
+	}
+
+	FramesEnd = LastGoodPos;
+	return true;
+}
+
+bool FHandMotionReader::DecodeFrame(int64 & InOutPos, uint32 & InOutTicks, bool & bOutKeyframe)
+{
+	using namespace HandMotionFormat;
+
+	int64 Pos = InOutPos;
+	uint8 Flags;
+
+	if (!ReadRaw(Data, FramesEnd, Pos, Flags))
+		return false;
+
+	bOutKeyframe = (Flags & KeyframeFlag) != 0;
+	uint32 FrameTicks;
+
+	if (!ReadVarUInt(Data, FramesEnd, Pos, FrameTicks))
+		return false;
+
+	if (bOutKeyframe)
+	{
+		for (int32 i = 0; i < Tracks.Num(); ++i)
+		{
+			for (int32 Value = GetFirstValue(Tracks[i].Type); Value < 6; ++Value)
+			{
+				if (!ReadVarInt(Data, FramesEnd, Pos, State[i].Values[Value]))
+					return false;
+			}
+		}
+
+		InOutTicks = FrameTicks;
+		bHasKeyframe = true;
+	}
+	else
+	{
+		// Deltas are meaningless without the keyframe before them
+		if (!bHasKeyframe)
+			return false;
+
+		const int32 MaskBytes = (Tracks.Num() + 7) / 8;
+		if (Pos + MaskBytes > FramesEnd)
+			return false;
+
+		const uint8 * Mask = Data + Pos;
+		Pos += MaskBytes;
+
+		for (int32 i = 0; i < Tracks.Num(); ++i)
+		{
+			if (!(Mask[i / 8] & (1 << (i % 8))))
+				continue;
+
+			for (int32 Value = GetFirstValue(Tracks[i].Type); Value < 6; ++Value)
+			{
+				int32 Delta;
+				if (!ReadVarInt(Data, FramesEnd, Pos, Delta))
+					return false;
+
+				State[i].Values[Value] += Delta;
+			}
+		}
+
+		InOutTicks += FrameTicks;
+	}
+
+	InOutPos = Pos;
+	return true;
+}
+
+float FHandMotionReader::GetDuration() const
+{
+	return LastTicks / HandMotionFormat::TicksPerSecond;
+}
+
+bool FHandMotionReader::ReadFrame(float & OutTime, TArray<FTransform> & OutTransforms)
+{
+	if (!Data || Position >= FramesEnd)
+		return false;
+
+	bool bKeyframe = false;
+	if (!DecodeFrame(Position, Ticks, bKeyframe))
+	{
+		Position = FramesEnd;
+		return false;
+	}
+
+	OutTime = Ticks / HandMotionFormat::TicksPerSecond;
+	OutTransforms.SetNum(Tracks.Num(), false);
+
+	for (int32 i = 0; i < Tracks.Num(); ++i)
+	{
+		OutTransforms[i] = HandMotionFormat::Dequantize(State[i], Tracks[i].Type);
+	}
+
+	return true;
+}
+
+void FHandMotionReader::Seek(float Time)
+{
+	const uint32 TargetTicks = HandMotionFormat::TimeToTicks(Time);
+
+	Position = FramesStart;
+	Ticks = 0;
+	bHasKeyframe = false;
+
+	// Last keyframe at or before the target
+	int32 Low = 0;
+	int32 High = Keyframes.Num();
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Keyframes[Mid].Ticks <= TargetTicks)
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+
+	if (Low > 0)
+	{
+		Position = Keyframes[Low - 1].Offset;
+		Ticks = Keyframes[Low - 1].Ticks;
+	}
+}
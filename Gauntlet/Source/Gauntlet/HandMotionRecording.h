@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "Templates/UniquePtr.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Compact streaming format for recorded hand motion.
+ *
+ * A file is a header with the track list, then frames, then an optional keyframe index footer (missing if the recording
+ * was never closed, the reader rebuilds it by scanning). Positions are quantized to 0.1mm and rotations to 1/32767 of a
+ * quaternion component, both stored as zigzag varints. Every frame after a keyframe only stores the changed tracks as
+ * deltas from the previous frame, so a still hand costs a few bytes per frame. Keyframes store absolute values so
+ * playback can start from any of them.
+ */
+
+enum class EHandMotionTrackType : uint8
+{
+	// Relative location and rotation of a scene component (controllers, camera)
+	Component = 0,
+
+	// Rotation of a bone relative to its parent
+	Bone = 1
+};
+
+struct GAUNTLET_API FHandMotionTrackInfo
+{
+	EHandMotionTrackType Type;
+
+	// Name of the component on the owning actor, for bones the skinned mesh
+	FName ComponentName;
+	FName BoneName;
+
+	FHandMotionTrackInfo() :
+		Type(EHandMotionTrackType::Component),
+		ComponentName(NAME_None),
+		BoneName(NAME_None)
+	{}
+
+	FHandMotionTrackInfo(EHandMotionTrackType InType, FName InComponentName, FName InBoneName = NAME_None) :
+		Type(InType),
+		ComponentName(InComponentName),
+		BoneName(InBoneName)
+	{}
+};
+
+// Quantized track values, location XYZ then rotation XYZ (W is rebuilt as positive)
+struct FHandMotionQuantizedTrack
+{
+	int32 Values[6];
+};
+
+class GAUNTLET_API FHandMotionWriter
+{
+public:
+
+	FHandMotionWriter();
+	~FHandMotionWriter();
+
+	// Creates the file and writes the header, a keyframe is forced every KeyframeInterval frames
+	bool Open(const FString & FileName, const TArray<FHandMotionTrackInfo> & InTracks, int32 InKeyframeInterval);
+
+	// Appends a frame, Transforms has one entry per track. Time is in seconds from the start of the recording and must not decrease
+	void WriteFrame(float Time, TArrayView<const FTransform> Transforms);
+
+	// Writes the keyframe index and closes the file
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Archive.IsValid();
+	}
+
+	int32 GetFrameCount() const
+	{
+		return FrameCount;
+	}
+
+	int64 GetBytesWritten() const;
+
+private:
+
+	struct FKeyframeEntry
+	{
+		uint32 Ticks;
+		int64 Offset;
+	};
+
+	TUniquePtr<FArchive> Archive;
+	TArray<FHandMotionTrackInfo> Tracks;
+	TArray<FHandMotionQuantizedTrack> Previous;
+	TArray<FHandMotionQuantizedTrack> Current;
+	TArray<FKeyframeEntry> Keyframes;
+
+	// Re-used for each frame so writing doesn't allocate
+	TArray<uint8> FrameBuffer;
+
+	int32 KeyframeInterval;
+	int32 FramesSinceKeyframe;
+	int32 FrameCount;
+	uint32 PreviousTicks;
+};
+
+class GAUNTLET_API FHandMotionReader
+{
+public:
+
+	FHandMotionReader();
+	~FHandMotionReader();
+
+	// Maps the file (or loads it if the platform can't map files) and reads the header and keyframe index
+	bool Open(const FString & FileName);
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Data != nullptr;
+	}
+
+	const TArray<FHandMotionTrackInfo> & GetTracks() const
+	{
+		return Tracks;
+	}
+
+	float GetDuration() const;
+
+	// Decodes the next frame, OutTransforms gets one entry per track. False at the end of the recording or on a truncated frame
+	bool ReadFrame(float & OutTime, TArray<FTransform> & OutTransforms);
+
+	// Moves to the last keyframe at or before Time, the next ReadFrame returns that keyframe
+	void Seek(float Time);
+
+	void Rewind()
+	{
+		Seek(0.f);
+	}
+
+private:
+
+	struct FKeyframeEntry
+	{
+		uint32 Ticks;
+		int64 Offset;
+	};
+
+	bool ReadHeader();
+	bool ReadIndex();
+	bool DecodeFrame(int64 & InOutPos, uint32 & InOutTicks, bool & bOutKeyframe);
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedData;
+
+	const uint8 * Data;
+	int64 DataSize;
+
+	// Frames are between these offsets, the footer is after FramesEnd
+	int64 FramesStart;
+	int64 FramesEnd;
+
+	TArray<FHandMotionTrackInfo> Tracks;
+	TArray<FHandMotionQuantizedTrack> State;
+	TArray<FKeyframeEntry> Keyframes;
+	uint32 LastTicks;
+
+	int64 Position;
+	uint32 Ticks;
+	bool bHasKeyframe;
+};
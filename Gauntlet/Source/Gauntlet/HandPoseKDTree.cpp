@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HandPoseKDTree.h"
+
+FHandPoseKDTree::FHandPoseKDTree() :
+	Dimensions(0),
+	Root(INDEX_NONE)
+{
+}
+
+void FHandPoseKDTree::Build(const TArray<float> & InPoints, int32 InDimensions)
+{
+	Nodes.Reset();
+	Points = InPoints;
+	Dimensions = InDimensions;
+	Root = INDEX_NONE;
+
+	if (Dimensions < 1 || Points.Num() < Dimensions)
+		return;
+
+	TArray<int32> Indices;
+	Indices.Reserve(Num());
+	for (int32 i = 0; i < Num(); ++i)
+	{
+		Indices.Add(i);
+	}
+
+	Nodes.Reserve(Num());
+	Root = BuildRecursive(Indices, 0, Indices.Num());
+}
+
+int32 FHandPoseKDTree::BuildRecursive(TArray<int32> & Indices, int32 Start, int32 End)
+{
+	if (Start >= End)
+		return INDEX_NONE;
+
+	// Split on the dimension with the widest spread
+	int32 SplitDimension = 0;
+	float WidestSpread = -1.f;
+
+	for (int32 Dimension = 0; Dimension < Dimensions; ++Dimension)
+	{
+		float Min = MAX_FLT;
+		float Max = -MAX_FLT;
+
+		for (int32 i = Start; i < End; ++i)
+		{
+			const float Value = GetPoint(Indices[i])[Dimension];
+			Min = FMath::Min(Min, Value);
+			Max = FMath::Max(Max, Value);
+		}
+
+		if (Max - Min > WidestSpread)
+		{
+			WidestSpread = Max - Min;
+			SplitDimension = Dimension;
+		}
+	}
+
+	Sort(Indices.GetData() + Start, End - Start, [this, SplitDimension](const int32 & A, const int32 & B)
+	{
+		return GetPoint(A)[SplitDimension] < GetPoint(B)[SplitDimension];
+	});
+
+	const int32 Median = Start + (End - Start) / 2;
+	const int32 NodeIndex = Nodes.AddUninitialized();
+	Nodes[NodeIndex].PointIndex = Indices[Median];
+	Nodes[NodeIndex].SplitDimension = SplitDimension;
+
+	// Nodes can move while the children are added, so write through the index
+	const int32 Left = BuildRecursive(Indices, Start, Median);
+	const int32 Right = BuildRecursive(Indices, Median + 1, End);
+	Nodes[NodeIndex].Left = Left;
+	Nodes[NodeIndex].Right = Right;
+
+	return NodeIndex;
+}
+
+int32 FHandPoseKDTree::FindNearest(const float * Query, float & OutDistSquared) const
+{
+	int32 Best = INDEX_NONE;
+	OutDistSquared = MAX_FLT;
+
+	if (Root != INDEX_NONE)
+		SearchRecursive(Root, Query, Best, OutDistSquared);
+
+	return Best;
+}
+
+void FHandPoseKDTree::SearchRecursive(int32 NodeIndex, const float * Query, int32 & InOutBest, float & InOutBestDistSquared) const
+{
+	const FNode & Node = Nodes[NodeIndex];
+	const float * Point = GetPoint(Node.PointIndex);
+
+	const float Distance = DistSquared(Query, Point);
+	if (Distance < InOutBestDistSquared)
+	{
+		InOutBestDistSquared = Distance;
+		InOutBest = Node.PointIndex;
+	}
+
+	const float SplitDelta = Query[Node.SplitDimension] - Point[Node.SplitDimension];
+	const int32 Near = SplitDelta < 0.f ? Node.Left : Node.Right;
+	const int32 Far = SplitDelta < 0.f ? Node.Right : Node.Left;
+
+	if (Near != INDEX_NONE)
+		SearchRecursive(Near, Query, InOutBest, InOutBestDistSquared);
+
+	// Only cross the split if the best match so far reaches over it
+	if (Far != INDEX_NONE && SplitDelta * SplitDelta < InOutBestDistSquared)
+		SearchRecursive(Far, Query, InOutBest, InOutBestDistSquared);
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Static KD-tree over fixed length float feature vectors for exact nearest neighbour queries.
+ * Built once from a flat array of points, queries are read only so they can run on any thread.
+ */
+class GAUNTLET_API FHandPoseKDTree
+{
+public:
+
+	FHandPoseKDTree();
+
+	// Builds the tree, Points holds PointCount * Dimensions floats
+	void Build(const TArray<float> & InPoints, int32 InDimensions);
+
+	// Returns the index of the closest point to Query (Dimensions floats), INDEX_NONE if the tree is empty
+	int32 FindNearest(const float * Query, float & OutDistSquared) const;
+
+	int32 Num() const
+	{
+		return Dimensions > 0 ? Points.Num() / Dimensions : 0;
+	}
+
+	int32 GetDimensions() const
+	{
+		return Dimensions;
+	}
+
+private:
+
+	struct FNode
+	{
+		// Point stored at this node, it also splits its children
+		int32 PointIndex;
+		int32 SplitDimension;
+		int32 Left;
+		int32 Right;
+	};
+
+	int32 BuildRecursive(TArray<int32> & Indices, int32 Start, int32 End);
+	void SearchRecursive(int32 NodeIndex, const float * Query, int32 & InOutBest, float & InOutBestDistSquared) const;
+
+	const float * GetPoint(int32 PointIndex) const
+	{
+		return Points.GetData() + PointIndex * Dimensions;
+	}
+
+	float DistSquared(const float * A, const float * B) const
+	{
+		float Distance = 0.f;
+		for (int32 i = 0; i < Dimensions; ++i)
+		{
+			const float Delta = A[i] - B[i];
+			Distance += Delta * Delta;
+		}
+
+		return Distance;
+	}
+
+	TArray<FNode> Nodes;
+	TArray<float> Points;
+	int32 Dimensions;
+	int32 Root;
+};
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HandPoseRecognizerComponent.h"
+#include "Gauntlet.h"
+#include "GameFramework/Actor.h"
+#include "Async/Async.h"
+
+DECLARE_STATS_GROUP(TEXT("HandPose"), STATGROUP_HandPose, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("HandPose ~ Read Bones"), STAT_HandPoseReadBones, STATGROUP_HandPose);
+DECLARE_CYCLE_STAT(TEXT("HandPose ~ Classify"), STAT_HandPoseClassify, STATGROUP_HandPose);
+
+UHandPoseDatabase::UHandPoseDatabase() :
+	bTreeDirty(true)
+{
+}
+
+bool UHandPoseDatabase::ExtractFeatures(const USkinnedMeshComponent * Mesh, const TArray<FName> & OverrideBoneNames, TArray<float> & OutFeatures) const
+{
+	OutFeatures.Reset();
+
+	if (!Mesh || !Mesh->SkeletalMesh)
+		return false;
+
+	const TArray<FName> & Bones = OverrideBoneNames.Num() == BoneNames.Num() ? OverrideBoneNames : BoneNames;
+
+	for (int32 i = 0; i < Bones.Num(); ++i)
+	{
+		const FName ParentName = Mesh->GetParentBone(Bones[i]);
+
+		if (Mesh->GetBoneIndex(Bones[i]) == INDEX_NONE || ParentName == NAME_None)
+		{
+			OutFeatures.Reset();
+			return false;
+		}
+
+		// Relative to the parent so that the hand position and wrist rotation don't matter
+		const FQuat BoneRotation = Mesh->GetBoneQuaternion(Bones[i], EBoneSpaces::ComponentSpace);
+		const FQuat ParentRotation = Mesh->GetBoneQuaternion(ParentName, EBoneSpaces::ComponentSpace);
+		FQuat LocalRotation = ParentRotation.Inverse() * BoneRotation;
+		LocalRotation.Normalize();
+
+		// Rotation vector, its length is the angle so distances between poses read as radians
+		FVector Axis;
+		float Angle;
+		LocalRotation.ToAxisAndAngle(Axis, Angle);
+
+		if (Angle > PI)
+			Angle -= 2.f * PI;
+
+		const float Weight = BoneWeights.IsValidIndex(i) ? BoneWeights[i] : 1.f;
+		const FVector RotationVector = Axis * Angle * Weight;
+
+		OutFeatures.Add(RotationVector.X);
+		OutFeatures.Add(RotationVector.Y);
+		OutFeatures.Add(RotationVector.Z);
+	}
+
+	return OutFeatures.Num() > 0;
+}
+
+bool UHandPoseDatabase::RecordPose(USkinnedMeshComponent * Mesh, FString PoseName, float MatchThreshold)
+{
+	FHandPose NewPose;
+	NewPose.Name = PoseName;
+	NewPose.MatchThreshold = MatchThreshold;
+
+	if (!ExtractFeatures(Mesh, TArray<FName>(), NewPose.Features))
+		return false;
+
+	Poses.Add(NewPose);
+	MarkPosesDirty();
+	return true;
+}
+
+TSharedPtr<const FHandPoseSearchData, ESPMode::ThreadSafe> UHandPoseDatabase::GetSearchData()
+{
+	check(IsInGameThread());
+
+	if (bTreeDirty || !SearchData.IsValid())
+	{
+		TSharedPtr<FHandPoseSearchData, ESPMode::ThreadSafe> NewSearchData = MakeShared<FHandPoseSearchData, ESPMode::ThreadSafe>();
+
+		const int32 Dimensions = BoneNames.Num() * 3;
+		TArray<float> Points;
+		Points.Reserve(Poses.Num() * Dimensions);
+
+		for (int32 PoseIndex = 0; PoseIndex < Poses.Num(); ++PoseIndex)
+		{
+			const FHandPose & Pose = Poses[PoseIndex];
+
+			// Poses recorded with a different bone list can't be compared, they stay out of the tree
+			if (Pose.Features.Num() != Dimensions)
+			{
+				UE_LOG(LogGauntlet, Warning, TEXT("Hand pose %s in %s has %d features, expected %d, re-record it"), *Pose.Name, *GetName(), Pose.Features.Num(), Dimensions);
+				continue;
+			}
+
+			Points.Append(Pose.Features);
+			NewSearchData->PoseIndices.Add(PoseIndex);
+			NewSearchData->MatchThresholds.Add(Pose.MatchThreshold);
+		}
+
+		NewSearchData->Tree.Build(Points, Dimensions);
+		SearchData = NewSearchData;
+		bTreeDirty = false;
+	}
+
+	return SearchData;
+}
+
+UHandPoseRecognizerComponent::UHandPoseRecognizerComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+
+	PoseDatabase = nullptr;
+	TargetMesh = nullptr;
+	MaxPoseDistance = 0.5f;
+	bClassifyAsync = true;
+	CurrentPoseIndex = INDEX_NONE;
+	CurrentPoseDistance = MAX_FLT;
+}
+
+void UHandPoseRecognizerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!TargetMesh && GetOwner())
+	{
+		TargetMesh = GetOwner()->FindComponentByClass<USkinnedMeshComponent>();
+	}
+
+	Features = MakeShared<TArray<float>, ESPMode::ThreadSafe>();
+}
+
+FString UHandPoseRecognizerComponent::GetCurrentPoseName() const
+{
+	if (PoseDatabase && PoseDatabase->Poses.IsValidIndex(CurrentPoseIndex))
+		return PoseDatabase->Poses[CurrentPoseIndex].Name;
+
+	return FString();
+}
+
+int32 UHandPoseRecognizerComponent::Classify(const FHandPoseSearchData & SearchData, float DefaultThreshold, const TArray<float> & InFeatures, float & OutDistance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HandPoseClassify);
+
+	OutDistance = MAX_FLT;
+
+	if (InFeatures.Num() != SearchData.Tree.GetDimensions() || SearchData.Tree.Num() < 1)
+		return INDEX_NONE;
+
+	float DistSquared = MAX_FLT;
+	const int32 TreeIndex = SearchData.Tree.FindNearest(InFeatures.GetData(), DistSquared);
+
+	if (TreeIndex == INDEX_NONE)
+		return INDEX_NONE;
+
+	OutDistance = FMath::Sqrt(DistSquared);
+
+	const float PoseThreshold = SearchData.MatchThresholds[TreeIndex];
+	const float Threshold = PoseThreshold > 0.f ? PoseThreshold : DefaultThreshold;
+
+	if (OutDistance > Threshold)
+		return INDEX_NONE;
+
+	return SearchData.PoseIndices[TreeIndex];
+}
+
+void UHandPoseRecognizerComponent::ApplyResult(int32 PoseIndex, float Distance)
+{
+	CurrentPoseDistance = Distance;
+
+	if (PoseIndex == CurrentPoseIndex)
+		return;
+
+	CurrentPoseIndex = PoseIndex;
+	OnHandPoseChanged.Broadcast(GetCurrentPoseName(), CurrentPoseIndex, CurrentPoseDistance);
+}
+
+void UHandPoseRecognizerComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!PoseDatabase || !TargetMesh || !Features.IsValid())
+		return;
+
+	// Last frames search is still running, skip this frame rather than queueing behind it
+	if (ClassifyTask.IsValid() && !ClassifyTask->IsComplete())
+		return;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HandPoseReadBones);
+
+		if (!PoseDatabase->ExtractFeatures(TargetMesh, BoneNameOverrides, *Features))
+			return;
+	}
+
+	TSharedPtr<const FHandPoseSearchData, ESPMode::ThreadSafe> SearchData = PoseDatabase->GetSearchData();
+
+	if (!bClassifyAsync)
+	{
+		float Distance = MAX_FLT;
+		const int32 PoseIndex = Classify(*SearchData, MaxPoseDistance, *Features, Distance);
+		ApplyResult(PoseIndex, Distance);
+		return;
+	}
+
+	TWeakObjectPtr<UHandPoseRecognizerComponent> WeakThis(this);
+	TSharedPtr<TArray<float>, ESPMode::ThreadSafe> TaskFeatures = Features;
+	const float DefaultThreshold = MaxPoseDistance;
+
+	// The task only touches the shared data it holds on to, so the component can go away while it runs
+	ClassifyTask = FFunctionGraphTask::CreateAndDispatchWhenReady([WeakThis, SearchData, TaskFeatures, DefaultThreshold]()
+	{
+		float Distance = MAX_FLT;
+		const int32 PoseIndex = Classify(*SearchData, DefaultThreshold, *TaskFeatures, Distance);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, PoseIndex, Distance]()
+		{
+			if (UHandPoseRecognizerComponent * Recognizer = WeakThis.Get())
+			{
+				Recognizer->ApplyResult(PoseIndex, Distance);
+			}
+		});
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
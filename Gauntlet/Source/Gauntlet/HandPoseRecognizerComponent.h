@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Components/ActorComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HandPoseKDTree.h"
+
+#include "HandPoseRecognizerComponent.generated.h"
+
+// A recorded hand pose, Features has three floats (rotation vector in radians) per database bone
+USTRUCT(BlueprintType)
+struct GAUNTLET_API FHandPose
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	FString Name;
+
+	// Max feature distance to still count as this pose, 0 uses the recognizers MaxPoseDistance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	float MatchThreshold;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	TArray<float> Features;
+
+	FHandPose() :
+		MatchThreshold(0.f)
+	{}
+};
+
+// Immutable search data built from a pose database, shared with the worker threads doing the classification
+struct GAUNTLET_API FHandPoseSearchData
+{
+	FHandPoseKDTree Tree;
+
+	// Per tree point index into the databases Poses, poses that can't be compared are left out of the tree
+	TArray<int32> PoseIndices;
+
+	// Per tree point match threshold, 0 uses the recognizers default
+	TArray<float> MatchThresholds;
+};
+
+/**
+ * Database of static hand poses recorded from a glove skeleton
+ */
+UCLASS(BlueprintType)
+class GAUNTLET_API UHandPoseDatabase : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UHandPoseDatabase();
+
+	// Finger bones that make up a pose, in feature order
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	TArray<FName> BoneNames;
+
+	// Optional per bone weight, missing entries are 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	TArray<float> BoneWeights;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	TArray<FHandPose> Poses;
+
+	// Captures the current pose of the mesh and adds it to the database
+	UFUNCTION(BlueprintCallable, Category = "HandPose")
+	bool RecordPose(USkinnedMeshComponent * Mesh, FString PoseName, float MatchThreshold = 0.f);
+
+	// Call after changing poses or bones directly so that the search tree is rebuilt
+	UFUNCTION(BlueprintCallable, Category = "HandPose")
+	void MarkPosesDirty()
+	{
+		bTreeDirty = true;
+	}
+
+	// Reads the feature vector of the bones from a mesh, the rotation of each bone relative to its parent as a rotation vector
+	// OverrideBoneNames replaces BoneNames if it has the same count (for a mesh with differently named bones)
+	bool ExtractFeatures(const USkinnedMeshComponent * Mesh, const TArray<FName> & OverrideBoneNames, TArray<float> & OutFeatures) const;
+
+	// Returns the search data, rebuilding it if the poses changed. Game thread only, the data itself can be shared with worker threads
+	TSharedPtr<const FHandPoseSearchData, ESPMode::ThreadSafe> GetSearchData();
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override
+	{
+		Super::PostEditChangeProperty(PropertyChangedEvent);
+		MarkPosesDirty();
+	}
+#endif
+
+private:
+
+	// Rebuilt instead of modified so that a worker thread can finish a query on the old one
+	TSharedPtr<const FHandPoseSearchData, ESPMode::ThreadSafe> SearchData;
+	bool bTreeDirty;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHandPoseChangedSignature, FString, PoseName, int32, PoseIndex, float, PoseDistance);
+
+/**
+ * Classifies the current pose of a glove skeleton against a hand pose database every frame.
+ * Bone rotations are read on the game thread, the nearest neighbour search runs on a worker thread and the result is
+ * applied on the game thread a frame later.
+ */
+UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
+class GAUNTLET_API UHandPoseRecognizerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UHandPoseRecognizerComponent(const FObjectInitializer& ObjectInitializer);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	UHandPoseDatabase * PoseDatabase;
+
+	// Mesh to read the bones from, if not set the first skinned mesh on the owner is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	USkinnedMeshComponent * TargetMesh;
+
+	// Replaces the database bone names when reading this mesh (same order and count), for the other hand or another skeleton
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	TArray<FName> BoneNameOverrides;
+
+	// Max feature distance to count as a pose, for poses without their own threshold
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	float MaxPoseDistance;
+
+	// If true the search runs on a worker thread, otherwise it runs in the tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandPose")
+	bool bClassifyAsync;
+
+	// Index of the current pose in the database, INDEX_NONE if the hand isn't in a known pose
+	UPROPERTY(BlueprintReadOnly, Category = "HandPose")
+	int32 CurrentPoseIndex;
+
+	// Feature distance of the last classification
+	UPROPERTY(BlueprintReadOnly, Category = "HandPose")
+	float CurrentPoseDistance;
+
+	// Fired when the recognized pose changes, PoseIndex is INDEX_NONE when leaving a pose
+	UPROPERTY(BlueprintAssignable, Category = "HandPose")
+	FHandPoseChangedSignature OnHandPoseChanged;
+
+	UFUNCTION(BlueprintPure, Category = "HandPose")
+	FString GetCurrentPoseName() const;
+
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+private:
+
+	// Finds the closest pose to the features and checks it against its threshold, INDEX_NONE if none are close enough
+	static int32 Classify(const FHandPoseSearchData & SearchData, float DefaultThreshold, const TArray<float> & InFeatures, float & OutDistance);
+
+	void ApplyResult(int32 PoseIndex, float Distance);
+
+	// Re-used between frames so reading the bones doesn't allocate, only one task is in flight at a time so it can share the buffer
+	TSharedPtr<TArray<float>, ESPMode::ThreadSafe> Features;
+
+	FGraphEventRef ClassifyTask;
+};